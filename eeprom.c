@@ -1,974 +1,5076 @@
-/**
- * \file
- *
- * \brief SAM EEPROM Emulator
- *
- * Copyright (C) 2012-2015 Atmel Corporation. All rights reserved.
- *
- * \asf_license_start
- *
- * \page License
- *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions are met:
- *
- * 1. Redistributions of source code must retain the above copyright notice,
- *    this list of conditions and the following disclaimer.
- *
- * 2. Redistributions in binary form must reproduce the above copyright notice,
- *    this list of conditions and the following disclaimer in the documentation
- *    and/or other materials provided with the distribution.
- *
- * 3. The name of Atmel may not be used to endorse or promote products derived
- *    from this software without specific prior written permission.
- *
- * 4. This software may only be redistributed and used in connection with an
- *    Atmel microcontroller product.
- *
- * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
- * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
- * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
- * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
- * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
- * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
- * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
- * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
- * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
- * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
- * POSSIBILITY OF SUCH DAMAGE.
- *
- * \asf_license_stop
- *
- */
-/*
- * Support and FAQ: visit <a href="http://www.atmel.com/design-support/">Atmel Support</a>
- */
-#include "eeprom.h"
-#include <string.h>
-#include <nvm.h>
-#include "nvm.h"
-
-/**
- * \internal
- * Magic key is the sequence "AtEEPROMEmu." in ASCII. The key is encoded as a
- * sequence of 32-bit values to speed up checking of the key, which can be
- * implemented as a number of simple integer comparisons,
- */
-#define EEPROM_MAGIC_KEY                 {0x41744545, 0x50524f4d, 0x456d752e}
-
-/** \internal
- *  Length of the magic key, in 32-bit elements.
- */
-#define EEPROM_MAGIC_KEY_COUNT           3
-
-COMPILER_PACK_SET(1);
-/**
- * \internal
- * \brief Structure describing the EEPROM Emulation master page.
- */
-struct _eeprom_master_page {
-	/** Magic key which in ASCII will show as AtEEPROMEmu. */
-	uint32_t magic_key[EEPROM_MAGIC_KEY_COUNT];
-
-	/** Emulator major version information. */
-	uint8_t  major_version;
-	/** Emulator minor version information. */
-	uint8_t  minor_version;
-	/** Emulator revision version information. */
-	uint8_t  revision;
-
-	/** Emulator identification value (to distinguish between different emulator
-	 *  schemes that carry the same version numbers). */
-	uint8_t  emulator_id;
-
-	/** Unused reserved bytes in the master page. */
-	uint8_t  reserved[48];
-};
-
-/**
- * \internal
- * \brief Structure describing emulated pages of EEPROM data.
- */
-struct _eeprom_page {
-	/** Header information of the EEPROM page. */
-	struct {
-		uint8_t logical_page;
-		uint8_t reserved[EEPROM_HEADER_SIZE - 1];
-	} header;
-
-	/** Data content of the EEPROM page. */
-	uint8_t data[EEPROM_PAGE_SIZE];
-};
-COMPILER_PACK_RESET();
-
-/**
- * \internal
- * \brief Internal device instance struct.
- */
-struct _eeprom_module {
-	/** Initialization state of the EEPROM emulator. */
-	bool initialized;
-
-	/** Absolute byte pointer to the first byte of FLASH where the emulated
-	 *  EEPROM is stored. */
-	const struct _eeprom_page *flash;
-
-	/** Number of physical FLASH pages occupied by the EEPROM emulator. */
-	uint16_t physical_pages;
-	/** Number of logical FLASH pages occupied by the EEPROM emulator. */
-	uint8_t  logical_pages;
-
-	/** Mapping array from logical EEPROM pages to physical FLASH pages. */
-	uint8_t page_map[EEPROM_MAX_PAGES / 2 - 4];
-
-	/** Row number for the spare row (used by next write). */
-	uint8_t spare_row;
-
-	/** Buffer to hold the currently cached page. */
-	struct _eeprom_page cache;
-	/** Indicates if the cache contains valid data. */
-	bool cache_active;
-};
-
-/**
- * \internal
- * \brief Internal EEPROM emulator instance.
- */
-static struct _eeprom_module _eeprom_instance = {
-	.initialized = false,
-};
-
-
-/** \internal
- *  \brief Erases a given row within the physical EEPROM memory space.
- *
- *  \param[in] row  Physical row in EEPROM space to erase
- */
-static void _eeprom_emulator_nvm_erase_row(
-		const uint8_t row)
-{
-	enum status_code error_code = STATUS_OK;
-
-	do {
-		error_code = nvm_erase_row(
-				(uint32_t)&_eeprom_instance.flash[row * NVMCTRL_ROW_PAGES]);
-	} while (error_code == STATUS_BUSY);
-}
-
-/** \internal
- *  \brief Fills the internal NVM controller page buffer in physical EEPROM memory space.
- *
- *  \param[in] physical_page  Physical page in EEPROM space to fill
- *  \param[in] data           Data to write to the physical memory page
- */
-static void _eeprom_emulator_nvm_fill_cache(
-		const uint16_t physical_page,
-		const void* const data)
-{
-	enum status_code error_code = STATUS_OK;
-
-	do {
-		error_code = nvm_write_buffer(
-				(uint32_t)&_eeprom_instance.flash[physical_page],
-				(uint8_t*)data,
-				NVMCTRL_PAGE_SIZE);
-	} while (error_code == STATUS_BUSY);
-}
-
-/** \internal
- *  \brief Commits the internal NVM controller page buffer to physical memory.
- *
- *  \param[in] physical_page  Physical page in EEPROM space to commit
- */
-static void _eeprom_emulator_nvm_commit_cache(
-		const uint16_t physical_page)
-{
-	enum status_code error_code = STATUS_OK;
-
-	do {
-		error_code = nvm_execute_command(
-				NVM_COMMAND_WRITE_PAGE,
-				(uint32_t)&_eeprom_instance.flash[physical_page], 0);
-	} while (error_code == STATUS_BUSY);
-}
-
-/** \internal
- *  \brief Reads a page of data stored in physical EEPROM memory space.
- *
- *  \param[in]  physical_page  Physical page in EEPROM space to read
- *  \param[out] data           Destination buffer to fill with the read data
- */
-static void _eeprom_emulator_nvm_read_page(
-		const uint16_t physical_page,
-		void* const data)
-{
-	enum status_code error_code = STATUS_OK;
-
-	do {
-		error_code = nvm_read_buffer(
-				(uint32_t)&_eeprom_instance.flash[physical_page],
-				(uint8_t*)data,
-				NVMCTRL_PAGE_SIZE);
-	} while (error_code == STATUS_BUSY);
-}
-
-/**
- * \brief Initializes the emulated EEPROM memory, destroying the current contents.
- */
-static void _eeprom_emulator_format_memory(void)
-{
-	uint16_t logical_page = 0;
-
-	/* Set row 0 as the spare row */
-	_eeprom_instance.spare_row = 0;
-	_eeprom_emulator_nvm_erase_row(_eeprom_instance.spare_row);
-
-	for (uint16_t physical_page = NVMCTRL_ROW_PAGES;
-			physical_page < _eeprom_instance.physical_pages; physical_page++) {
-
-		if (physical_page == EEPROM_MASTER_PAGE_NUMBER) {
-			continue;
-		}
-
-		/* If we are at the first page in a new row, erase the entire row */
-		if ((physical_page % NVMCTRL_ROW_PAGES) == 0) {
-			_eeprom_emulator_nvm_erase_row(physical_page / NVMCTRL_ROW_PAGES);
-		}
-
-		/* Two logical pages are stored in each physical row; program in a
-		 * pair of initialized but blank set of emulated EEPROM pages */
-		if ((physical_page % NVMCTRL_ROW_PAGES) < 2) {
-			/* Make a buffer to hold the initialized EEPROM page */
-			struct _eeprom_page data;
-			memset(&data, 0xFF, sizeof(data));
-
-			/* Set up the new EEPROM row's header */
-			data.header.logical_page = logical_page;
-
-			/* Write the page out to physical memory */
-			_eeprom_emulator_nvm_fill_cache(physical_page, &data);
-			_eeprom_emulator_nvm_commit_cache(physical_page);
-
-			/* Increment the logical EEPROM page address now that the current
-			 * address' page has been initialized */
-			logical_page++;
-		}
-	}
-}
-
-/**
- * \brief Creates a map in SRAM to translate logical EEPROM pages to physical FLASH pages.
- */
-static void _eeprom_emulator_update_page_mapping(void)
-{
-	/* Scan through all physical pages, to map physical and logical pages */
-	for (uint16_t c = 0; c < _eeprom_instance.physical_pages; c++) {
-		if (c == EEPROM_MASTER_PAGE_NUMBER) {
-			continue;
-		}
-
-		/* Read in the logical page stored in the current physical page */
-		uint16_t logical_page = _eeprom_instance.flash[c].header.logical_page;
-
-		/* If the logical page number is valid, add it to the mapping */
-		if ((logical_page != EEPROM_INVALID_PAGE_NUMBER) &&
-				(logical_page < _eeprom_instance.logical_pages)) {
-			_eeprom_instance.page_map[logical_page] = c;
-		}
-	}
-
-	/* Use an invalid page number as the spare row until a valid one has been
-	 * found */
-	_eeprom_instance.spare_row = EEPROM_INVALID_ROW_NUMBER;
-
-	/* Scan through all physical rows, to find an erased row to use as the
-	 * spare */
-	for (uint16_t c = 0; c < (_eeprom_instance.physical_pages / NVMCTRL_ROW_PAGES); c++) {
-		bool spare_row_found = true;
-
-		/* Look through pages within the row to see if they are all erased */
-		for (uint8_t c2 = 0; c2 < NVMCTRL_ROW_PAGES; c2++) {
-			uint16_t physical_page = (c * NVMCTRL_ROW_PAGES) + c2;
-
-			if (physical_page == EEPROM_MASTER_PAGE_NUMBER) {
-				continue;
-			}
-
-			if (_eeprom_instance.flash[physical_page].header.logical_page !=
-					EEPROM_INVALID_PAGE_NUMBER) {
-				spare_row_found = false;
-			}
-		}
-
-		/* If we've now found the spare row, store it and abort the search */
-		if (spare_row_found == true) {
-			_eeprom_instance.spare_row = c;
-			break;
-		}
-	}
-}
-
-/**
- * \brief Finds the next free page in the given row if one is available.
- *
- * \param[in]  start_physical_page  Physical FLASH page index of the row to
- *                                  search
- * \param[out] free_physical_page   Index of the physical FLASH page that is
- *                                  currently free (if one was found)
- *
- * \return Whether a free page was found in the specified row.
- *
- * \retval \c true   If a free page was found
- * \retval \c false  If the specified row was full and needs an erase
- */
-static bool _eeprom_emulator_is_page_free_on_row(
-		const uint8_t start_physical_page,
-		uint8_t *const free_physical_page)
-{
-	/* Convert physical page number to a FLASH row and page within the row */
-	uint8_t row         = (start_physical_page / NVMCTRL_ROW_PAGES);
-	uint8_t page_in_row = (start_physical_page % NVMCTRL_ROW_PAGES);
-
-	/* Look in the current row for a page that isn't currently used */
-	for (uint8_t c = page_in_row; c < NVMCTRL_ROW_PAGES; c++) {
-		/* Calculate the page number for the current page being examined */
-		uint8_t page = (row * NVMCTRL_ROW_PAGES) + c;
-
-		/* If the page is free, pass it to the caller and exit */
-		if (_eeprom_instance.flash[page].header.logical_page ==
-				EEPROM_INVALID_PAGE_NUMBER) {
-			*free_physical_page = page;
-			return true;
-		}
-	}
-
-	/* No free page in the current row was found */
-	return false;
-}
-
-/**
- * \brief Moves data from the specified logical page to the spare row.
- *
- * Moves the contents of the specified row into the spare row, so that the
- * original row can be erased and re-used. The contents of the given logical
- * page is replaced with a new buffer of data.
- *
- * \param[in] row_number    Physical row to examine
- * \param[in] logical_page  Logical EEPROM page number in the row to update
- * \param[in] data          New data to replace the old in the logical page
- *
- * \return Status code indicating the status of the operation.
- */
-static enum status_code _eeprom_emulator_move_data_to_spare(
-		const uint8_t row_number,
-		const uint8_t logical_page,
-		const uint8_t *const data)
-{
-	enum status_code error_code = STATUS_OK;
-	struct {
-		uint8_t logical_page;
-		uint8_t physical_page;
-	} page_trans[2];
-
-	const struct _eeprom_page *row_data =
-			(struct _eeprom_page *)&_eeprom_instance.flash[row_number * NVMCTRL_ROW_PAGES];
-
-	/* There should be two logical pages of data in each row, possibly with
-	 * multiple revisions (right-most version is the newest). Start by assuming
-	 * the left-most two pages contain the newest page revisions. */
-	page_trans[0].logical_page  = row_data[0].header.logical_page;
-	page_trans[0].physical_page = (row_number * NVMCTRL_ROW_PAGES);
-
-	page_trans[1].logical_page  = row_data[1].header.logical_page;
-	page_trans[1].physical_page = (row_number * NVMCTRL_ROW_PAGES) + 1;
-
-	/* Look for newer revisions of the two logical pages stored in the row */
-	for (uint8_t c = 0; c < 2; c++) {
-		/* Look through the remaining pages in the row for any newer revisions */
-		for (uint8_t c2 = 2; c2 < NVMCTRL_ROW_PAGES; c2++) {
-			if (page_trans[c].logical_page == row_data[c2].header.logical_page) {
-				page_trans[c].physical_page =
-						(row_number * NVMCTRL_ROW_PAGES) + c2;
-			}
-		}
-	}
-
-	/* Need to move both saved logical pages stored in the same row */
-	for (uint8_t c = 0; c < 2; c++) {
-		/* Find the physical page index for the new spare row pages */
-		uint32_t new_page =
-				((_eeprom_instance.spare_row * NVMCTRL_ROW_PAGES) + c);
-
-		/* Commit any cached data to physical non-volatile memory */
-		eeprom_emulator_commit_page_buffer();
-
-		/* Check if we we are looking at the page the calling function wishes
-		 * to change during the move operation */
-		if (logical_page == page_trans[c].logical_page) {
-			/* Fill out new (updated) logical page's header in the cache */
-			_eeprom_instance.cache.header.logical_page = logical_page;
-
-			/* Write data to SRAM cache */
-			memcpy(_eeprom_instance.cache.data, data, EEPROM_PAGE_SIZE);
-		} else {
-			/* Copy existing EEPROM page to cache buffer wholesale */
-			_eeprom_emulator_nvm_read_page(
-					page_trans[c].physical_page, &_eeprom_instance.cache);
-		}
-
-		/* Fill the physical NVM buffer with the new data so that it can be
-		 * quickly committed in the future if needed due to a low power
-		 * condition */
-		_eeprom_emulator_nvm_fill_cache(new_page, &_eeprom_instance.cache);
-
-		/* Update the page map with the new page location and indicate that
-		 * the cache now holds new data */
-		_eeprom_instance.page_map[page_trans[c].logical_page] = new_page;
-		_eeprom_instance.cache_active = true;
-	}
-
-	/* Erase the row that was moved and set it as the new spare row */
-	_eeprom_emulator_nvm_erase_row(row_number);
-
-	/* Keep the index of the new spare row */
-	_eeprom_instance.spare_row = row_number;
-
-	return error_code;
-}
-
-/**
- * \brief Create master emulated EEPROM management page.
- *
- * Creates a new master page in emulated EEPROM, giving information on the
- * emulator used to store the EEPROM data.
- */
-static void _eeprom_emulator_create_master_page(void)
-{
-	const uint32_t magic_key[] = EEPROM_MAGIC_KEY;
-
-	struct _eeprom_master_page master_page;
-	memset(&master_page, 0xFF, sizeof(master_page));
-
-	/* Fill out the magic key header to indicate an initialized master page */
-	for (uint8_t c = 0; c < EEPROM_MAGIC_KEY_COUNT; c++) {
-		master_page.magic_key[c] = magic_key[c];
-	}
-
-	/* Update master header with version information of this emulator */
-	master_page.emulator_id   = EEPROM_EMULATOR_ID;
-	master_page.major_version = EEPROM_MAJOR_VERSION;
-	master_page.minor_version = EEPROM_MINOR_VERSION;
-	master_page.revision      = EEPROM_REVISION;
-
-	_eeprom_emulator_nvm_erase_row(
-			EEPROM_MASTER_PAGE_NUMBER / NVMCTRL_ROW_PAGES);
-
-	/* Write the new master page data to physical memory */
-	_eeprom_emulator_nvm_fill_cache(EEPROM_MASTER_PAGE_NUMBER, &master_page);
-	_eeprom_emulator_nvm_commit_cache(EEPROM_MASTER_PAGE_NUMBER);
-}
-
-/**
- * \brief Verify the contents of a master EEPROM page.
- *
- * Verify the contents of a master EEPROM page to ensure that it contains the
- * correct information for this version of the EEPROM emulation service.
- *
- * \retval STATUS_OK              Given master page contents is valid
- * \retval STATUS_ERR_BAD_FORMAT  Master page contents was invalid
- * \retval STATUS_ERR_IO          Master page indicates the data is incompatible
- *                                with this version of the EEPROM emulator
- */
-static enum status_code _eeprom_emulator_verify_master_page(void)
-{
-	const uint32_t magic_key[] = EEPROM_MAGIC_KEY;
-	struct _eeprom_master_page master_page;
-
-	/* Copy the master page to the RAM buffer so that it can be inspected */
-	_eeprom_emulator_nvm_read_page(EEPROM_MASTER_PAGE_NUMBER, &master_page);
-
-	/* Verify magic key is correct in the master page header */
-	for (uint8_t c = 0; c < EEPROM_MAGIC_KEY_COUNT; c++) {
-		if (master_page.magic_key[c] != magic_key[c]) {
-			return STATUS_ERR_BAD_FORMAT;
-		}
-	}
-
-	/* Verify emulator ID in header to ensure the same scheme is used */
-	if (master_page.emulator_id   != EEPROM_EMULATOR_ID) {
-		return STATUS_ERR_IO;
-	}
-
-	/* Verify major version in header to ensure the same version is used */
-	if (master_page.major_version != EEPROM_MAJOR_VERSION) {
-		return STATUS_ERR_IO;
-	}
-
-	/* Verify minor version in header to ensure the same version is used */
-	if (master_page.minor_version != EEPROM_MINOR_VERSION) {
-		return STATUS_ERR_IO;
-	}
-
-	/* Don't verify revision number - same major/minor is considered enough
-	 * to ensure the stored data is compatible. */
-
-	return STATUS_OK;
-}
-
-
-/**
- * \brief Retrieves the parameters of the EEPROM Emulator memory layout.
- *
- * Retrieves the configuration parameters of the EEPROM Emulator, after it has
- * been initialized.
- *
- * \param[out] parameters  EEPROM Emulator parameter struct to fill
- *
- * \return Status of the operation.
- *
- * \retval STATUS_OK                    If the emulator parameters were retrieved
- *                                      successfully
- * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM Emulator is not initialized
- */
-enum status_code eeprom_emulator_get_parameters(
-	struct eeprom_emulator_parameters *const parameters)
-{
-	if (_eeprom_instance.initialized == false) {
-		return STATUS_ERR_NOT_INITIALIZED;
-	}
-
-	parameters->page_size              = EEPROM_PAGE_SIZE;
-	parameters->eeprom_number_of_pages = _eeprom_instance.logical_pages;
-
-	return STATUS_OK;
-}
-
-/**
- * \brief Initializes the EEPROM Emulator service.
- *
- * Initializes the emulated EEPROM memory space; if the emulated EEPROM memory
- * has not been previously initialized, it will need to be explicitly formatted
- * via \ref eeprom_emulator_erase_memory(). The EEPROM memory space will \b not
- * be automatically erased by the initialization function, so that partial data
- * may be recovered by the user application manually if the service is unable to
- * initialize successfully.
- *
- * \return Status code indicating the status of the operation.
- *
- * \retval STATUS_OK              EEPROM emulation service was successfully
- *                                initialized
- * \retval STATUS_ERR_NO_MEMORY   No EEPROM section has been allocated in the
- *                                device
- * \retval STATUS_ERR_BAD_FORMAT  Emulated EEPROM memory is corrupt or not
- *                                formatted
- * \retval STATUS_ERR_IO          EEPROM data is incompatible with this version
- *                                or scheme of the EEPROM emulator
- */
-enum status_code eeprom_emulator_init(void)
-{
-	enum status_code error_code = STATUS_OK;
-	struct nvm_config config;
-	struct nvm_parameters parameters;
-
-	/* Retrieve the NVM controller configuration - enable manual page writing
-	 * mode so that the emulator has exclusive control over page writes to
-	 * allow for caching */
-	nvm_get_config_defaults(&config);
-	config.manual_page_write = true;
-
-	/* Apply new NVM configuration */
-	do {
-		error_code = nvm_set_config(&config);
-	} while (error_code == STATUS_BUSY);
-
-	/* Get the NVM controller configuration parameters */
-	nvm_get_parameters(&parameters);
-
-	/* Ensure the device fuses are configured for at least one master page row,
-	 * one user EEPROM data row and one spare row */
-	if (parameters.eeprom_number_of_pages < (3 * NVMCTRL_ROW_PAGES)) {
-		return STATUS_ERR_NO_MEMORY;
-	}
-
-	/* Configure the EEPROM instance physical and logical number of pages:
-	 *  - One row is reserved for the master page
-	 *  - One row is reserved for the spare row
-	 *  - Two logical pages can be stored in one physical row
-	 */
-	_eeprom_instance.physical_pages =
-			parameters.eeprom_number_of_pages;
-	_eeprom_instance.logical_pages  =
-			(parameters.eeprom_number_of_pages - (2 * NVMCTRL_ROW_PAGES)) / 2;
-
-	/* Configure the EEPROM instance starting physical address in FLASH and
-	 * pre-compute the index of the first page in FLASH used for EEPROM */
-	_eeprom_instance.flash =
-			(void*)(FLASH_SIZE -
-			((uint32_t)_eeprom_instance.physical_pages * NVMCTRL_PAGE_SIZE));
-
-	/* Clear EEPROM page write cache on initialization */
-	_eeprom_instance.cache_active = false;
-
-	/* Scan physical memory and re-create logical to physical page mapping
-	 * table to locate logical pages of EEPROM data in physical FLASH */
-	_eeprom_emulator_update_page_mapping();
-
-	/* Could not find spare row - abort as the memory appears to be corrupt */
-	if (_eeprom_instance.spare_row == EEPROM_INVALID_ROW_NUMBER) {
-		return STATUS_ERR_BAD_FORMAT;
-	}
-
-	/* Verify that the master page contains valid data for this service */
-	error_code = _eeprom_emulator_verify_master_page();
-	if (error_code != STATUS_OK) {
-		return error_code;
-	}
-
-	/* Mark initialization as complete */
-	_eeprom_instance.initialized = true;
-
-	return error_code;
-}
-
-/**
- * \brief Erases the entire emulated EEPROM memory space.
- *
- * Erases and re-initializes the emulated EEPROM memory space, destroying any
- * existing data.
- */
-void eeprom_emulator_erase_memory(void)
-{
-	/* Create new EEPROM memory block in EEPROM emulation section */
-	_eeprom_emulator_format_memory();
-
-	/* Write EEPROM emulation master block */
-	_eeprom_emulator_create_master_page();
-
-	/* Map the newly created EEPROM memory block */
-	_eeprom_emulator_update_page_mapping();
-}
-
-/**
- * \brief Writes a page of data to an emulated EEPROM memory page.
- *
- * Writes an emulated EEPROM page of data to the emulated EEPROM memory space.
- *
- * \note Data stored in pages may be cached in volatile RAM memory; to commit
- *       any cached data to physical non-volatile memory, the
- *       \ref eeprom_emulator_commit_page_buffer() function should be called.
- *
- * \param[in] logical_page  Logical EEPROM page number to write to
- * \param[in] data          Pointer to the data buffer containing source data to
- *                          write
- *
- * \return Status code indicating the status of the operation.
- *
- * \retval STATUS_OK                    If the page was successfully read
- * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
- * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
- *                                      EEPROM memory space was supplied
- */
-enum status_code eeprom_emulator_write_page(
-		const uint8_t logical_page,
-		const uint8_t *const data)
-{
-	/* Ensure the emulated EEPROM has been initialized first */
-	if (_eeprom_instance.initialized == false) {
-		return STATUS_ERR_NOT_INITIALIZED;
-	}
-
-	/* Make sure the write address is within the allowable address space */
-	if (logical_page >= _eeprom_instance.logical_pages) {
-		return STATUS_ERR_BAD_ADDRESS;
-	}
-
-	/* Check if the cache is active and the currently cached page is not the
-	 * page that is being written (if not, we need to commit and cache the new
-	 * page) */
-	if ((_eeprom_instance.cache_active == true) &&
-			(_eeprom_instance.cache.header.logical_page != logical_page)) {
-		/* Commit the currently cached data buffer to non-volatile memory */
-		eeprom_emulator_commit_page_buffer();
-	}
-
-	/* Check if we have space in the current page location's physical row for
-	 * a new version, and if so get the new page index */
-	uint8_t new_page = 0;
-	bool page_spare  = _eeprom_emulator_is_page_free_on_row(
-			_eeprom_instance.page_map[logical_page], &new_page);
-
-	/* Check if the current row is full, and we need to swap it out with a
-	 * spare row */
-	if (page_spare == false) {
-		/* Move the other page we aren't writing that is stored in the same
-		 * page to the new row, and replace the old current page with the
-		 * new page contents (cache is updated to match) */
-		_eeprom_emulator_move_data_to_spare(
-				_eeprom_instance.page_map[logical_page] / NVMCTRL_ROW_PAGES,
-				logical_page,
-				data);
-
-		/* New data is now written and the cache is updated, exit */
-		return STATUS_OK;
-	}
-
-	/* Update the page cache header section with the new page header */
-	_eeprom_instance.cache.header.logical_page = logical_page;
-
-	/* Update the page cache contents with the new data */
-	memcpy(&_eeprom_instance.cache.data,
-			data,
-			EEPROM_PAGE_SIZE);
-
-	/* Fill the physical NVM buffer with the new data so that it can be quickly
-	 * committed in the future if needed due to a low power condition */
-	_eeprom_emulator_nvm_fill_cache(new_page, &_eeprom_instance.cache);
-
-	/* Update the cache parameters and mark the cache as active */
-	_eeprom_instance.page_map[logical_page] = new_page;
-	barrier(); // Enforce ordering to prevent incorrect cache state
-	_eeprom_instance.cache_active           = true;
-
-	return STATUS_OK;
-}
-
-/**
- * \brief Reads a page of data from an emulated EEPROM memory page.
- *
- * Reads an emulated EEPROM page of data from the emulated EEPROM memory space.
- *
- * \param[in]  logical_page  Logical EEPROM page number to read from
- * \param[out] data          Pointer to the destination data buffer to fill
- *
- * \return Status code indicating the status of the operation.
- *
- * \retval STATUS_OK                    If the page was successfully read
- * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
- * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
- *                                      EEPROM memory space was supplied
- */
-enum status_code eeprom_emulator_read_page(
-		const uint8_t logical_page,
-		uint8_t *const data)
-{
-	/* Ensure the emulated EEPROM has been initialized first */
-	if (_eeprom_instance.initialized == false) {
-		return STATUS_ERR_NOT_INITIALIZED;
-	}
-
-	/* Make sure the read address is within the allowable address space */
-	if (logical_page >= _eeprom_instance.logical_pages) {
-		return STATUS_ERR_BAD_ADDRESS;
-	}
-
-	/* Check if the page to read is currently cached (and potentially out of
-	 * sync/newer than the physical memory) */
-	if ((_eeprom_instance.cache_active == true) &&
-		 (_eeprom_instance.cache.header.logical_page == logical_page)) {
-		/* Copy the potentially newer cached data into the user buffer */
-		memcpy(data, _eeprom_instance.cache.data, EEPROM_PAGE_SIZE);
-	} else {
-		struct _eeprom_page temp;
-
-		/* Copy the data from non-volatile memory into the temporary buffer */
-		_eeprom_emulator_nvm_read_page(
-				_eeprom_instance.page_map[logical_page], &temp);
-
-		/* Copy the data portion of the read page to the user's buffer */
-		memcpy(data, temp.data, EEPROM_PAGE_SIZE);
-	}
-
-	return STATUS_OK;
-}
-
-/**
- * \brief Writes a buffer of data to the emulated EEPROM memory space.
- *
- * Writes a buffer of data to a section of emulated EEPROM memory space. The
- * source buffer may be of any size, and the destination may lie outside of an
- * emulated EEPROM page boundary.
- *
- * \note Data stored in pages may be cached in volatile RAM memory; to commit
- *       any cached data to physical non-volatile memory, the
- *       \ref eeprom_emulator_commit_page_buffer() function should be called.
- *
- * \param[in] offset  Starting byte offset to write to, in emulated EEPROM
- *                    memory space
- * \param[in] data    Pointer to the data buffer containing source data to write
- * \param[in] length  Length of the data to write, in bytes
- *
- * \return Status code indicating the status of the operation.
- *
- * \retval STATUS_OK                    If the page was successfully read
- * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
- * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
- *                                      EEPROM memory space was supplied
- */
-enum status_code eeprom_emulator_write_buffer(
-		const uint16_t offset,
-		const uint8_t *const data,
-		const uint16_t length)
-{
-	enum status_code error_code = STATUS_OK;
-	uint8_t buffer[EEPROM_PAGE_SIZE];
-	uint8_t logical_page = offset / EEPROM_PAGE_SIZE;
-	uint16_t c = offset;
-	/* Keep track of whether the currently updated page has been written */
-	bool page_dirty = false;
-	/** Perform the initial page read if necessary*/
-	if ((offset % EEPROM_PAGE_SIZE) || length < EEPROM_PAGE_SIZE) {
-		error_code = eeprom_emulator_read_page(logical_page, buffer);
-
-		if (error_code != STATUS_OK) {
-			return error_code;
-		}
-	}
-
-	/* To avoid entering into the initial if in the loop the first time */
-	if ((offset % EEPROM_PAGE_SIZE) == 0) {
-		buffer[c % EEPROM_PAGE_SIZE] = data[c - offset];
-		page_dirty = true;
-		c=c+1;
-	}
-
-	/* Write the specified data to the emulated EEPROM memory space */
-	for (; c < (length + offset); c++) {
-		/* Check if we have written up to a new EEPROM page boundary */
-		if ((c % EEPROM_PAGE_SIZE) == 0) {
-			/* Write the current page to non-volatile memory from the temporary
-			 * buffer */
-			error_code = eeprom_emulator_write_page(logical_page, buffer);
-			page_dirty = false;
-
-			if (error_code != STATUS_OK) {
-				break;
-			}
-
-			/* Increment the page number we are looking at */
-			logical_page++;
-
-			/* Read the next page from non-volatile memory into the temporary
-			 * buffer in case of a partial page write */
-			error_code = eeprom_emulator_read_page(logical_page, buffer);
-
-			if (error_code != STATUS_OK) {
-				return error_code;
-			}
-		}
-		/* Copy the next byte of data from the user's buffer to the temporary
-		 * buffer */
-		buffer[c % EEPROM_PAGE_SIZE] = data[c - offset];
-		page_dirty = true;
-	}
-
-	/* If the current page is dirty, write it */
-	if (page_dirty) {
-		error_code = eeprom_emulator_write_page(logical_page, buffer);
-	}
-
-	return error_code;
-}
-
-/**
- * \brief Reads a buffer of data from the emulated EEPROM memory space.
- *
- * Reads a buffer of data from a section of emulated EEPROM memory space. The
- * destination buffer may be of any size, and the source may lie outside of an
- * emulated EEPROM page boundary.
- *
- * \param[in]  offset  Starting byte offset to read from, in emulated EEPROM
- *                     memory space
- * \param[out] data    Pointer to the data buffer containing source data to read
- * \param[in]  length  Length of the data to read, in bytes
- *
- * \return Status code indicating the status of the operation.
- *
- * \retval STATUS_OK                    If the page was successfully read
- * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
- * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
- *                                      EEPROM memory space was supplied
- */
-enum status_code eeprom_emulator_read_buffer(
-		const uint16_t offset,
-		uint8_t *const data,
-		const uint16_t length)
-{
-	enum status_code error_code;
-	uint8_t buffer[EEPROM_PAGE_SIZE];
-	uint8_t logical_page = offset / EEPROM_PAGE_SIZE;
-	uint16_t c = offset;
-
-	/** Perform the initial page read  */
-	error_code = eeprom_emulator_read_page(logical_page, buffer);
-	if (error_code != STATUS_OK) {
-		return error_code;
-	}
-
-	/* To avoid entering into the initial if in the loop the first time */
-	if ((offset % EEPROM_PAGE_SIZE) == 0) {
-		data[0] = buffer[0];
-		c=c+1;
-	}
-
-	/* Read in the specified data from the emulated EEPROM memory space */
-	for (; c < (length + offset); c++) {
-		/* Check if we have read up to a new EEPROM page boundary */
-		if ((c % EEPROM_PAGE_SIZE) == 0) {
-			/* Increment the page number we are looking at */
-			logical_page++;
-
-			/* Read the next page from non-volatile memory into the temporary
-			 * buffer */
-			error_code = eeprom_emulator_read_page(logical_page, buffer);
-
-			if (error_code != STATUS_OK) {
-				return error_code;
-			}
-		}
-
-		/* Copy the next byte of data from the temporary buffer to the user's
-		 * buffer */
-		data[c - offset] = buffer[c % EEPROM_PAGE_SIZE];
-	}
-
-	return error_code;
-}
-
-/**
- * \brief Commits any cached data to physical non-volatile memory.
- *
- * Commits the internal SRAM caches to physical non-volatile memory, to ensure
- * that any outstanding cached data is preserved. This function should be called
- * prior to a system reset or shutdown to prevent data loss.
- *
- * \note This should be the first function executed in a BOD33 Early Warning
- *       callback to ensure that any outstanding cache data is fully written to
- *       prevent data loss.
- *
- *
- * \note This function should also be called before using the NVM controller
- *       directly in the user-application for any other purposes to prevent
- *       data loss.
- *
- * \return Status code indicating the status of the operation.
- */
-enum status_code eeprom_emulator_commit_page_buffer(void)
-{
-	enum status_code error_code = STATUS_OK;
-
-	/* If cache is inactive, no need to commit anything to physical memory */
-	if (_eeprom_instance.cache_active == false) {
-		return STATUS_OK;
-	}
-
-	uint8_t cached_logical_page = _eeprom_instance.cache.header.logical_page;
-
-	/* Perform the page write to commit the NVM page buffer to FLASH */
-	_eeprom_emulator_nvm_commit_cache(
-			_eeprom_instance.page_map[cached_logical_page]);
-
-	barrier(); // Enforce ordering to prevent incorrect cache state
-	_eeprom_instance.cache_active = false;
-
-	return error_code;
-}
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator
+ *
+ * Copyright (C) 2012-2015 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+/*
+ * Support and FAQ: visit <a href="http://www.atmel.com/design-support/">Atmel Support</a>
+ */
+#include "eeprom.h"
+#include <string.h>
+#include <stddef.h>
+#if !defined(EEPROM_EMULATOR_HOST_NVM)
+#  include "nvm.h"
+#endif
+
+#if !defined(EEPROM_NVM_POINTER)
+/** \internal
+ *  Translates an NVM address into a pointer to the memory-mapped FLASH.
+ */
+#  define EEPROM_NVM_POINTER(address)            ((const void *)(address))
+#endif
+
+#if !defined(EEPROM_NVM_TRACE_READ)
+/** \internal
+ *  Hook called on direct memory-mapped reads of the FLASH, which the NVM
+ *  backend may use to account them.
+ */
+#  define EEPROM_NVM_TRACE_READ(address, length)
+#endif
+
+/**
+ * \internal
+ * Magic key is the sequence "AtEEPROMEmu." in ASCII. The key is encoded as a
+ * sequence of 32-bit values to speed up checking of the key, which can be
+ * implemented as a number of simple integer comparisons,
+ */
+#define EEPROM_MAGIC_KEY                 {0x41744545, 0x50524f4d, 0x456d752e}
+
+/** \internal
+ *  Length of the magic key, in 32-bit elements.
+ */
+#define EEPROM_MAGIC_KEY_COUNT           3
+
+/** \internal
+ *  Master page layout flag (active-low), set when a metadata row is reserved.
+ */
+#define EEPROM_LAYOUT_METADATA_ROW       (1 << 0)
+
+/** \internal
+ *  Master page layout flag (active-low), set when delta records are in use.
+ */
+#define EEPROM_LAYOUT_DELTA_RECORDS      (1 << 1)
+
+/** \internal
+ *  Page header flag (active-low), set when the page holds delta records of a
+ *  logical page instead of its full contents.
+ */
+#define EEPROM_PAGE_FLAG_DELTA           (1 << 0)
+
+/** \internal
+ *  Master page layout flag (active-low), set when transactions are in use.
+ */
+#define EEPROM_LAYOUT_TRANSACTIONS       (1 << 2)
+
+/** \internal
+ *  Master page layout flag (active-low), set when pages carry a CRC.
+ */
+#define EEPROM_LAYOUT_PAGE_CRC           (1 << 3)
+
+/** \internal
+ *  Master page layout flag (active-low), set when page numbers are 16-bit.
+ */
+#define EEPROM_LAYOUT_WIDE_PAGE_INDEX    (1 << 4)
+
+/** \internal
+ *  Page header flag (active-low), set when the page was written by a
+ *  transaction and is only valid once the transaction is published.
+ */
+#define EEPROM_PAGE_FLAG_STAGED          (1 << 1)
+
+/** \internal
+ *  Page header flag (active-low), set on the last page written by a
+ *  transaction to record that the transaction was committed.
+ */
+#define EEPROM_PAGE_FLAG_COMMIT          (1 << 2)
+
+/** \internal
+ *  Page header flag (active-low), set when the transaction that wrote the
+ *  page has been published.
+ */
+#define EEPROM_PAGE_FLAG_PUBLISHED       (1 << 3)
+
+/** \internal
+ *  Page header flag (active-low), set when the page was written by a
+ *  transaction that was never committed.
+ */
+#define EEPROM_PAGE_FLAG_DISCARDED       (1 << 4)
+
+/** \internal
+ *  Size of the header of a delta record (offset and length, followed by the
+ *  CRC of the record when page CRCs are enabled), in bytes.
+ */
+#define EEPROM_DELTA_HEADER_SIZE         ((EEPROM_PAGE_CRC == true) ? 4 : 2)
+
+/** \internal
+ *  Largest delta record that is started on a new page instead of writing a
+ *  full page revision, in bytes.
+ */
+#define EEPROM_DELTA_MAX_RECORD_SIZE     (EEPROM_PAGE_SIZE / 2)
+
+/** \internal
+ *  Row erase count stored in page headers when wear leveling is disabled, or
+ *  when the count is not known.
+ */
+#define EEPROM_UNKNOWN_ERASE_COUNT       0xFFFF
+
+#if (EEPROM_PHYSICAL_PAGES > 0)
+/** \internal
+ *  Number of physical rows holding EEPROM data, including the spare rows, for
+ *  a fixed number of physical pages.
+ */
+#  define EEPROM_DATA_ROWS               ((EEPROM_PHYSICAL_PAGES / NVMCTRL_ROW_PAGES) - \
+		1 - (EEPROM_METADATA_ROW == true))
+
+/** \internal
+ *  Number of logical EEPROM pages, for a fixed number of physical pages.
+ */
+#  define EEPROM_LOGICAL_PAGES           ((EEPROM_DATA_ROWS - EEPROM_SPARE_ROWS) * 2)
+
+/** \internal
+ *  Size of the page map and row fill tables.
+ */
+#  define EEPROM_MAX_LOGICAL_PAGES       EEPROM_LOGICAL_PAGES
+#  define EEPROM_MAX_ROWS                (EEPROM_PHYSICAL_PAGES / NVMCTRL_ROW_PAGES)
+#else
+#  define EEPROM_MAX_LOGICAL_PAGES       (EEPROM_MAX_PAGES / 2 - 4)
+#  define EEPROM_MAX_ROWS                (EEPROM_MAX_PAGES / NVMCTRL_ROW_PAGES)
+#endif
+
+#if (EEPROM_METADATA_ROW == true)
+/** \internal
+ *  Physical page number of the first page of the metadata row.
+ */
+#  define EEPROM_METADATA_PAGE_NUMBER    \
+		((uint16_t)_eeprom_emulator_data_rows() * NVMCTRL_ROW_PAGES)
+
+/** \internal
+ *  Marker at the start of a checkpoint record, "CK" in ASCII.
+ */
+#  define EEPROM_CHECKPOINT_MAGIC        0x4B43
+
+/** \internal
+ *  Maximum size of a checkpoint record, in bytes.
+ */
+#  define EEPROM_CHECKPOINT_MAX_SIZE     (3 * NVMCTRL_PAGE_SIZE)
+#endif
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+/** \internal
+ *  Physical page numbers of the format migration journal, the new master page
+ *  and the progress bits, kept in the master row pages before the master page.
+ */
+#  define EEPROM_MIGRATION_JOURNAL_PAGE_NUMBER   (EEPROM_MASTER_PAGE_NUMBER - 3)
+#  define EEPROM_MIGRATION_PROGRESS_PAGE_NUMBER  (EEPROM_MASTER_PAGE_NUMBER - 2)
+#  define EEPROM_MIGRATION_MASTER_PAGE_NUMBER    (EEPROM_MASTER_PAGE_NUMBER - 1)
+
+/** \internal
+ *  Migration state flag, cleared once the journal is complete and rows may be
+ *  rewritten.
+ */
+#  define EEPROM_MIGRATION_STATE_STARTED         (1 << 0)
+
+/** \internal
+ *  Migration state flag, cleared once the new master page is complete and
+ *  replaces the old one.
+ */
+#  define EEPROM_MIGRATION_STATE_DONE            (1 << 1)
+
+/** \internal
+ *  Offset of the master page contents in the copy kept in a data row while
+ *  the master row is erased, leaving an erased page header in front.
+ */
+#  define EEPROM_MASTER_COPY_OFFSET              4
+#endif
+
+#if (EEPROM_WIDE_PAGE_INDEX == true)
+/** \internal
+ *  Logical or physical page number, as stored in page headers and the page map.
+ */
+typedef uint16_t _eeprom_page_number_t;
+#else
+typedef uint8_t _eeprom_page_number_t;
+#endif
+
+COMPILER_PACK_SET(1);
+/**
+ * \internal
+ * \brief Structure describing the EEPROM Emulation master page.
+ */
+struct _eeprom_master_page {
+	/** Magic key which in ASCII will show as AtEEPROMEmu. */
+	uint32_t magic_key[EEPROM_MAGIC_KEY_COUNT];
+
+	/** Emulator major version information. */
+	uint8_t  major_version;
+	/** Emulator minor version information. */
+	uint8_t  minor_version;
+	/** Emulator revision version information. */
+	uint8_t  revision;
+
+	/** Emulator identification value (to distinguish between different emulator
+	 *  schemes that carry the same version numbers). */
+	uint8_t  emulator_id;
+
+	/** Physical layout options of the emulated EEPROM, as active-low
+	 *  \c EEPROM_LAYOUT_* flags. */
+	uint8_t  layout;
+
+	/** Number of spare rows, or 0xFF for a single spare row. */
+	uint8_t  spare_rows;
+
+	/** Unused reserved bytes in the master page. */
+	uint8_t  reserved[46];
+};
+
+/**
+ * \internal
+ * \brief Structure describing emulated pages of EEPROM data.
+ */
+struct _eeprom_page {
+	/** Header information of the EEPROM page. */
+	struct {
+		_eeprom_page_number_t logical_page;
+		/** Page flags, as active-low \c EEPROM_PAGE_FLAG_* values. */
+		uint8_t flags;
+#if (EEPROM_WIDE_PAGE_INDEX == true)
+		/** Unused reserved byte, keeping the following fields aligned. */
+		uint8_t reserved;
+#endif
+		/** Number of erases of the row holding the page when the page was
+		 *  written, or \ref EEPROM_UNKNOWN_ERASE_COUNT. */
+		uint16_t row_erases;
+#if (EEPROM_PAGE_CRC == true)
+		/** Revision number of the logical page, incremented at every write. */
+		uint16_t sequence;
+		/** CRC-16 of the page, see \ref _eeprom_emulator_page_crc(). */
+		uint16_t crc;
+#endif
+	} header;
+
+	/** Data content of the EEPROM page. */
+	uint8_t data[EEPROM_PAGE_SIZE];
+};
+
+#if (EEPROM_METADATA_ROW == true)
+/**
+ * \internal
+ * \brief Structure describing the header of a checkpoint record.
+ *
+ * A checkpoint record starts on a page boundary of the metadata row, and is
+ * followed by the page map (one byte per logical page) and the row fill
+ * levels (one nibble per data row).
+ */
+struct _eeprom_checkpoint {
+	/** Checkpoint record marker, \ref EEPROM_CHECKPOINT_MAGIC. */
+	uint16_t magic;
+	/** Fletcher-16 checksum of the record contents following this field. */
+	uint16_t checksum;
+	/** Generation number, incremented for each checkpoint written. */
+	uint32_t generation;
+	/** Number of logical pages in the page map. */
+	uint8_t  logical_pages;
+	/** Number of data rows in the row fill table. */
+	uint8_t  data_rows;
+	/** Spare row at the time of the checkpoint. */
+	uint8_t  spare_row;
+	/** Unused reserved byte. */
+	uint8_t  reserved;
+};
+#endif
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+/**
+ * \internal
+ * \brief Structure describing the format migration journal page.
+ *
+ * Each field is programmed once from its erased value, so that a torn write
+ * of the page is completed by writing the same contents again.
+ */
+struct _eeprom_migration_journal {
+	/** Rows holding no current logical page when the migration started, as
+	 *  one active-low bit for each of up to 256 rows. */
+	uint8_t  free_rows[32];
+	/** Layout flags of the new master page. */
+	uint8_t  layout;
+	/** Spare row count of the new master page. */
+	uint8_t  spare_rows;
+	/** Migration state, as active-low \c EEPROM_MIGRATION_STATE_* flags. */
+	uint8_t  state;
+	/** Unused reserved bytes in the journal page. */
+	uint8_t  reserved[29];
+};
+#endif
+COMPILER_PACK_RESET();
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+/**
+ * \internal
+ * \brief Structure describing the physical layout of memory being migrated.
+ */
+struct _eeprom_migration_layout {
+	/** Size of the logical page number in page headers, in bytes. */
+	uint8_t  number_size;
+	/** Offset of the row erase count in page headers. */
+	uint8_t  erases_offset;
+	/** Size of page headers, in bytes. */
+	uint8_t  header_size;
+	/** Indicates if page headers hold a sequence number and a CRC. */
+	bool     crc;
+	/** Indicates if pages may hold delta records. */
+	bool     delta;
+	/** Indicates if pages may belong to transactions. */
+	bool     transactions;
+	/** Number of physical rows holding EEPROM data, including the spares. */
+	uint8_t  data_rows;
+	/** Number of logical pages. */
+	uint16_t logical_pages;
+};
+
+/**
+ * \internal
+ * \brief Structure describing a page header decoded from memory being
+ *        migrated.
+ */
+struct _eeprom_migration_header {
+	/** Logical page number. */
+	uint16_t logical_page;
+	/** Page flags, as active-low \c EEPROM_PAGE_FLAG_* values. */
+	uint8_t  flags;
+	/** Revision number of the logical page, if page CRCs are used. */
+	uint16_t sequence;
+};
+
+/**
+ * \internal
+ * \brief Structure describing a format migration.
+ */
+struct _eeprom_migration_plan {
+	/** Layout of the memory being migrated. */
+	struct _eeprom_migration_layout layout;
+	/** Contents of the migration journal. */
+	struct _eeprom_migration_journal journal;
+	/** Number of logical pages carried over to the new layout. */
+	uint16_t kept_pages;
+	/** Number of rows holding current logical pages in the old layout. */
+	uint8_t  source_rows;
+	/** Number of rows written by the migration. */
+	uint8_t  steps;
+};
+#endif
+
+/**
+ * \internal
+ * \brief Structure describing an entry of the page write cache.
+ */
+struct _eeprom_cache_entry {
+	/** Buffered contents of the logical page, including its header. */
+	struct _eeprom_page page;
+	/** Value of the cache clock when the entry was last written. */
+	uint32_t last_use;
+	/** Indicates if the entry holds data not yet written to physical memory. */
+	bool active;
+};
+
+#if (EEPROM_READ_CACHE_ENTRIES > 0)
+/**
+ * \internal
+ * \brief Structure describing an entry of the page read cache.
+ */
+struct _eeprom_read_cache_entry {
+	/** Contents of the logical page, as stored in physical memory. */
+	uint8_t data[EEPROM_PAGE_SIZE];
+	/** Value of the cache clock when the entry was last read. */
+	uint32_t last_use;
+	/** Logical page held, or \ref EEPROM_INVALID_PAGE_NUMBER if the entry is
+	 *  free. */
+	uint16_t logical_page;
+};
+#endif
+
+/**
+ * \internal
+ * \brief Internal device instance struct.
+ */
+struct _eeprom_module {
+	/** Initialization state of the EEPROM emulator. */
+	bool initialized;
+
+	/** Absolute byte address of the first byte of FLASH where the emulated
+	 *  EEPROM is stored. */
+	uint32_t flash_address;
+	/** Pointer to the first byte of FLASH where the emulated EEPROM is
+	 *  stored. */
+	const struct _eeprom_page *flash;
+
+#if (EEPROM_PHYSICAL_PAGES == 0)
+	/** Number of physical FLASH pages occupied by the EEPROM emulator. */
+	uint16_t physical_pages;
+	/** Number of logical FLASH pages occupied by the EEPROM emulator. */
+	_eeprom_page_number_t logical_pages;
+	/** Number of physical rows holding EEPROM data, including the spare. */
+	uint8_t  data_rows;
+#endif
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+	/** Erased data rows whose erase count is not yet stored in any page
+	 *  header, one per spare row pool entry, or
+	 *  \ref EEPROM_INVALID_ROW_NUMBER. */
+	uint8_t erased_rows[EEPROM_SPARE_ROWS];
+	/** Number of erases of each row of \c erased_rows. */
+	uint16_t erased_row_erases[EEPROM_SPARE_ROWS];
+#endif
+
+	/** Mapping array from logical EEPROM pages to physical FLASH pages. */
+	_eeprom_page_number_t page_map[EEPROM_MAX_LOGICAL_PAGES];
+
+	/** Row number for the spare row (used by next write). */
+	uint8_t spare_row;
+	/** Rows of the spare row pool, in the order they joined it; rows with a
+	 *  non-zero fill level are waiting to be erased. */
+	uint8_t spare_rows[EEPROM_SPARE_ROWS];
+
+	/** Number of used pages in each physical row, which is also the index of
+	 *  the next free page in the row as rows are always filled in order. */
+	uint8_t row_fill[EEPROM_MAX_ROWS];
+
+	/** Write-back cache of logical pages not yet written to physical memory. */
+	struct _eeprom_cache_entry cache[EEPROM_CACHE_ENTRIES];
+#if (EEPROM_READ_CACHE_ENTRIES > 0)
+	/** Read cache of logical pages recently read from physical memory. */
+	struct _eeprom_read_cache_entry read_cache[EEPROM_READ_CACHE_ENTRIES];
+#endif
+	/** Counter changed whenever the contents or location of a logical page
+	 *  may change, invalidating page views. */
+	uint32_t view_generation;
+	/** Counter used to order cache entries by their last use. */
+	uint32_t cache_clock;
+
+	/** Row being moved to the spare row, or an invalid row number if no row
+	 *  move is in progress. */
+	uint8_t move_row;
+	/** Next step of the row move in progress. */
+	uint8_t move_step;
+	/** Logical page replaced with new data by the row move in progress. */
+	uint16_t move_logical_page;
+	/** New data of the logical page replaced by the row move in progress. */
+	const uint8_t *move_data;
+	/** Cache entry released once the row move in progress completes. */
+	struct _eeprom_cache_entry *move_entry;
+
+	/** Usage statistics of the emulator since initialization. */
+	struct eeprom_emulator_statistics statistics;
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/** Indicates if a transaction is being staged. */
+	bool transaction_active;
+	/** Number of logical pages staged in the current transaction. */
+	uint8_t transaction_pages;
+	/** New contents of the logical pages staged in the current transaction. */
+	struct _eeprom_page transaction[EEPROM_TRANSACTION_PAGES];
+
+	/** Physical pages of an unfinished transaction found at initialization. */
+	uint8_t recovery_pages[EEPROM_TRANSACTION_PAGES];
+	/** Number of pages of an unfinished transaction found at initialization. */
+	uint8_t recovery_count;
+	/** Indicates if the unfinished transaction had been committed. */
+	bool recovery_committed;
+#endif
+
+#if (EEPROM_METADATA_ROW == true)
+	/** Generation number of the newest checkpoint. */
+	uint32_t checkpoint_generation;
+	/** Spare row recorded in the newest checkpoint, or an invalid row number
+	 *  if no checkpoint can be trusted. */
+	uint8_t checkpoint_spare_row;
+	/** First free page in the metadata row. */
+	uint8_t checkpoint_free_page;
+#endif
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+	/** Indicates if initialization found memory with a different layout,
+	 *  which \ref eeprom_emulator_migrate() may rewrite. */
+	bool migration_pending;
+#endif
+};
+
+/**
+ * \internal
+ * \brief Internal EEPROM emulator instance.
+ */
+static struct _eeprom_module _eeprom_instance = {
+	.initialized = false,
+};
+
+/** \internal
+ *  \brief Gets the number of physical FLASH pages used by the emulator.
+ *
+ *  \return Number of physical pages, a constant if \ref EEPROM_PHYSICAL_PAGES
+ *          is set.
+ */
+static inline uint16_t _eeprom_emulator_physical_pages(void)
+{
+#if (EEPROM_PHYSICAL_PAGES > 0)
+	return EEPROM_PHYSICAL_PAGES;
+#else
+	return _eeprom_instance.physical_pages;
+#endif
+}
+
+/** \internal
+ *  \brief Gets the number of physical rows holding EEPROM data.
+ *
+ *  \return Number of data rows, including the spare rows, a constant if
+ *          \ref EEPROM_PHYSICAL_PAGES is set.
+ */
+static inline uint8_t _eeprom_emulator_data_rows(void)
+{
+#if (EEPROM_PHYSICAL_PAGES > 0)
+	return EEPROM_DATA_ROWS;
+#else
+	return _eeprom_instance.data_rows;
+#endif
+}
+
+/** \internal
+ *  \brief Gets the number of logical EEPROM pages.
+ *
+ *  \return Number of logical pages, a constant if \ref EEPROM_PHYSICAL_PAGES
+ *          is set.
+ */
+static inline uint16_t _eeprom_emulator_logical_pages(void)
+{
+#if (EEPROM_PHYSICAL_PAGES > 0)
+	return EEPROM_LOGICAL_PAGES;
+#else
+	return _eeprom_instance.logical_pages;
+#endif
+}
+
+/** \internal
+ *  \brief Computes the NVM address of a page within the EEPROM memory space.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space
+ *
+ *  \return Absolute NVM byte address of the first byte of the page.
+ */
+static inline uint32_t _eeprom_emulator_page_address(
+		const uint16_t physical_page)
+{
+	return _eeprom_instance.flash_address +
+			((uint32_t)physical_page * NVMCTRL_PAGE_SIZE);
+}
+
+/** \internal
+ *  \brief Reads the logical page number from a physical page header in FLASH.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space to examine
+ *
+ *  \return Logical page number stored in the header of the physical page.
+ */
+static inline uint16_t _eeprom_emulator_page_header(
+		const uint16_t physical_page)
+{
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page),
+			sizeof(_eeprom_instance.flash[0].header.logical_page));
+
+	return _eeprom_instance.flash[physical_page].header.logical_page;
+}
+
+/** \internal
+ *  \brief Reads the page flags from a physical page header in FLASH.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space to examine
+ *
+ *  \return Active-low \c EEPROM_PAGE_FLAG_* flags stored in the header of the
+ *          physical page.
+ */
+static inline uint8_t _eeprom_emulator_page_flags(
+		const uint16_t physical_page)
+{
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page) +
+			offsetof(struct _eeprom_page, header.flags),
+			sizeof(_eeprom_instance.flash[0].header.flags));
+
+	return _eeprom_instance.flash[physical_page].header.flags;
+}
+
+
+#if (EEPROM_PAGE_CRC == true)
+/** \internal
+ *  \brief Computes the CRC of an emulated EEPROM page.
+ *
+ *  The CRC covers the page header except for the page flags, which may be
+ *  programmed again after the page is written, and the page contents unless
+ *  the page holds delta records, which are appended over time.
+ *
+ *  \param[in] page  Page to compute the CRC of
+ *
+ *  \return CRC of the page.
+ */
+static uint16_t _eeprom_emulator_page_crc(
+		const struct _eeprom_page *const page)
+{
+	uint16_t crc = 0xFFFF;
+
+	crc = eeprom_emulator_crc16(crc, (const uint8_t *)&page->header.logical_page,
+			sizeof(page->header.logical_page));
+	crc = eeprom_emulator_crc16(crc, (const uint8_t *)&page->header.row_erases,
+			sizeof(page->header.row_erases));
+	crc = eeprom_emulator_crc16(crc, (const uint8_t *)&page->header.sequence,
+			sizeof(page->header.sequence));
+
+	if (page->header.flags & EEPROM_PAGE_FLAG_DELTA) {
+		crc = eeprom_emulator_crc16(crc, page->data, EEPROM_PAGE_SIZE);
+	}
+
+	return crc;
+}
+
+/** \internal
+ *  \brief Checks if a physical page was completely written.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space to examine
+ *
+ *  \return Whether the CRC stored in the page header matches its contents.
+ */
+static bool _eeprom_emulator_page_is_intact(
+		const uint16_t physical_page)
+{
+	const struct _eeprom_page *page = &_eeprom_instance.flash[physical_page];
+
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page),
+			NVMCTRL_PAGE_SIZE);
+
+	return (page->header.crc == _eeprom_emulator_page_crc(page));
+}
+
+/** \internal
+ *  \brief Reads the sequence number from a physical page header in FLASH.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space to examine
+ *
+ *  \return Revision number of the logical page stored in the physical page.
+ */
+static inline uint16_t _eeprom_emulator_page_sequence(
+		const uint16_t physical_page)
+{
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page) +
+			offsetof(struct _eeprom_page, header.sequence),
+			sizeof(_eeprom_instance.flash[0].header.sequence));
+
+	return _eeprom_instance.flash[physical_page].header.sequence;
+}
+#else
+/* Without page CRCs, every page is considered completely written */
+#  define _eeprom_emulator_page_is_intact(physical_page) true
+#endif
+
+/** \internal
+ *  \brief Checks if a physical page holds a newer revision of its logical page
+ *         than the one currently mapped.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space to examine
+ *  \param[in] logical_page   Logical EEPROM page stored in the physical page
+ *
+ *  \return Whether the logical page should be mapped to the physical page.
+ */
+static inline bool _eeprom_emulator_page_is_newer(
+		const uint16_t physical_page,
+		const uint16_t logical_page)
+{
+#if (EEPROM_PAGE_CRC == true)
+	uint16_t mapped = _eeprom_instance.page_map[logical_page];
+
+	/* Sequence numbers wrap around, and only ever differ by a few revisions
+	 * between the copies of a logical page */
+	return ((mapped == EEPROM_INVALID_PAGE_NUMBER) ||
+			((int16_t)(_eeprom_emulator_page_sequence(physical_page) -
+				_eeprom_emulator_page_sequence(mapped)) > 0));
+#else
+	/* Without sequence numbers, pages are scanned from oldest to newest */
+	(void)physical_page;
+	(void)logical_page;
+	return true;
+#endif
+}
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+/** \internal
+ *  \brief Finds the entry holding the erase count of an erased data row.
+ *
+ *  \param[in] row  Physical data row in EEPROM space to look up
+ *
+ *  \return Index of the entry of the row, or \ref EEPROM_SPARE_ROWS if it has
+ *          none.
+ */
+static uint8_t _eeprom_emulator_erased_row_entry(
+		const uint8_t row)
+{
+	for (uint8_t c = 0; c < EEPROM_SPARE_ROWS; c++) {
+		if (_eeprom_instance.erased_rows[c] == row) {
+			return c;
+		}
+	}
+
+	return EEPROM_SPARE_ROWS;
+}
+
+/** \internal
+ *  \brief Keeps the erase count of an erased data row until it is stored.
+ *
+ *  Uses the entry of the row if it has one, or else an entry whose row has
+ *  since been written to, and thus holds its erase count in a page header.
+ *
+ *  \param[in] row     Physical data row in EEPROM space
+ *  \param[in] erases  Number of erases of the row
+ */
+static void _eeprom_emulator_set_row_erases(
+		const uint8_t row,
+		const uint16_t erases)
+{
+	uint8_t entry = _eeprom_emulator_erased_row_entry(row);
+
+	for (uint8_t c = 0; (c < EEPROM_SPARE_ROWS) &&
+			(entry == EEPROM_SPARE_ROWS); c++) {
+		uint8_t erased_row = _eeprom_instance.erased_rows[c];
+
+		if ((erased_row == EEPROM_INVALID_ROW_NUMBER) ||
+				(_eeprom_instance.row_fill[erased_row] != 0)) {
+			entry = c;
+		}
+	}
+
+	/* More rows than the pool are only erased at once when formatting, where
+	 * the erase counts are lost anyway */
+	if (entry == EEPROM_SPARE_ROWS) {
+		entry = 0;
+	}
+
+	_eeprom_instance.erased_rows[entry]       = row;
+	_eeprom_instance.erased_row_erases[entry] = erases;
+}
+
+/** \internal
+ *  \brief Retrieves the number of times a data row has been erased.
+ *
+ *  \param[in] row  Physical data row in EEPROM space to examine
+ *
+ *  \return Erase count of the row, as stored in the header of its first page,
+ *          or zero if it is not known.
+ */
+static uint16_t _eeprom_emulator_row_erases(
+		const uint8_t row)
+{
+	uint16_t physical_page = row * NVMCTRL_ROW_PAGES;
+	uint8_t entry = _eeprom_emulator_erased_row_entry(row);
+	uint16_t erases;
+
+	if (entry < EEPROM_SPARE_ROWS) {
+		return _eeprom_instance.erased_row_erases[entry];
+	}
+
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page) +
+			offsetof(struct _eeprom_page, header.row_erases),
+			sizeof(_eeprom_instance.flash[0].header.row_erases));
+
+	erases = _eeprom_instance.flash[physical_page].header.row_erases;
+
+	return (erases == EEPROM_UNKNOWN_ERASE_COUNT) ? 0 : erases;
+}
+#endif
+
+/** \internal
+ *  \brief Erases a given row within the physical EEPROM memory space.
+ *
+ *  \param[in] row  Physical row in EEPROM space to erase
+ */
+static void _eeprom_emulator_nvm_erase_row(
+		const uint8_t row)
+{
+	enum status_code error_code = STATUS_OK;
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+	/* Keep the new erase count of a data row until it is written out in the
+	 * header of the first page stored in the row */
+	if (row < _eeprom_emulator_data_rows()) {
+		uint16_t erases = _eeprom_emulator_row_erases(row);
+
+		_eeprom_emulator_set_row_erases(row,
+				(erases < (EEPROM_UNKNOWN_ERASE_COUNT - 1)) ? (erases + 1) : erases);
+	}
+#endif
+
+	do {
+		error_code = nvm_erase_row(
+				_eeprom_emulator_page_address(row * NVMCTRL_ROW_PAGES));
+	} while (error_code == STATUS_BUSY);
+
+	/* All pages in the row are now free */
+	_eeprom_instance.row_fill[row] = 0;
+	_eeprom_instance.view_generation++;
+}
+
+/** \internal
+ *  \brief Fills the internal NVM controller page buffer in physical EEPROM memory space.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space to fill
+ *  \param[in] data           Data to write to the physical memory page
+ */
+static void _eeprom_emulator_nvm_fill_cache(
+		const uint16_t physical_page,
+		const void* const data)
+{
+	enum status_code error_code = STATUS_OK;
+
+	do {
+		error_code = nvm_write_buffer(
+				_eeprom_emulator_page_address(physical_page),
+				(uint8_t*)data,
+				NVMCTRL_PAGE_SIZE);
+	} while (error_code == STATUS_BUSY);
+
+	/* The page is now reserved for the buffered data, so the next free page
+	 * in the row is the one following it */
+	uint8_t row         = (physical_page / NVMCTRL_ROW_PAGES);
+	uint8_t page_in_row = (physical_page % NVMCTRL_ROW_PAGES);
+
+	if (_eeprom_instance.row_fill[row] <= page_in_row) {
+		_eeprom_instance.row_fill[row] = page_in_row + 1;
+	}
+}
+
+/** \internal
+ *  \brief Commits the internal NVM controller page buffer to physical memory.
+ *
+ *  \param[in] physical_page  Physical page in EEPROM space to commit
+ */
+static void _eeprom_emulator_nvm_commit_cache(
+		const uint16_t physical_page)
+{
+	enum status_code error_code = STATUS_OK;
+
+	do {
+		error_code = nvm_execute_command(
+				NVM_COMMAND_WRITE_PAGE,
+				_eeprom_emulator_page_address(physical_page), 0);
+	} while (error_code == STATUS_BUSY);
+}
+
+/** \internal
+ *  \brief Writes an emulated EEPROM page to physical EEPROM memory space.
+ *
+ *  Records the erase count of the destination row in the page header, when
+ *  wear leveling is enabled, and the sequence number and CRC of the page, when
+ *  page CRCs are enabled, and programs the page.
+ *
+ *  \param[in]     physical_page  Physical page in EEPROM space to write
+ *  \param[in,out] page           Page header and contents to write
+ */
+static void _eeprom_emulator_nvm_write_page(
+		const uint16_t physical_page,
+		struct _eeprom_page *const page)
+{
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+	page->header.row_erases =
+			_eeprom_emulator_row_erases(physical_page / NVMCTRL_ROW_PAGES);
+#endif
+
+#if (EEPROM_PAGE_CRC == true)
+	/* Number the new revision after the one it replaces */
+	uint16_t previous = _eeprom_instance.page_map[page->header.logical_page];
+
+	if (previous < (_eeprom_emulator_data_rows() * NVMCTRL_ROW_PAGES)) {
+		page->header.sequence = _eeprom_emulator_page_sequence(previous) + 1;
+	} else {
+		page->header.sequence = 0;
+	}
+
+	page->header.crc = _eeprom_emulator_page_crc(page);
+#endif
+
+	_eeprom_emulator_nvm_fill_cache(physical_page, page);
+	_eeprom_emulator_nvm_commit_cache(physical_page);
+}
+
+/** \internal
+ *  \brief Reads a page of data stored in physical EEPROM memory space.
+ *
+ *  \param[in]  physical_page  Physical page in EEPROM space to read
+ *  \param[out] data           Destination buffer to fill with the read data
+ */
+static void _eeprom_emulator_nvm_read_page(
+		const uint16_t physical_page,
+		void* const data)
+{
+	enum status_code error_code = STATUS_OK;
+
+	do {
+		error_code = nvm_read_buffer(
+				_eeprom_emulator_page_address(physical_page),
+				(uint8_t*)data,
+				NVMCTRL_PAGE_SIZE);
+	} while (error_code == STATUS_BUSY);
+}
+
+/**
+ * \brief Initializes the emulated EEPROM memory, destroying the current contents.
+ */
+static void _eeprom_emulator_format_memory(void)
+{
+	uint16_t logical_page = 0;
+
+#if (EEPROM_METADATA_ROW == true)
+	/* Discard any existing checkpoints first, as a reset during the format
+	 * would otherwise leave one mapping pages into the rows erased since */
+	_eeprom_emulator_nvm_erase_row(_eeprom_emulator_data_rows());
+	_eeprom_instance.checkpoint_spare_row = EEPROM_INVALID_ROW_NUMBER;
+	_eeprom_instance.checkpoint_free_page = 0;
+#endif
+
+	/* Set the first rows as the spare rows */
+	for (uint8_t c = 0; c < EEPROM_SPARE_ROWS; c++) {
+		_eeprom_instance.spare_rows[c] = c;
+		_eeprom_emulator_nvm_erase_row(c);
+	}
+
+	_eeprom_instance.spare_row = 0;
+
+	for (uint16_t physical_page = EEPROM_SPARE_ROWS * NVMCTRL_ROW_PAGES;
+			physical_page < (_eeprom_emulator_data_rows() * NVMCTRL_ROW_PAGES);
+			physical_page++) {
+
+		/* If we are at the first page in a new row, erase the entire row */
+		if ((physical_page % NVMCTRL_ROW_PAGES) == 0) {
+			_eeprom_emulator_nvm_erase_row(physical_page / NVMCTRL_ROW_PAGES);
+		}
+
+		/* Two logical pages are stored in each physical row; program in a
+		 * pair of initialized but blank set of emulated EEPROM pages */
+		if ((physical_page % NVMCTRL_ROW_PAGES) < 2) {
+			/* Make a buffer to hold the initialized EEPROM page */
+			struct _eeprom_page data;
+			memset(&data, 0xFF, sizeof(data));
+
+			/* Set up the new EEPROM row's header */
+			data.header.logical_page = logical_page;
+
+			/* Write the page out to physical memory */
+			_eeprom_emulator_nvm_write_page(physical_page, &data);
+
+			/* Increment the logical EEPROM page address now that the current
+			 * address' page has been initialized */
+			logical_page++;
+		}
+	}
+}
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+/**
+ * \brief Checks if a physical page belongs to an unfinished transaction.
+ *
+ * Pages written by a transaction that was not yet published are recorded, so
+ * that the transaction can be recovered once the scan of the physical memory
+ * is complete.
+ *
+ * \param[in] physical_page  Physical page in EEPROM space to examine
+ *
+ * \return Whether the page must be left out of the logical page mapping.
+ */
+static bool _eeprom_emulator_track_transaction_page(
+		const uint16_t physical_page)
+{
+	uint8_t flags = _eeprom_emulator_page_flags(physical_page);
+
+	/* Pages of discarded transactions are never mapped again */
+	if ((flags & EEPROM_PAGE_FLAG_DISCARDED) == 0) {
+		return true;
+	}
+
+	/* Ordinary and published pages are mapped as usual */
+	if ((flags & EEPROM_PAGE_FLAG_STAGED) ||
+			((flags & EEPROM_PAGE_FLAG_PUBLISHED) == 0)) {
+		return false;
+	}
+
+	if (_eeprom_instance.recovery_count < EEPROM_TRANSACTION_PAGES) {
+		_eeprom_instance.recovery_pages[_eeprom_instance.recovery_count] =
+				physical_page;
+	}
+
+	_eeprom_instance.recovery_count++;
+
+	if ((flags & EEPROM_PAGE_FLAG_COMMIT) == 0) {
+		_eeprom_instance.recovery_committed = true;
+	}
+
+	return true;
+}
+#endif
+
+/**
+ * \brief Checks if a data row belongs to the spare row pool.
+ *
+ * \param[in] row  Physical row to check
+ *
+ * \return Whether the row is a spare row, erased or not.
+ */
+static bool _eeprom_emulator_is_spare_row(
+		const uint8_t row)
+{
+	for (uint8_t c = 0; c < EEPROM_SPARE_ROWS; c++) {
+		if (_eeprom_instance.spare_rows[c] == row) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * \brief Rebuilds the spare row pool after the page map has been rebuilt.
+ *
+ * With a single spare row, the pool is the fully erased row found by the scan.
+ * Otherwise, the spare rows are the data rows holding no current revision of
+ * any logical page, either erased or waiting to be erased; the first erased
+ * one becomes the destination of the next row move. If fewer rows are found,
+ * the last entries of the pool are left invalid.
+ */
+static void _eeprom_emulator_find_spare_rows(void)
+{
+#if (EEPROM_SPARE_ROWS > 1)
+	uint8_t row_mapped[(EEPROM_MAX_ROWS + 7) / 8];
+	uint8_t spare_count = 0;
+
+	memset(row_mapped, 0, sizeof(row_mapped));
+	memset(_eeprom_instance.spare_rows, EEPROM_INVALID_ROW_NUMBER,
+			sizeof(_eeprom_instance.spare_rows));
+	_eeprom_instance.spare_row = EEPROM_INVALID_ROW_NUMBER;
+
+	for (uint16_t c = 0; c < _eeprom_emulator_logical_pages(); c++) {
+		if (_eeprom_instance.page_map[c] != EEPROM_INVALID_PAGE_NUMBER) {
+			uint8_t row = _eeprom_instance.page_map[c] / NVMCTRL_ROW_PAGES;
+
+			row_mapped[row / 8] |= (1 << (row % 8));
+		}
+	}
+
+	for (uint8_t row = 0; (row < _eeprom_emulator_data_rows()) &&
+			(spare_count < EEPROM_SPARE_ROWS); row++) {
+		if (row_mapped[row / 8] & (1 << (row % 8))) {
+			continue;
+		}
+
+		/* A fill level restored from a checkpoint may predate an erase of
+		 * the row, so read it again from the page headers */
+		uint8_t row_fill = 0;
+
+		for (uint8_t c = 0; c < NVMCTRL_ROW_PAGES; c++) {
+			if (_eeprom_emulator_page_header((row * NVMCTRL_ROW_PAGES) + c) !=
+					EEPROM_INVALID_PAGE_NUMBER) {
+				row_fill = c + 1;
+			}
+		}
+
+		_eeprom_instance.row_fill[row] = row_fill;
+		_eeprom_instance.spare_rows[spare_count++] = row;
+
+		if ((row_fill == 0) &&
+				(_eeprom_instance.spare_row == EEPROM_INVALID_ROW_NUMBER)) {
+			_eeprom_instance.spare_row = row;
+		}
+	}
+#else
+	_eeprom_instance.spare_rows[0] = _eeprom_instance.spare_row;
+#endif
+}
+
+/**
+ * \brief Creates a map in SRAM to translate logical EEPROM pages to physical FLASH pages.
+ *
+ * The per-row fill table and the spare row are rebuilt from the same scan of
+ * the physical page headers.
+ */
+static void _eeprom_emulator_update_page_mapping(void)
+{
+	/* Use an invalid page number as the spare row until a valid one has been
+	 * found */
+	_eeprom_instance.spare_row = EEPROM_INVALID_ROW_NUMBER;
+
+	/* Use invalid page numbers for the logical pages until a revision of each
+	 * has been found */
+	memset(_eeprom_instance.page_map, EEPROM_INVALID_PAGE_NUMBER,
+			sizeof(_eeprom_instance.page_map));
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	_eeprom_instance.recovery_count     = 0;
+	_eeprom_instance.recovery_committed = false;
+#endif
+
+	/* Scan through all physical data rows, to map physical and logical pages */
+	for (uint16_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+		uint8_t row_fill = 0;
+
+		for (uint8_t c = 0; c < NVMCTRL_ROW_PAGES; c++) {
+			uint16_t physical_page = (row * NVMCTRL_ROW_PAGES) + c;
+
+			/* Read in the logical page stored in the current physical page */
+			uint16_t logical_page = _eeprom_emulator_page_header(physical_page);
+
+			/* Skip over free pages; the row is in use up to its last used page */
+			if (logical_page == EEPROM_INVALID_PAGE_NUMBER) {
+				continue;
+			}
+
+			row_fill = c + 1;
+
+#if (EEPROM_PAGE_CRC == true)
+			/* Leave torn pages out of the mapping */
+			if (_eeprom_emulator_page_is_intact(physical_page) == false) {
+				continue;
+			}
+#endif
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+			/* Leave pages of unfinished transactions out of the mapping */
+			if (_eeprom_emulator_track_transaction_page(physical_page) == true) {
+				continue;
+			}
+#endif
+
+			/* If the logical page number is valid, add it to the mapping */
+			if ((logical_page < _eeprom_emulator_logical_pages()) &&
+					(_eeprom_emulator_page_is_newer(physical_page, logical_page))) {
+				_eeprom_instance.page_map[logical_page] = physical_page;
+			}
+		}
+
+		_eeprom_instance.row_fill[row] = row_fill;
+
+		/* The first fully erased data row is the spare */
+		if ((row_fill == 0) &&
+				(_eeprom_instance.spare_row == EEPROM_INVALID_ROW_NUMBER)) {
+			_eeprom_instance.spare_row = row;
+		}
+	}
+
+	_eeprom_emulator_find_spare_rows();
+}
+
+#if (EEPROM_METADATA_ROW == true)
+/**
+ * \brief Computes the Fletcher-16 checksum of a block of data.
+ *
+ * \param[in] data    Data to checksum
+ * \param[in] length  Length of the data, in bytes
+ *
+ * \return Checksum of the data.
+ */
+static uint16_t _eeprom_emulator_checksum(
+		const uint8_t *const data,
+		const uint16_t length)
+{
+	uint16_t sum1 = 0;
+	uint16_t sum2 = 0;
+
+	/* Reduce by subtraction, as the device has no hardware divider */
+	for (uint16_t c = 0; c < length; c++) {
+		sum1 += data[c];
+		if (sum1 >= 255) {
+			sum1 -= 255;
+		}
+
+		sum2 += sum1;
+		if (sum2 >= 255) {
+			sum2 -= 255;
+		}
+	}
+
+	return (sum2 << 8) | sum1;
+}
+
+/**
+ * \brief Computes the size of a checkpoint record for the current layout.
+ *
+ * \return Size of a checkpoint record, in bytes.
+ */
+static inline uint16_t _eeprom_emulator_checkpoint_size(void)
+{
+	return sizeof(struct _eeprom_checkpoint) + _eeprom_emulator_logical_pages() +
+			((_eeprom_emulator_data_rows() + 1) / 2);
+}
+
+/**
+ * \brief Writes a checkpoint of the page map to the metadata row.
+ *
+ * Records the current page map, row fill levels and spare row in the next
+ * free pages of the metadata row, erasing it first if the record does not fit.
+ * The write cache must have been committed beforehand, so that the checkpoint
+ * only describes pages present in physical memory.
+ */
+static void _eeprom_emulator_write_checkpoint(void)
+{
+	union {
+		struct _eeprom_checkpoint header;
+		uint8_t bytes[EEPROM_CHECKPOINT_MAX_SIZE];
+	} record;
+
+	uint16_t size  = _eeprom_emulator_checkpoint_size();
+	uint8_t  pages = (size + NVMCTRL_PAGE_SIZE - 1) / NVMCTRL_PAGE_SIZE;
+	uint8_t *payload = &record.bytes[sizeof(struct _eeprom_checkpoint)];
+
+	memset(&record, 0xFF, sizeof(record));
+
+	/* Fill out the checkpoint header */
+	record.header.magic         = EEPROM_CHECKPOINT_MAGIC;
+	record.header.generation    = ++_eeprom_instance.checkpoint_generation;
+	record.header.logical_pages = _eeprom_emulator_logical_pages();
+	record.header.data_rows     = _eeprom_emulator_data_rows();
+	record.header.spare_row     = _eeprom_instance.spare_row;
+
+	/* Append the page map and the row fill levels, two rows per byte */
+	memcpy(payload, _eeprom_instance.page_map, _eeprom_emulator_logical_pages());
+	payload += _eeprom_emulator_logical_pages();
+
+	for (uint8_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+		uint8_t shift = (row % 2) * 4;
+
+		payload[row / 2] &=
+				~(0x0F << shift) | (_eeprom_instance.row_fill[row] << shift);
+	}
+
+	record.header.checksum = _eeprom_emulator_checksum(
+			&record.bytes[offsetof(struct _eeprom_checkpoint, generation)],
+			size - offsetof(struct _eeprom_checkpoint, generation));
+
+	/* Start over on an erased metadata row if the record does not fit */
+	if ((_eeprom_instance.checkpoint_free_page + pages) > NVMCTRL_ROW_PAGES) {
+		_eeprom_emulator_nvm_erase_row(_eeprom_emulator_data_rows());
+		_eeprom_instance.checkpoint_free_page = 0;
+	}
+
+	/* Write the record out to physical memory */
+	for (uint8_t c = 0; c < pages; c++) {
+		uint16_t physical_page = EEPROM_METADATA_PAGE_NUMBER +
+				_eeprom_instance.checkpoint_free_page + c;
+
+		_eeprom_emulator_nvm_fill_cache(
+				physical_page, &record.bytes[c * NVMCTRL_PAGE_SIZE]);
+		_eeprom_emulator_nvm_commit_cache(physical_page);
+	}
+
+	_eeprom_instance.checkpoint_free_page += pages;
+	_eeprom_instance.checkpoint_spare_row  = _eeprom_instance.spare_row;
+}
+
+/**
+ * \brief Restores the page map from the newest checkpoint in the metadata row.
+ *
+ * Loads the newest valid checkpoint, and scans only the pages written to
+ * partially filled rows after it was taken. The checkpoint is only trusted
+ * while its spare row is still erased; that row is filled by the first row
+ * rotation made after the checkpoint, and the checkpoint is renewed whenever
+ * the row is erased again, so no row can have been erased and refilled since.
+ *
+ * \return Whether a valid checkpoint could be used to build the page map.
+ *
+ * \retval \c true   If the page map, row fill table and spare row were restored
+ * \retval \c false  If no checkpoint could be trusted, and a full scan is needed
+ */
+static bool _eeprom_emulator_load_checkpoint(void)
+{
+	const uint8_t *metadata =
+			(const uint8_t *)&_eeprom_instance.flash[EEPROM_METADATA_PAGE_NUMBER];
+	const struct _eeprom_checkpoint *newest = NULL;
+
+	uint16_t size  = _eeprom_emulator_checkpoint_size();
+	uint8_t  pages = (size + NVMCTRL_PAGE_SIZE - 1) / NVMCTRL_PAGE_SIZE;
+
+	_eeprom_instance.checkpoint_spare_row = EEPROM_INVALID_ROW_NUMBER;
+	_eeprom_instance.checkpoint_free_page = 0;
+
+	/* Look for the newest valid checkpoint record in the metadata row */
+	for (uint8_t c = 0; c < NVMCTRL_ROW_PAGES; c++) {
+		const uint8_t *page = &metadata[c * NVMCTRL_PAGE_SIZE];
+		const struct _eeprom_checkpoint *checkpoint =
+				(const struct _eeprom_checkpoint *)page;
+		bool page_erased = true;
+
+		EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(
+				EEPROM_METADATA_PAGE_NUMBER + c), NVMCTRL_PAGE_SIZE);
+
+		for (uint8_t c2 = 0; c2 < NVMCTRL_PAGE_SIZE; c2++) {
+			if (page[c2] != 0xFF) {
+				page_erased = false;
+				break;
+			}
+		}
+
+		/* Records are written in order, so only erased pages are free */
+		if (page_erased == true) {
+			continue;
+		}
+
+		_eeprom_instance.checkpoint_free_page = c + 1;
+
+		/* Skip over pages that do not start a checkpoint of this layout */
+		if ((checkpoint->magic != EEPROM_CHECKPOINT_MAGIC) ||
+				(checkpoint->logical_pages != _eeprom_emulator_logical_pages()) ||
+				(checkpoint->data_rows != _eeprom_emulator_data_rows()) ||
+				((c + pages) > NVMCTRL_ROW_PAGES)) {
+			continue;
+		}
+
+		/* Skip over incomplete or corrupt records */
+		if (checkpoint->checksum != _eeprom_emulator_checksum(
+				&page[offsetof(struct _eeprom_checkpoint, generation)],
+				size - offsetof(struct _eeprom_checkpoint, generation))) {
+			continue;
+		}
+
+		if ((newest == NULL) || (checkpoint->generation > newest->generation)) {
+			newest = checkpoint;
+		}
+
+		c += (pages - 1);
+		_eeprom_instance.checkpoint_free_page = c + 1;
+	}
+
+	if (newest == NULL) {
+		return false;
+	}
+
+	_eeprom_instance.checkpoint_generation = newest->generation;
+
+	/* A row rotation has been made since the checkpoint if its spare row is
+	 * no longer erased */
+	if ((newest->spare_row >= _eeprom_emulator_data_rows()) ||
+			(_eeprom_emulator_page_header(newest->spare_row * NVMCTRL_ROW_PAGES)
+				!= EEPROM_INVALID_PAGE_NUMBER)) {
+		return false;
+	}
+
+	/* Restore the page map and the row fill levels from the checkpoint */
+	const uint8_t *payload =
+			(const uint8_t *)newest + sizeof(struct _eeprom_checkpoint);
+
+	memcpy(_eeprom_instance.page_map, payload, _eeprom_emulator_logical_pages());
+	payload += _eeprom_emulator_logical_pages();
+
+	for (uint8_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+		_eeprom_instance.row_fill[row] =
+				(payload[row / 2] >> ((row % 2) * 4)) & 0x0F;
+	}
+
+	_eeprom_instance.spare_row            = newest->spare_row;
+	_eeprom_instance.checkpoint_spare_row = newest->spare_row;
+
+	/* Map the pages appended to partially filled rows since the checkpoint */
+	for (uint8_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+		if (row == _eeprom_instance.spare_row) {
+			continue;
+		}
+
+		for (uint8_t c = _eeprom_instance.row_fill[row]; c < NVMCTRL_ROW_PAGES; c++) {
+			uint16_t physical_page = (row * NVMCTRL_ROW_PAGES) + c;
+			uint16_t logical_page  = _eeprom_emulator_page_header(physical_page);
+
+			if (logical_page == EEPROM_INVALID_PAGE_NUMBER) {
+				break;
+			}
+
+			_eeprom_instance.row_fill[row] = c + 1;
+
+#if (EEPROM_PAGE_CRC == true)
+			if (_eeprom_emulator_page_is_intact(physical_page) == false) {
+				continue;
+			}
+#endif
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+			if (_eeprom_emulator_track_transaction_page(physical_page) == true) {
+				continue;
+			}
+#endif
+
+			if ((logical_page < _eeprom_emulator_logical_pages()) &&
+					(_eeprom_emulator_page_is_newer(physical_page, logical_page))) {
+				_eeprom_instance.page_map[logical_page] = physical_page;
+			}
+		}
+	}
+
+	_eeprom_emulator_find_spare_rows();
+
+	return true;
+}
+#endif
+
+/**
+ * \brief Finds the next free page in the given row if one is available.
+ *
+ * \param[in]  start_physical_page  Physical FLASH page index of the row to
+ *                                  search
+ * \param[out] free_physical_page   Index of the physical FLASH page that is
+ *                                  currently free (if one was found)
+ *
+ * \return Whether a free page was found in the specified row.
+ *
+ * \retval \c true   If a free page was found
+ * \retval \c false  If the specified row was full and needs an erase
+ */
+static bool _eeprom_emulator_is_page_free_on_row(
+		const uint16_t start_physical_page,
+		uint16_t *const free_physical_page)
+{
+	/* Convert physical page number to a FLASH row */
+	uint8_t row = (start_physical_page / NVMCTRL_ROW_PAGES);
+
+	/* Pages within a row are always used in order, so the fill level of the
+	 * row tracked in SRAM is the index of the next free page */
+	if (_eeprom_instance.row_fill[row] < NVMCTRL_ROW_PAGES) {
+		*free_physical_page =
+				(row * NVMCTRL_ROW_PAGES) + _eeprom_instance.row_fill[row];
+		return true;
+	}
+
+	/* No free page in the current row was found */
+	return false;
+}
+
+#if (EEPROM_DELTA_RECORDS == true) && (EEPROM_PAGE_CRC == true)
+/**
+ * \brief Computes the CRC of a delta record.
+ *
+ * \param[in] record  Delta record, starting with its offset and length
+ *
+ * \return CRC of the record offset, length and data.
+ */
+static uint16_t _eeprom_emulator_delta_crc(
+		const uint8_t *const record)
+{
+	uint16_t crc = eeprom_emulator_crc16(0xFFFF, record, 2);
+
+	return eeprom_emulator_crc16(crc, &record[EEPROM_DELTA_HEADER_SIZE],
+			record[1]);
+}
+
+/** \internal
+ *  Checks that a delta record was completely written, as a torn record append
+ *  is not covered by the CRC of its page.
+ */
+#  define _eeprom_emulator_delta_is_intact(record) \
+		(((record)[2] | ((record)[3] << 8)) == \
+				_eeprom_emulator_delta_crc(record))
+#elif (EEPROM_DELTA_RECORDS == true)
+#  define _eeprom_emulator_delta_is_intact(record)  true
+#endif
+
+/**
+ * \brief Reads the newest contents of a logical page from physical memory.
+ *
+ * \param[in]  logical_page  Logical EEPROM page number to read
+ * \param[out] page          Buffer to fill with the page header and contents
+ */
+static void _eeprom_emulator_read_logical_page(
+		const uint16_t logical_page,
+		struct _eeprom_page *const page)
+{
+	uint16_t newest = _eeprom_instance.page_map[logical_page];
+
+#if (EEPROM_DELTA_RECORDS == true)
+	uint16_t row_start = newest - (newest % NVMCTRL_ROW_PAGES);
+	uint16_t base      = newest;
+
+	/* Find the newest full revision of the page, which is stored in the same
+	 * row before any delta records of the page */
+	while (base > row_start) {
+		uint8_t flags = _eeprom_emulator_page_flags(base);
+
+		if ((_eeprom_emulator_page_header(base) == logical_page) &&
+				(flags & EEPROM_PAGE_FLAG_DELTA) &&
+				(flags & EEPROM_PAGE_FLAG_DISCARDED) &&
+				_eeprom_emulator_page_is_intact(base)) {
+			break;
+		}
+
+		base--;
+	}
+
+	_eeprom_emulator_nvm_read_page(base, page);
+
+	/* Replay the delta records stored after it, oldest first */
+	for (uint16_t physical_page = base + 1; physical_page <= newest;
+			physical_page++) {
+		struct _eeprom_page delta;
+
+		if ((_eeprom_emulator_page_header(physical_page) != logical_page) ||
+				(_eeprom_emulator_page_flags(physical_page) &
+					EEPROM_PAGE_FLAG_DELTA) ||
+				(_eeprom_emulator_page_is_intact(physical_page) == false)) {
+			continue;
+		}
+
+		_eeprom_emulator_nvm_read_page(physical_page, &delta);
+
+		for (uint8_t c = 0; (c + EEPROM_DELTA_HEADER_SIZE) < EEPROM_PAGE_SIZE;) {
+			uint8_t offset = delta.data[c];
+			uint8_t length = delta.data[c + 1];
+
+			/* Stop at the first free or incomplete record */
+			if ((offset >= EEPROM_PAGE_SIZE) || (length == 0) ||
+					((offset + length) > EEPROM_PAGE_SIZE) ||
+					((c + EEPROM_DELTA_HEADER_SIZE + length) > EEPROM_PAGE_SIZE) ||
+					(_eeprom_emulator_delta_is_intact(&delta.data[c]) == false)) {
+				break;
+			}
+
+			memcpy(&page->data[offset], &delta.data[c + EEPROM_DELTA_HEADER_SIZE],
+					length);
+			c += EEPROM_DELTA_HEADER_SIZE + length;
+		}
+	}
+#else
+	_eeprom_emulator_nvm_read_page(newest, page);
+#endif
+
+	/* The contents are only ever written back as an ordinary full page */
+	page->header.flags = 0xFF;
+}
+
+#if (EEPROM_DELTA_RECORDS == true)
+/**
+ * \brief Finds the first free byte of the records area of a delta page.
+ *
+ * \param[in] physical_page  Physical page in EEPROM space to examine
+ *
+ * \return Offset of the first free byte in the page data, or
+ *         \ref EEPROM_PAGE_SIZE if the page is full or does not hold delta
+ *         records.
+ */
+static uint8_t _eeprom_emulator_delta_free_offset(
+		const uint16_t physical_page)
+{
+	const struct _eeprom_page *page = &_eeprom_instance.flash[physical_page];
+	uint8_t c = 0;
+
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page),
+			NVMCTRL_PAGE_SIZE);
+
+	if (page->header.flags & EEPROM_PAGE_FLAG_DELTA) {
+		return EEPROM_PAGE_SIZE;
+	}
+
+	/* Skip over the records already stored; a record offset which is still
+	 * erased marks the free space */
+	while (((c + EEPROM_DELTA_HEADER_SIZE) < EEPROM_PAGE_SIZE) &&
+			(page->data[c] != 0xFF)) {
+		uint8_t length = page->data[c + 1];
+
+		/* Never append after a damaged record */
+		if ((length == 0) ||
+				((c + EEPROM_DELTA_HEADER_SIZE + length) > EEPROM_PAGE_SIZE) ||
+				(_eeprom_emulator_delta_is_intact(&page->data[c]) == false)) {
+			return EEPROM_PAGE_SIZE;
+		}
+
+		c += EEPROM_DELTA_HEADER_SIZE + length;
+	}
+
+	/* A free record needs an erased header and at least one data byte */
+	for (uint8_t c2 = c; c2 < EEPROM_PAGE_SIZE; c2++) {
+		if (page->data[c2] != 0xFF) {
+			return EEPROM_PAGE_SIZE;
+		}
+	}
+
+	return c;
+}
+
+/**
+ * \brief Computes the delta record needed to update a logical page.
+ *
+ * \param[in]  current  Current contents of the logical page
+ * \param[in]  data     New contents of the logical page
+ * \param[out] offset   Offset of the first changed byte
+ * \param[out] length   Number of bytes from the first to the last changed byte
+ *
+ * \return Whether the contents differ.
+ */
+static bool _eeprom_emulator_delta_span(
+		const uint8_t *const current,
+		const uint8_t *const data,
+		uint8_t *const offset,
+		uint8_t *const length)
+{
+	uint8_t first = 0;
+	uint8_t last  = EEPROM_PAGE_SIZE;
+
+	while ((first < EEPROM_PAGE_SIZE) && (current[first] == data[first])) {
+		first++;
+	}
+
+	if (first == EEPROM_PAGE_SIZE) {
+		return false;
+	}
+
+	while (current[last - 1] == data[last - 1]) {
+		last--;
+	}
+
+	*offset = first;
+	*length = last - first;
+	return true;
+}
+
+/**
+ * \brief Checks if an update of a logical page can be appended to its
+ *        current delta page without using a free page of the row.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to update
+ * \param[in] data          New contents of the logical page
+ *
+ * \return Whether the update fits into the newest delta page of the page.
+ */
+static bool _eeprom_emulator_delta_fits(
+		const uint16_t logical_page,
+		const uint8_t *const data)
+{
+	struct _eeprom_page current;
+	uint8_t offset;
+	uint8_t length;
+	uint8_t free_offset =
+			_eeprom_emulator_delta_free_offset(_eeprom_instance.page_map[logical_page]);
+
+	if (free_offset >= EEPROM_PAGE_SIZE) {
+		return false;
+	}
+
+	_eeprom_emulator_read_logical_page(logical_page, &current);
+
+	if (_eeprom_emulator_delta_span(current.data, data, &offset, &length) == false) {
+		return true;
+	}
+
+	return ((free_offset + EEPROM_DELTA_HEADER_SIZE + length) <= EEPROM_PAGE_SIZE);
+}
+
+/**
+ * \brief Writes an update of a logical page as a delta record.
+ *
+ * Appends a record holding the changed bytes of the page to its newest delta
+ * page, programming only bytes of the page that are still erased. If there is
+ * no room left, a small record is written to a new delta page in the row.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to update
+ * \param[in] data          New contents of the logical page
+ *
+ * \return Whether the update was written; if not, a full page revision is
+ *         needed.
+ */
+static bool _eeprom_emulator_write_delta(
+		const uint16_t logical_page,
+		const uint8_t *const data)
+{
+	struct _eeprom_page current;
+	struct _eeprom_page record;
+	uint8_t  offset;
+	uint8_t  length;
+	uint8_t  free_offset;
+	uint16_t physical_page = _eeprom_instance.page_map[logical_page];
+	bool     new_page      = false;
+
+	_eeprom_emulator_read_logical_page(logical_page, &current);
+
+	if (_eeprom_emulator_delta_span(current.data, data, &offset, &length) == false) {
+		return true;
+	}
+
+	free_offset = _eeprom_emulator_delta_free_offset(physical_page);
+
+	/* Start a new delta page if the current one is full, as long as the
+	 * record is small enough to be worth it */
+	if ((free_offset + EEPROM_DELTA_HEADER_SIZE + length) > EEPROM_PAGE_SIZE) {
+		if (((EEPROM_DELTA_HEADER_SIZE + length) > EEPROM_DELTA_MAX_RECORD_SIZE) ||
+				(_eeprom_emulator_is_page_free_on_row(
+					physical_page, &physical_page) == false)) {
+			return false;
+		}
+
+		free_offset = 0;
+		new_page    = true;
+	}
+
+	/* Program the page again with its current contents plus the new record,
+	 * which only clears bits of bytes that are still erased */
+	if (new_page == true) {
+		memset(&record, 0xFF, sizeof(record));
+		record.header.logical_page = logical_page;
+		record.header.flags       &= ~EEPROM_PAGE_FLAG_DELTA;
+	} else {
+		_eeprom_emulator_nvm_read_page(physical_page, &record);
+	}
+
+	record.data[free_offset]     = offset;
+	record.data[free_offset + 1] = length;
+	memcpy(&record.data[free_offset + EEPROM_DELTA_HEADER_SIZE],
+			&data[offset], length);
+
+#if (EEPROM_PAGE_CRC == true)
+	uint16_t crc = _eeprom_emulator_delta_crc(&record.data[free_offset]);
+
+	record.data[free_offset + 2] = (crc & 0xFF);
+	record.data[free_offset + 3] = (crc >> 8);
+#endif
+
+	if (new_page == true) {
+		_eeprom_emulator_nvm_write_page(physical_page, &record);
+	} else {
+		_eeprom_emulator_nvm_fill_cache(physical_page, &record);
+		_eeprom_emulator_nvm_commit_cache(physical_page);
+	}
+
+	_eeprom_instance.page_map[logical_page] = physical_page;
+	_eeprom_instance.statistics.delta_records++;
+
+	return true;
+}
+#else
+#  define _eeprom_emulator_delta_fits(logical_page, data)  false
+#endif
+
+#if (EEPROM_READ_CACHE_ENTRIES > 0)
+/**
+ * \brief Empties the read cache.
+ */
+static void _eeprom_emulator_read_cache_clear(void)
+{
+	for (uint8_t c = 0; c < EEPROM_READ_CACHE_ENTRIES; c++) {
+		_eeprom_instance.read_cache[c].logical_page = EEPROM_INVALID_PAGE_NUMBER;
+	}
+}
+
+/**
+ * \brief Drops a logical page from the read cache.
+ *
+ * Called when the contents of the page change, so that the next read fetches
+ * them again.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to drop
+ */
+static void _eeprom_emulator_read_cache_invalidate(
+		const uint16_t logical_page)
+{
+	for (uint8_t c = 0; c < EEPROM_READ_CACHE_ENTRIES; c++) {
+		struct _eeprom_read_cache_entry *entry = &_eeprom_instance.read_cache[c];
+
+		if (entry->logical_page == logical_page) {
+			entry->logical_page = EEPROM_INVALID_PAGE_NUMBER;
+			return;
+		}
+	}
+}
+
+/**
+ * \brief Reads a logical page from physical memory through the read cache.
+ *
+ * Copies the page contents from its read cache entry if there is one, or
+ * otherwise from physical memory, storing them in the least recently read
+ * entry.
+ *
+ * \param[in]  logical_page  Logical EEPROM page number to read
+ * \param[out] data          Buffer to fill with the page contents
+ */
+static void _eeprom_emulator_read_cache_read(
+		const uint16_t logical_page,
+		uint8_t *const data)
+{
+	struct _eeprom_read_cache_entry *victim = &_eeprom_instance.read_cache[0];
+
+	for (uint8_t c = 0; c < EEPROM_READ_CACHE_ENTRIES; c++) {
+		struct _eeprom_read_cache_entry *entry = &_eeprom_instance.read_cache[c];
+
+		if (entry->logical_page == logical_page) {
+			entry->last_use = ++_eeprom_instance.cache_clock;
+			memcpy(data, entry->data, EEPROM_PAGE_SIZE);
+
+			_eeprom_instance.statistics.read_cache_hits++;
+			return;
+		}
+
+		/* Prefer a free entry, then the least recently read one */
+		if ((victim->logical_page != EEPROM_INVALID_PAGE_NUMBER) &&
+				((entry->logical_page == EEPROM_INVALID_PAGE_NUMBER) ||
+				(entry->last_use < victim->last_use))) {
+			victim = entry;
+		}
+	}
+
+	struct _eeprom_page temp;
+
+	_eeprom_emulator_read_logical_page(logical_page, &temp);
+	memcpy(data, temp.data, EEPROM_PAGE_SIZE);
+
+	memcpy(victim->data, temp.data, EEPROM_PAGE_SIZE);
+	victim->logical_page = logical_page;
+	victim->last_use     = ++_eeprom_instance.cache_clock;
+
+	_eeprom_instance.statistics.read_cache_misses++;
+}
+#else
+#  define _eeprom_emulator_read_cache_clear()
+#  define _eeprom_emulator_read_cache_invalidate(logical_page)
+#endif
+
+/**
+ * \brief Finds the write cache entry holding a logical page.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to look for
+ *
+ * \return Pointer to the active cache entry for the page, or \c NULL if the
+ *         page is not cached.
+ */
+static struct _eeprom_cache_entry *_eeprom_emulator_cache_find(
+		const uint16_t logical_page)
+{
+	for (uint8_t c = 0; c < EEPROM_CACHE_ENTRIES; c++) {
+		struct _eeprom_cache_entry *entry = &_eeprom_instance.cache[c];
+
+		if ((entry->active == true) &&
+				(entry->page.header.logical_page == logical_page)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Counts the cached pages waiting to be written to a physical row.
+ *
+ * \param[in] row  Physical row to examine
+ *
+ * \return Number of active cache entries whose logical page is stored in the
+ *         given row.
+ */
+static uint8_t _eeprom_emulator_cache_pending_on_row(
+		const uint8_t row)
+{
+	uint8_t pending = 0;
+
+	for (uint8_t c = 0; c < EEPROM_CACHE_ENTRIES; c++) {
+		struct _eeprom_cache_entry *entry = &_eeprom_instance.cache[c];
+
+		if ((entry->active == true) &&
+				((_eeprom_instance.page_map[entry->page.header.logical_page] /
+					NVMCTRL_ROW_PAGES) == row)) {
+			pending++;
+		}
+	}
+
+	return pending;
+}
+
+/**
+ * \brief Compares new page data against the copy of a logical page in FLASH.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to compare
+ * \param[in] data          New data for the logical page
+ *
+ * \return Whether the newest revision of the page in physical memory already
+ *         holds the given data.
+ */
+static bool _eeprom_emulator_page_matches(
+		const uint16_t logical_page,
+		const uint8_t *const data)
+{
+#if (EEPROM_DELTA_RECORDS == true)
+	/* The page contents may be spread over several physical pages */
+	struct _eeprom_page current;
+	_eeprom_emulator_read_logical_page(logical_page, &current);
+
+	return (memcmp(current.data, data, EEPROM_PAGE_SIZE) == 0);
+#else
+	uint16_t physical_page = _eeprom_instance.page_map[logical_page];
+
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page) +
+			EEPROM_HEADER_SIZE, EEPROM_PAGE_SIZE);
+
+	return (memcmp(_eeprom_instance.flash[physical_page].data, data,
+			EEPROM_PAGE_SIZE) == 0);
+#endif
+}
+
+/**
+ * \brief Starts moving a row to the spare row.
+ *
+ * Sets up a move of the contents of the specified row into the spare row, so
+ * that the original row can be erased and re-used. The contents of the given
+ * logical page is replaced with a new buffer of data; if the logical page is
+ * \ref EEPROM_INVALID_PAGE_NUMBER, the contents of both pages are kept. The
+ * move is carried out by \ref _eeprom_emulator_move_step(), one NVM operation
+ * at a time.
+ *
+ * \param[in] row_number    Physical row to move
+ * \param[in] logical_page  Logical EEPROM page number in the row to update
+ * \param[in] data          New data to replace the old in the logical page
+ * \param[in] entry         Cache entry holding the new data, released once the
+ *                          move completes, or \c NULL
+ */
+static void _eeprom_emulator_move_begin(
+		const uint8_t row_number,
+		const uint16_t logical_page,
+		const uint8_t *const data,
+		struct _eeprom_cache_entry *const entry)
+{
+	_eeprom_instance.move_row          = row_number;
+	_eeprom_instance.move_step         = 0;
+	_eeprom_instance.move_logical_page = logical_page;
+	_eeprom_instance.move_data         = data;
+	_eeprom_instance.move_entry        = entry;
+}
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+/**
+ * \brief Swaps the spare row with the least worn data row if needed.
+ *
+ * The pages written most often end up in the spare row at every row move, so
+ * the spare row wears fastest. Once its erase count exceeds that of the least
+ * worn data row by more than \ref EEPROM_WEAR_LEVELING_THRESHOLD, a move of
+ * that row, which is rarely written, into the spare row is started, so that
+ * the least worn row becomes the new spare row.
+ */
+static void _eeprom_emulator_level_wear(void)
+{
+	uint8_t  coldest_row    = EEPROM_INVALID_ROW_NUMBER;
+	uint16_t coldest_erases = EEPROM_UNKNOWN_ERASE_COUNT;
+
+	for (uint8_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+		if (_eeprom_emulator_is_spare_row(row) == true) {
+			continue;
+		}
+
+		uint16_t erases = _eeprom_emulator_row_erases(row);
+
+		if (erases < coldest_erases) {
+			coldest_row    = row;
+			coldest_erases = erases;
+		}
+	}
+
+	if ((coldest_row == EEPROM_INVALID_ROW_NUMBER) ||
+			((_eeprom_emulator_row_erases(_eeprom_instance.spare_row) -
+				coldest_erases) <= EEPROM_WEAR_LEVELING_THRESHOLD)) {
+		return;
+	}
+
+	_eeprom_instance.statistics.wear_leveling_moves++;
+
+	/* The moved row becomes the spare row with at most one more erase than
+	 * any other row, so this does not chain any further */
+	_eeprom_emulator_move_begin(
+			coldest_row, EEPROM_INVALID_PAGE_NUMBER, NULL, NULL);
+}
+#endif
+
+/**
+ * \brief Copies one logical page of the row being moved into the spare row.
+ *
+ * There should be two logical pages of data in each row, possibly with
+ * multiple revisions; the left-most two pages hold one revision of each, and
+ * the page map already tracks where the newest revisions are.
+ *
+ * \param[in] c  Index of the page to copy, within the row being moved
+ */
+static void _eeprom_emulator_move_page(
+		const uint8_t c)
+{
+	const uint16_t row_start =
+			(_eeprom_instance.move_row * NVMCTRL_ROW_PAGES);
+
+	/* Find the logical page to copy, and the physical page index for it in
+	 * the new spare row */
+	uint16_t logical_page = _eeprom_emulator_page_header(row_start + c);
+	uint16_t new_page     =
+			((_eeprom_instance.spare_row * NVMCTRL_ROW_PAGES) + c);
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+	/* The erase count of the spare row is lost at initialization; assume it
+	 * has been erased as often as the row being moved into it */
+	if (_eeprom_emulator_erased_row_entry(_eeprom_instance.spare_row) ==
+			EEPROM_SPARE_ROWS) {
+		_eeprom_emulator_set_row_erases(_eeprom_instance.spare_row,
+				_eeprom_emulator_row_erases(_eeprom_instance.move_row));
+	}
+#endif
+
+	struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_find(logical_page);
+	struct _eeprom_page page;
+
+	/* Check if we we are looking at the page the calling function wishes
+	 * to change during the move operation */
+	if (logical_page == _eeprom_instance.move_logical_page) {
+		/* Fill out new (updated) logical page's header */
+		page.header.logical_page = logical_page;
+		page.header.flags        = 0xFF;
+		page.header.row_erases   = EEPROM_UNKNOWN_ERASE_COUNT;
+
+		/* Copy the new data into the page */
+		memcpy(page.data, _eeprom_instance.move_data, EEPROM_PAGE_SIZE);
+	} else if (entry != NULL) {
+		/* Write out the newer cached contents of the other page now, as
+		 * that saves writing it again later */
+		page = entry->page;
+		entry->active = false;
+	} else {
+		/* Copy existing EEPROM page wholesale */
+		_eeprom_emulator_read_logical_page(logical_page, &page);
+	}
+
+	/* Write the page to the new row */
+	_eeprom_emulator_nvm_write_page(new_page, &page);
+
+	/* Update the page map with the new page location */
+	_eeprom_instance.page_map[logical_page] = new_page;
+}
+
+/**
+ * \brief Hands a moved row over to the spare row pool.
+ *
+ * The spare row that received the contents of the row leaves the pool, and
+ * the moved row joins it last, to be erased once every row that joined before
+ * it has been. The first erased row of the pool becomes the new spare row, if
+ * there is one.
+ *
+ * \param[in] row_number  Physical row whose contents were moved
+ */
+static void _eeprom_emulator_add_spare_row(
+		const uint8_t row_number)
+{
+	uint8_t count = 0;
+
+	for (uint8_t c = 0; c < EEPROM_SPARE_ROWS; c++) {
+		if (_eeprom_instance.spare_rows[c] != _eeprom_instance.spare_row) {
+			_eeprom_instance.spare_rows[count++] = _eeprom_instance.spare_rows[c];
+		}
+	}
+
+	_eeprom_instance.spare_rows[count] = row_number;
+	_eeprom_instance.spare_row         = EEPROM_INVALID_ROW_NUMBER;
+
+	for (uint8_t c = 0; c < EEPROM_SPARE_ROWS; c++) {
+		if (_eeprom_instance.row_fill[_eeprom_instance.spare_rows[c]] == 0) {
+			_eeprom_instance.spare_row = _eeprom_instance.spare_rows[c];
+			break;
+		}
+	}
+}
+
+/**
+ * \brief Performs the next step of the row move in progress.
+ *
+ * Each step starts at most a single page write or row erase, so that the
+ * caller may service other events while the NVM controller completes it. Once
+ * both logical pages of the row have been copied, the row joins the spare row
+ * pool; if no erased spare row is left, the row of the pool that joined first
+ * is erased (after renewing the checkpoint if needed). The move ends at the
+ * following step, unless wear leveling then starts another one.
+ */
+static void _eeprom_emulator_move_step(void)
+{
+	/* Copy the two logical pages of the row one at a time */
+	if (_eeprom_instance.move_step < 2) {
+		_eeprom_emulator_move_page(_eeprom_instance.move_step++);
+		return;
+	}
+
+	if (_eeprom_instance.move_step == 2) {
+		/* The moved row becomes a spare row, to be erased before re-use */
+		_eeprom_emulator_add_spare_row(_eeprom_instance.move_row);
+		_eeprom_instance.move_step =
+				(_eeprom_instance.spare_row == EEPROM_INVALID_ROW_NUMBER) ? 3 : 5;
+	}
+
+	if (_eeprom_instance.move_step == 3) {
+		/* Erase the row of the pool that has waited longest; with no erased
+		 * spare row left, it becomes the new spare row */
+		for (uint8_t c = 0; c < EEPROM_SPARE_ROWS; c++) {
+			if (_eeprom_instance.row_fill[_eeprom_instance.spare_rows[c]] != 0) {
+				_eeprom_instance.move_row = _eeprom_instance.spare_rows[c];
+				break;
+			}
+		}
+
+		if (_eeprom_instance.spare_row == EEPROM_INVALID_ROW_NUMBER) {
+			_eeprom_instance.spare_row = _eeprom_instance.move_row;
+		}
+
+		_eeprom_instance.move_step = 4;
+
+#if (EEPROM_METADATA_ROW == true)
+		/* The checkpoint can only be trusted while its spare row has not been
+		 * erased again; renew it before that guarantee is lost, so that a
+		 * reset before the erase finds a checkpoint whose spare row is not
+		 * erased */
+		if (_eeprom_instance.move_row == _eeprom_instance.checkpoint_spare_row) {
+			_eeprom_instance.row_fill[_eeprom_instance.move_row] = 0;
+			_eeprom_emulator_write_checkpoint();
+			return;
+		}
+#endif
+	}
+
+	if (_eeprom_instance.move_step == 4) {
+		/* Erase the row, making it an erased spare row */
+		_eeprom_emulator_nvm_erase_row(_eeprom_instance.move_row);
+		_eeprom_instance.move_step = 5;
+		return;
+	}
+
+	/* The new page contents are now stored, so the cache entry holding them
+	 * can be released */
+	if (_eeprom_instance.move_entry != NULL) {
+		_eeprom_instance.move_entry->active = false;
+	}
+
+	_eeprom_instance.move_row = EEPROM_INVALID_ROW_NUMBER;
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+	/* Hand the least worn row over to frequently written pages; this reads
+	 * the page headers, so it is left until the erase has completed */
+	_eeprom_emulator_level_wear();
+#endif
+}
+
+#if (EEPROM_SPARE_ROWS > 1)
+/**
+ * \brief Starts erasing a spare row waiting to be erased.
+ *
+ * Sets up the erase of the row of the spare row pool that joined it first, as
+ * the final steps of a row move carried out by
+ * \ref _eeprom_emulator_move_step().
+ *
+ * \return Whether a spare row is waiting to be erased.
+ */
+static bool _eeprom_emulator_erase_spare_begin(void)
+{
+	for (uint8_t c = 0; c < EEPROM_SPARE_ROWS; c++) {
+		if (_eeprom_instance.row_fill[_eeprom_instance.spare_rows[c]] != 0) {
+			_eeprom_emulator_move_begin(_eeprom_instance.spare_rows[c],
+					EEPROM_INVALID_PAGE_NUMBER, NULL, NULL);
+			_eeprom_instance.move_step = 3;
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
+/**
+ * \brief Completes the row move in progress, if any.
+ */
+static void _eeprom_emulator_move_complete(void)
+{
+	/* Count the moves that the caller has to wait for */
+	if ((_eeprom_instance.move_row != EEPROM_INVALID_ROW_NUMBER) &&
+			(_eeprom_instance.move_step < 5)) {
+		_eeprom_instance.statistics.blocking_moves++;
+	}
+
+	while (_eeprom_instance.move_row != EEPROM_INVALID_ROW_NUMBER) {
+		_eeprom_emulator_move_step();
+	}
+}
+
+/**
+ * \brief Moves data from the specified logical page to the spare row.
+ *
+ * Moves the contents of the specified row into the spare row, so that the
+ * original row can be erased and re-used. The contents of the given logical
+ * page is replaced with a new buffer of data; if the logical page is
+ * \ref EEPROM_INVALID_PAGE_NUMBER, the contents of both pages are kept.
+ *
+ * \param[in] row_number    Physical row to examine
+ * \param[in] logical_page  Logical EEPROM page number in the row to update
+ * \param[in] data          New data to replace the old in the logical page
+ *
+ * \return Status code indicating the status of the operation.
+ */
+static enum status_code _eeprom_emulator_move_data_to_spare(
+		const uint8_t row_number,
+		const uint16_t logical_page,
+		const uint8_t *const data)
+{
+	_eeprom_emulator_move_begin(row_number, logical_page, data, NULL);
+	_eeprom_emulator_move_complete();
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Starts writing a cached page out to physical memory.
+ *
+ * Writes the contents of a write cache entry to the next free page in the row
+ * of its logical page, and releases the entry. If the row has no free page
+ * left, a move of the row to the spare row is started instead, which releases
+ * the entry once it completes.
+ *
+ * \param[in] entry  Active cache entry to write out
+ *
+ * \return Whether the page was written, rather than a row move started.
+ */
+static bool _eeprom_emulator_cache_flush_begin(
+		struct _eeprom_cache_entry *const entry)
+{
+	uint16_t logical_page = entry->page.header.logical_page;
+	uint16_t new_page    = 0;
+
+#if (EEPROM_DELTA_RECORDS == true)
+	/* Store small updates as a delta record where possible */
+	if (_eeprom_emulator_write_delta(logical_page, entry->page.data) == true) {
+		entry->active = false;
+		return true;
+	}
+#endif
+
+	/* A free page is normally kept reserved in the row for every cached page;
+	 * if there is none, rotate the row with the new page contents instead */
+	if (_eeprom_emulator_is_page_free_on_row(
+			_eeprom_instance.page_map[logical_page], &new_page) == false) {
+		_eeprom_emulator_move_begin(
+				_eeprom_instance.page_map[logical_page] / NVMCTRL_ROW_PAGES,
+				logical_page,
+				entry->page.data,
+				entry);
+		return false;
+	}
+
+	/* Perform the page write to commit the cached page to FLASH */
+	_eeprom_emulator_nvm_write_page(new_page, &entry->page);
+
+	/* Update the page map and release the cache entry */
+	_eeprom_instance.page_map[logical_page] = new_page;
+	barrier(); // Enforce ordering to prevent incorrect cache state
+	entry->active = false;
+
+	return true;
+}
+
+/**
+ * \brief Writes a cached page out to physical memory.
+ *
+ * Writes the contents of a write cache entry to physical memory, moving its
+ * row to the spare row if needed, and releases the entry.
+ *
+ * \param[in] entry  Active cache entry to write out
+ */
+static void _eeprom_emulator_cache_flush(
+		struct _eeprom_cache_entry *const entry)
+{
+	_eeprom_emulator_cache_flush_begin(entry);
+	_eeprom_emulator_move_complete();
+}
+
+/**
+ * \brief Finds the least recently used active write cache entry.
+ *
+ * \return Pointer to the least recently used active cache entry, or \c NULL if
+ *         the cache is empty.
+ */
+static struct _eeprom_cache_entry *_eeprom_emulator_cache_oldest(void)
+{
+	struct _eeprom_cache_entry *oldest = NULL;
+
+	for (uint8_t c = 0; c < EEPROM_CACHE_ENTRIES; c++) {
+		struct _eeprom_cache_entry *entry = &_eeprom_instance.cache[c];
+
+		if ((entry->active == true) &&
+				((oldest == NULL) || (entry->last_use < oldest->last_use))) {
+			oldest = entry;
+		}
+	}
+
+	return oldest;
+}
+
+/**
+ * \brief Allocates a write cache entry for a new logical page.
+ *
+ * Returns a free cache entry, writing out the least recently used page first
+ * if all entries are in use.
+ *
+ * \return Pointer to a free cache entry.
+ */
+static struct _eeprom_cache_entry *_eeprom_emulator_cache_allocate(void)
+{
+	for (uint8_t c = 0; c < EEPROM_CACHE_ENTRIES; c++) {
+		if (_eeprom_instance.cache[c].active == false) {
+			return &_eeprom_instance.cache[c];
+		}
+	}
+
+	struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_oldest();
+	_eeprom_emulator_cache_flush(entry);
+
+	return entry;
+}
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+/**
+ * \brief Updates the page flags of a page already written to physical memory.
+ *
+ * Programs the page again with the given flags cleared, which leaves the rest
+ * of its contents unchanged.
+ *
+ * \param[in] physical_page  Physical page in EEPROM space to update
+ * \param[in] flags          Active-low \c EEPROM_PAGE_FLAG_* flags to clear
+ */
+static void _eeprom_emulator_clear_page_flags(
+		const uint16_t physical_page,
+		const uint8_t flags)
+{
+	struct _eeprom_page page;
+
+	_eeprom_emulator_nvm_read_page(physical_page, &page);
+	page.header.flags &= ~flags;
+
+	_eeprom_emulator_nvm_fill_cache(physical_page, &page);
+	_eeprom_emulator_nvm_commit_cache(physical_page);
+}
+
+/**
+ * \brief Finds the page staged for a logical page in the current transaction.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to look for
+ *
+ * \return Pointer to the staged page, or \c NULL if the page is not part of
+ *         the transaction.
+ */
+static struct _eeprom_page *_eeprom_emulator_transaction_find(
+		const uint16_t logical_page)
+{
+	for (uint8_t c = 0; c < _eeprom_instance.transaction_pages; c++) {
+		if (_eeprom_instance.transaction[c].header.logical_page == logical_page) {
+			return &_eeprom_instance.transaction[c];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Completes a transaction left unfinished by a reset.
+ *
+ * Publishes the pages of the transaction found during the scan of the physical
+ * memory if its commit record was written, or discards them otherwise.
+ */
+static void _eeprom_emulator_recover_transaction(void)
+{
+	uint8_t count = _eeprom_instance.recovery_count;
+
+	if (count == 0) {
+		return;
+	}
+
+	/* Too many pages cannot be the result of a single transaction */
+	if (count > EEPROM_TRANSACTION_PAGES) {
+		_eeprom_instance.recovery_committed = false;
+		count = EEPROM_TRANSACTION_PAGES;
+	}
+
+	for (uint8_t c = 0; c < count; c++) {
+		uint16_t physical_page = _eeprom_instance.recovery_pages[c];
+
+		if (_eeprom_instance.recovery_committed == false) {
+			_eeprom_emulator_clear_page_flags(physical_page,
+					EEPROM_PAGE_FLAG_DISCARDED);
+			continue;
+		}
+
+		/* The commit record must be published last, so that it remains
+		 * until all other pages are published */
+		if ((_eeprom_emulator_page_flags(physical_page) &
+				EEPROM_PAGE_FLAG_COMMIT) == 0) {
+			continue;
+		}
+
+		_eeprom_emulator_clear_page_flags(physical_page,
+				EEPROM_PAGE_FLAG_PUBLISHED);
+	}
+
+	for (uint8_t c = 0; c < count; c++) {
+		uint16_t physical_page = _eeprom_instance.recovery_pages[c];
+
+		if (_eeprom_instance.recovery_committed == false) {
+			continue;
+		}
+
+		if ((_eeprom_emulator_page_flags(physical_page) &
+				EEPROM_PAGE_FLAG_COMMIT) == 0) {
+			_eeprom_emulator_clear_page_flags(physical_page,
+					EEPROM_PAGE_FLAG_PUBLISHED);
+		}
+
+		/* The published page is the newest revision in its row */
+		_eeprom_instance.page_map[_eeprom_emulator_page_header(physical_page)] =
+				physical_page;
+	}
+
+	_eeprom_instance.recovery_count     = 0;
+	_eeprom_instance.recovery_committed = false;
+}
+#endif
+
+#if (EEPROM_PAGE_CRC == true)
+/**
+ * \brief Completes or rolls back a row move interrupted by a reset.
+ *
+ * A row move copies the pages of a row into the spare row before the original
+ * row joins the spare row pool, so a reset part way through leaves the pool
+ * one row short, with no erased spare row if there is a single one. If
+ * the copy was interrupted, the first two pages of the destination row are
+ * not both intact and the destination row is erased again; otherwise every
+ * page of the source row has been superseded by its copy, and the source row
+ * is erased. The page mapping is then rebuilt.
+ */
+static void _eeprom_emulator_repair_rows(void)
+{
+	uint8_t repair_row = EEPROM_INVALID_ROW_NUMBER;
+
+	/* Look for a partially copied destination row */
+	for (uint8_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+		if (_eeprom_emulator_is_spare_row(row) == true) {
+			continue;
+		}
+
+		for (uint8_t c = 0; c < 2; c++) {
+			uint16_t physical_page = (row * NVMCTRL_ROW_PAGES) + c;
+
+			if ((_eeprom_emulator_page_header(physical_page) ==
+					EEPROM_INVALID_PAGE_NUMBER) ||
+					(_eeprom_emulator_page_is_intact(physical_page) == false)) {
+				repair_row = row;
+				break;
+			}
+		}
+
+		if (repair_row != EEPROM_INVALID_ROW_NUMBER) {
+			break;
+		}
+	}
+
+	/* Otherwise, look for a completely copied source row */
+	for (uint8_t row = 0; (row < _eeprom_emulator_data_rows()) &&
+			(repair_row == EEPROM_INVALID_ROW_NUMBER); row++) {
+		bool row_mapped = false;
+
+		if (_eeprom_emulator_is_spare_row(row) == true) {
+			continue;
+		}
+
+		for (uint16_t c = 0; c < _eeprom_emulator_logical_pages(); c++) {
+			if ((_eeprom_instance.page_map[c] / NVMCTRL_ROW_PAGES) == row) {
+				row_mapped = true;
+				break;
+			}
+		}
+
+		if (row_mapped == false) {
+			repair_row = row;
+		}
+	}
+
+	if (repair_row == EEPROM_INVALID_ROW_NUMBER) {
+		return;
+	}
+
+	_eeprom_emulator_nvm_erase_row(repair_row);
+	_eeprom_emulator_update_page_mapping();
+}
+#endif
+
+/**
+ * \brief Fills out the contents of a master page for this emulator.
+ *
+ * \param[out] master_page  Master page contents to fill
+ */
+static void _eeprom_emulator_fill_master_page(
+		struct _eeprom_master_page *const master_page)
+{
+	const uint32_t magic_key[] = EEPROM_MAGIC_KEY;
+
+	memset(master_page, 0xFF, sizeof(*master_page));
+
+	/* Fill out the magic key header to indicate an initialized master page */
+	for (uint8_t c = 0; c < EEPROM_MAGIC_KEY_COUNT; c++) {
+		master_page->magic_key[c] = magic_key[c];
+	}
+
+	/* Update master header with version information of this emulator */
+	master_page->emulator_id   = EEPROM_EMULATOR_ID;
+	master_page->major_version = EEPROM_MAJOR_VERSION;
+	master_page->minor_version = EEPROM_MINOR_VERSION;
+	master_page->revision      = EEPROM_REVISION;
+
+#if (EEPROM_METADATA_ROW == true)
+	/* Record the presence of the metadata row in the layout flags */
+	master_page->layout &= ~EEPROM_LAYOUT_METADATA_ROW;
+#endif
+
+#if (EEPROM_DELTA_RECORDS == true)
+	/* Record the use of delta record pages in the layout flags */
+	master_page->layout &= ~EEPROM_LAYOUT_DELTA_RECORDS;
+#endif
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/* Record the use of transaction page flags in the layout flags */
+	master_page->layout &= ~EEPROM_LAYOUT_TRANSACTIONS;
+#endif
+
+#if (EEPROM_PAGE_CRC == true)
+	/* Record the larger page header in the layout flags */
+	master_page->layout &= ~EEPROM_LAYOUT_PAGE_CRC;
+#endif
+
+#if (EEPROM_WIDE_PAGE_INDEX == true)
+	/* Record the 16-bit page numbers in the layout flags */
+	master_page->layout &= ~EEPROM_LAYOUT_WIDE_PAGE_INDEX;
+#endif
+
+#if (EEPROM_SPARE_ROWS > 1)
+	/* Record the size of the spare row pool */
+	master_page->spare_rows = EEPROM_SPARE_ROWS;
+#endif
+}
+
+/**
+ * \brief Finds the master page in force in the master row.
+ *
+ * \return Physical page number of the master page, which is the page written
+ *         by a completed format migration if there is one.
+ */
+static uint16_t _eeprom_emulator_master_page_number(void)
+{
+#if (EEPROM_FORMAT_MIGRATION == true)
+	struct _eeprom_migration_journal journal;
+
+	_eeprom_emulator_nvm_read_page(EEPROM_MIGRATION_JOURNAL_PAGE_NUMBER,
+			&journal);
+
+	if ((journal.state & EEPROM_MIGRATION_STATE_DONE) == 0) {
+		return EEPROM_MIGRATION_MASTER_PAGE_NUMBER;
+	}
+#endif
+
+	return EEPROM_MASTER_PAGE_NUMBER;
+}
+
+/**
+ * \brief Checks the magic key of a master page.
+ *
+ * \param[in] master_page  Master page to check
+ *
+ * \return Whether the page starts with the magic key of the emulator.
+ */
+static bool _eeprom_emulator_has_magic_key(
+		const struct _eeprom_master_page *const master_page)
+{
+	const uint32_t magic_key[] = EEPROM_MAGIC_KEY;
+
+	for (uint8_t c = 0; c < EEPROM_MAGIC_KEY_COUNT; c++) {
+		if (master_page->magic_key[c] != magic_key[c]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+/**
+ * \brief Checks if a physical row is erased.
+ *
+ * \param[in] row  Physical row to check
+ *
+ * \return Whether every byte of the row is erased.
+ */
+static bool _eeprom_emulator_row_is_erased(
+		const uint8_t row)
+{
+	uint8_t page[NVMCTRL_PAGE_SIZE];
+
+	for (uint8_t c = 0; c < NVMCTRL_ROW_PAGES; c++) {
+		_eeprom_emulator_nvm_read_page((row * NVMCTRL_ROW_PAGES) + c, page);
+
+		for (uint8_t b = 0; b < NVMCTRL_PAGE_SIZE; b++) {
+			if (page[b] != 0xFF) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * \brief Finds the copy of the master page kept while the master row is
+ *        erased.
+ *
+ * The copy is held in the first page of an otherwise erased row below the
+ * master row, behind an erased page header so that page scans of any layout
+ * take it for a free page.
+ *
+ * \param[out] master_page  Master page to fill with the copy, if found
+ *
+ * \return Physical page number of the copy, or \c EEPROM_MASTER_PAGE_NUMBER if
+ *         there is none.
+ */
+static uint16_t _eeprom_emulator_find_master_copy(
+		struct _eeprom_master_page *const master_page)
+{
+	uint8_t page[NVMCTRL_PAGE_SIZE];
+	struct _eeprom_master_page copy;
+
+	for (uint16_t physical_page = 0;
+			physical_page < EEPROM_MASTER_PAGE_NUMBER;
+			physical_page += NVMCTRL_ROW_PAGES) {
+		bool blank = true;
+
+		_eeprom_emulator_nvm_read_page(physical_page, page);
+
+		for (uint8_t b = 0; b < EEPROM_MASTER_COPY_OFFSET; b++) {
+			if (page[b] != 0xFF) {
+				blank = false;
+			}
+		}
+
+		memset(&copy, 0xFF, sizeof(copy));
+		memcpy(&copy, &page[EEPROM_MASTER_COPY_OFFSET],
+				NVMCTRL_PAGE_SIZE - EEPROM_MASTER_COPY_OFFSET);
+
+		if (blank && _eeprom_emulator_has_magic_key(&copy)) {
+			memcpy(master_page, &copy, sizeof(copy));
+			return physical_page;
+		}
+	}
+
+	return EEPROM_MASTER_PAGE_NUMBER;
+}
+
+/**
+ * \brief Keeps a copy of the master page in an erased row.
+ *
+ * A row whose first page holds a copy torn by a reset is used again, by
+ * programming the same contents over it.
+ *
+ * \param[in] master_page  Master page to copy
+ *
+ * \return Physical page number of the copy, or \c EEPROM_MASTER_PAGE_NUMBER if
+ *         no row below the master row is erased.
+ */
+static uint16_t _eeprom_emulator_save_master_copy(
+		const struct _eeprom_master_page *const master_page)
+{
+	uint8_t copy[NVMCTRL_PAGE_SIZE];
+	uint8_t page[NVMCTRL_PAGE_SIZE];
+
+	memset(copy, 0xFF, sizeof(copy));
+	memcpy(&copy[EEPROM_MASTER_COPY_OFFSET], master_page,
+			NVMCTRL_PAGE_SIZE - EEPROM_MASTER_COPY_OFFSET);
+
+	for (uint8_t row = 0;
+			row < ((_eeprom_emulator_physical_pages() / NVMCTRL_ROW_PAGES) - 1);
+			row++) {
+		bool usable = true;
+
+		/* Every bit set in the copy, or in the rest of the row, must still
+		 * be erased */
+		for (uint8_t c = 0; usable && (c < NVMCTRL_ROW_PAGES); c++) {
+			_eeprom_emulator_nvm_read_page((row * NVMCTRL_ROW_PAGES) + c, page);
+
+			for (uint8_t b = 0; b < NVMCTRL_PAGE_SIZE; b++) {
+				uint8_t expected = (c == 0) ? copy[b] : 0xFF;
+
+				if ((page[b] & expected) != expected) {
+					usable = false;
+					break;
+				}
+			}
+		}
+
+		if (usable) {
+			_eeprom_emulator_nvm_fill_cache(row * NVMCTRL_ROW_PAGES, copy);
+			_eeprom_emulator_nvm_commit_cache(row * NVMCTRL_ROW_PAGES);
+
+			return row * NVMCTRL_ROW_PAGES;
+		}
+	}
+
+	return EEPROM_MASTER_PAGE_NUMBER;
+}
+#endif
+
+/**
+ * \brief Reads the master page in force.
+ *
+ * \param[out] master_page  Master page to fill
+ *
+ * \return Physical page number the master page was read from, which is that of
+ *         its copy if a reset interrupted the rewrite of the master row.
+ */
+static uint16_t _eeprom_emulator_read_master_page(
+		struct _eeprom_master_page *const master_page)
+{
+	uint16_t physical_page = _eeprom_emulator_master_page_number();
+
+	_eeprom_emulator_nvm_read_page(physical_page, master_page);
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+	if (_eeprom_emulator_has_magic_key(master_page) == false) {
+		uint16_t copy = _eeprom_emulator_find_master_copy(master_page);
+
+		if (copy != EEPROM_MASTER_PAGE_NUMBER) {
+			return copy;
+		}
+	}
+#endif
+
+	return physical_page;
+}
+
+/**
+ * \brief Create master emulated EEPROM management page.
+ *
+ * Creates a new master page in emulated EEPROM, giving information on the
+ * emulator used to store the EEPROM data.
+ */
+static void _eeprom_emulator_create_master_page(void)
+{
+	struct _eeprom_master_page master_page;
+
+	_eeprom_emulator_fill_master_page(&master_page);
+
+	_eeprom_emulator_nvm_erase_row(
+			EEPROM_MASTER_PAGE_NUMBER / NVMCTRL_ROW_PAGES);
+
+	/* Write the new master page data to physical memory */
+	_eeprom_emulator_nvm_fill_cache(EEPROM_MASTER_PAGE_NUMBER, &master_page);
+	_eeprom_emulator_nvm_commit_cache(EEPROM_MASTER_PAGE_NUMBER);
+}
+
+/**
+ * \brief Verify the contents of a master EEPROM page.
+ *
+ * Verify the contents of a master EEPROM page to ensure that it contains the
+ * correct information for this version of the EEPROM emulation service.
+ *
+ * \retval STATUS_OK              Given master page contents is valid
+ * \retval STATUS_ERR_BAD_FORMAT  Master page contents was invalid
+ * \retval STATUS_ERR_IO          Master page indicates the data is incompatible
+ *                                with this version of the EEPROM emulator
+ */
+static enum status_code _eeprom_emulator_verify_master_page(void)
+{
+	struct _eeprom_master_page master_page;
+
+	/* Copy the master page to the RAM buffer so that it can be inspected */
+	uint16_t physical_page = _eeprom_emulator_read_master_page(&master_page);
+
+	/* Verify magic key is correct in the master page header */
+	if (_eeprom_emulator_has_magic_key(&master_page) == false) {
+		return STATUS_ERR_BAD_FORMAT;
+	}
+
+	/* Verify emulator ID in header to ensure the same scheme is used */
+	if (master_page.emulator_id   != EEPROM_EMULATOR_ID) {
+		return STATUS_ERR_IO;
+	}
+
+	/* Verify major version in header to ensure the same version is used */
+	if (master_page.major_version != EEPROM_MAJOR_VERSION) {
+		return STATUS_ERR_IO;
+	}
+
+	/* Verify minor version in header to ensure the same version is used */
+	if (master_page.minor_version != EEPROM_MINOR_VERSION) {
+		return STATUS_ERR_IO;
+	}
+
+	/* Don't verify revision number - same major/minor is considered enough
+	 * to ensure the stored data is compatible. */
+
+	/* Verify the physical layout flags match the configuration of this
+	 * service */
+	if (((master_page.layout & EEPROM_LAYOUT_METADATA_ROW) == 0) !=
+			(EEPROM_METADATA_ROW == true)) {
+		return STATUS_ERR_IO;
+	}
+
+	if (((master_page.layout & EEPROM_LAYOUT_DELTA_RECORDS) == 0) !=
+			(EEPROM_DELTA_RECORDS == true)) {
+		return STATUS_ERR_IO;
+	}
+
+	if (((master_page.layout & EEPROM_LAYOUT_TRANSACTIONS) == 0) !=
+			(EEPROM_TRANSACTION_PAGES > 0)) {
+		return STATUS_ERR_IO;
+	}
+
+	if (((master_page.layout & EEPROM_LAYOUT_PAGE_CRC) == 0) !=
+			(EEPROM_PAGE_CRC == true)) {
+		return STATUS_ERR_IO;
+	}
+
+	if (((master_page.layout & EEPROM_LAYOUT_WIDE_PAGE_INDEX) == 0) !=
+			(EEPROM_WIDE_PAGE_INDEX == true)) {
+		return STATUS_ERR_IO;
+	}
+
+	/* Verify the size of the spare row pool, which sets the number of logical
+	 * pages */
+	if (((master_page.spare_rows == 0xFF) ? 1 : master_page.spare_rows) !=
+			EEPROM_SPARE_ROWS) {
+		return STATUS_ERR_IO;
+	}
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+	/* A master page only left in its copy is restored by a migration */
+	if ((physical_page / NVMCTRL_ROW_PAGES) !=
+			(EEPROM_MASTER_PAGE_NUMBER / NVMCTRL_ROW_PAGES)) {
+		return STATUS_ERR_IO;
+	}
+#else
+	(void)physical_page;
+#endif
+
+	return STATUS_OK;
+}
+
+
+#if (EEPROM_FORMAT_MIGRATION == true)
+/**
+ * \brief Decodes the physical layout recorded in a master page.
+ *
+ * Each major version of the emulator scheme has its own page header format,
+ * of which the layout flags and the spare row count give the variant.
+ *
+ * \param[in]  master_page  Master page of the memory to migrate
+ * \param[out] layout       Physical layout of the memory to migrate
+ *
+ * \return Whether the memory can be read by the migration.
+ */
+static bool _eeprom_emulator_migration_layout(
+		const struct _eeprom_master_page *const master_page,
+		struct _eeprom_migration_layout *const layout)
+{
+	uint8_t spare_rows =
+			(master_page->spare_rows == 0xFF) ? 1 : master_page->spare_rows;
+	bool wide;
+
+	if ((master_page->emulator_id != EEPROM_EMULATOR_ID) ||
+			(master_page->minor_version > EEPROM_MINOR_VERSION)) {
+		return false;
+	}
+
+	switch (master_page->major_version) {
+	case 1:
+		/* Unknown layout flags may change the page format */
+		if ((uint8_t)~master_page->layout &
+				~(EEPROM_LAYOUT_METADATA_ROW | EEPROM_LAYOUT_DELTA_RECORDS |
+				EEPROM_LAYOUT_TRANSACTIONS | EEPROM_LAYOUT_PAGE_CRC |
+				EEPROM_LAYOUT_WIDE_PAGE_INDEX)) {
+			return false;
+		}
+
+		/* Version 1 page headers hold the logical page number, the page flags
+		 * and the row erase count, followed by the sequence number and the
+		 * CRC of the page if page CRCs are used */
+		wide = ((master_page->layout & EEPROM_LAYOUT_WIDE_PAGE_INDEX) == 0);
+
+		layout->number_size   = wide ? 2 : 1;
+		layout->erases_offset = wide ? 4 : 2;
+		layout->crc           =
+				((master_page->layout & EEPROM_LAYOUT_PAGE_CRC) == 0);
+		layout->header_size   = layout->erases_offset + (layout->crc ? 6 : 2);
+		layout->delta         =
+				((master_page->layout & EEPROM_LAYOUT_DELTA_RECORDS) == 0);
+		layout->transactions  =
+				((master_page->layout & EEPROM_LAYOUT_TRANSACTIONS) == 0);
+		layout->data_rows     =
+				(_eeprom_emulator_physical_pages() / NVMCTRL_ROW_PAGES) - 1 -
+				((master_page->layout & EEPROM_LAYOUT_METADATA_ROW) == 0);
+		break;
+
+	default:
+		return false;
+	}
+
+	if ((layout->data_rows <= spare_rows) ||
+			((spare_rows > 1) && (layout->crc == false))) {
+		return false;
+	}
+
+	layout->logical_pages = (layout->data_rows - spare_rows) * 2;
+
+	return true;
+}
+
+/**
+ * \brief Reads a physical page of memory being migrated.
+ *
+ * \param[in]  layout         Physical layout of the memory to migrate
+ * \param[in]  physical_page  Physical page in EEPROM space to read
+ * \param[out] page           Buffer of \c NVMCTRL_PAGE_SIZE bytes to fill
+ *                            with the page
+ * \param[out] header         Decoded header of the page
+ *
+ * \return Whether the page holds an intact revision of a logical page, which
+ *         is not part of a discarded transaction.
+ */
+static bool _eeprom_emulator_migration_read_header(
+		const struct _eeprom_migration_layout *const layout,
+		const uint16_t physical_page,
+		uint8_t *const page,
+		struct _eeprom_migration_header *const header)
+{
+	uint8_t erases_offset = layout->erases_offset;
+
+	_eeprom_emulator_nvm_read_page(physical_page, page);
+
+	header->logical_page = page[0];
+	if (layout->number_size == 2) {
+		header->logical_page |= (page[1] << 8);
+	}
+
+	header->flags    = page[layout->number_size];
+	header->sequence = page[erases_offset + 2] | (page[erases_offset + 3] << 8);
+
+	/* Free pages hold an invalid logical page number */
+	if (header->logical_page >= layout->logical_pages) {
+		return false;
+	}
+
+	if (layout->crc == true) {
+		uint16_t crc = eeprom_emulator_crc16(0xFFFF, page, layout->number_size);
+
+		/* The row erase count and the sequence number follow each other */
+		crc = eeprom_emulator_crc16(crc, &page[erases_offset], 4);
+
+		if (header->flags & EEPROM_PAGE_FLAG_DELTA) {
+			crc = eeprom_emulator_crc16(crc, &page[layout->header_size],
+					NVMCTRL_PAGE_SIZE - layout->header_size);
+		}
+
+		if (crc != (page[erases_offset + 4] | (page[erases_offset + 5] << 8))) {
+			return false;
+		}
+	}
+
+	return ((layout->transactions == false) ||
+			(header->flags & EEPROM_PAGE_FLAG_DISCARDED));
+}
+
+/**
+ * \brief Finds the newest revision of a logical page within a row of memory
+ *        being migrated.
+ *
+ * \param[in]  layout         Physical layout of the memory to migrate
+ * \param[in]  row            Physical row to search
+ * \param[in]  logical_page   Logical EEPROM page to find
+ * \param[out] physical_page  Physical page holding the newest revision
+ *
+ * \return Whether a revision of the logical page was found in the row.
+ */
+static bool _eeprom_emulator_migration_find_page(
+		const struct _eeprom_migration_layout *const layout,
+		const uint8_t row,
+		const uint16_t logical_page,
+		uint16_t *const physical_page)
+{
+	uint8_t page[NVMCTRL_PAGE_SIZE];
+	struct _eeprom_migration_header header;
+	uint16_t newest_sequence = 0;
+	bool found = false;
+
+	for (uint8_t c = 0; c < NVMCTRL_ROW_PAGES; c++) {
+		uint16_t candidate = (row * NVMCTRL_ROW_PAGES) + c;
+
+		if ((_eeprom_emulator_migration_read_header(layout, candidate, page,
+				&header) == false) || (header.logical_page != logical_page)) {
+			continue;
+		}
+
+		/* Without sequence numbers, later pages of a row are newer */
+		if ((found == false) || (layout->crc == false) ||
+				((int16_t)(header.sequence - newest_sequence) > 0)) {
+			*physical_page  = candidate;
+			newest_sequence = header.sequence;
+			found           = true;
+		}
+	}
+
+	return found;
+}
+
+/**
+ * \brief Reads the newest contents of a logical page from memory being
+ *        migrated.
+ *
+ * \param[in]  layout         Physical layout of the memory to migrate
+ * \param[in]  newest         Physical page holding the newest revision
+ * \param[in]  logical_page   Logical EEPROM page to read
+ * \param[out] data           Buffer of \c NVMCTRL_PAGE_SIZE bytes to fill
+ *                            with the page contents, followed by erased bytes
+ */
+static void _eeprom_emulator_migration_read_page(
+		const struct _eeprom_migration_layout *const layout,
+		const uint16_t newest,
+		const uint16_t logical_page,
+		uint8_t *const data)
+{
+	uint8_t page[NVMCTRL_PAGE_SIZE];
+	struct _eeprom_migration_header header;
+	uint8_t page_size = NVMCTRL_PAGE_SIZE - layout->header_size;
+	uint8_t record_header_size = layout->crc ? 4 : 2;
+	uint16_t row_start = newest - (newest % NVMCTRL_ROW_PAGES);
+	uint16_t base = newest;
+
+	/* Find the newest full revision of the page, as delta records are stored
+	 * after it in the same row */
+	while (layout->delta && (base > row_start)) {
+		if (_eeprom_emulator_migration_read_header(layout, base, page,
+				&header) && (header.logical_page == logical_page) &&
+				(header.flags & EEPROM_PAGE_FLAG_DELTA) &&
+				(header.flags & EEPROM_PAGE_FLAG_DISCARDED)) {
+			break;
+		}
+
+		base--;
+	}
+
+	_eeprom_emulator_nvm_read_page(base, page);
+
+	memset(data, 0xFF, NVMCTRL_PAGE_SIZE);
+	memcpy(data, &page[layout->header_size], page_size);
+
+	/* Replay the delta records stored after it, oldest first */
+	for (uint16_t physical_page = base + 1; physical_page <= newest;
+			physical_page++) {
+		if ((_eeprom_emulator_migration_read_header(layout, physical_page,
+				page, &header) == false) ||
+				(header.logical_page != logical_page) ||
+				(header.flags & EEPROM_PAGE_FLAG_DELTA)) {
+			continue;
+		}
+
+		for (uint8_t c = layout->header_size;
+				(c + record_header_size) < NVMCTRL_PAGE_SIZE;) {
+			uint8_t offset = page[c];
+			uint8_t length = page[c + 1];
+
+			/* Stop at the first free or incomplete record */
+			if ((offset >= page_size) || (length == 0) ||
+					((offset + length) > page_size) ||
+					((c + record_header_size + length) > NVMCTRL_PAGE_SIZE)) {
+				break;
+			}
+
+			if ((layout->crc == true) &&
+					(eeprom_emulator_crc16(eeprom_emulator_crc16(0xFFFF,
+						&page[c], 2), &page[c + 4], length) !=
+					(page[c + 2] | (page[c + 3] << 8)))) {
+				break;
+			}
+
+			memcpy(&data[offset], &page[c + record_header_size], length);
+			c += record_header_size + length;
+		}
+	}
+}
+
+/**
+ * \brief Checks if a row was free when a format migration started.
+ *
+ * \param[in] plan  Format migration in progress
+ * \param[in] row   Physical row to check
+ *
+ * \return Whether the row held no current logical page.
+ */
+static inline bool _eeprom_emulator_migration_row_is_free(
+		const struct _eeprom_migration_plan *const plan,
+		const uint8_t row)
+{
+	return ((plan->journal.free_rows[row / 8] & (1 << (row % 8))) == 0);
+}
+
+/**
+ * \brief Works out the rows of a step of a format migration.
+ *
+ * The first steps rewrite the source rows, which held current logical pages
+ * when the migration started, in ascending order; the next ones write blank
+ * pages for the logical pages added by the new layout, two per row. Each step
+ * writes into the next row of a queue made of the rows that were free when
+ * the migration started, followed by the source rows below the end of the
+ * new data rows, in the order they were rewritten.
+ *
+ * \param[in]  plan         Format migration in progress
+ * \param[in]  step         Index of the step
+ * \param[out] source       Source row of the step, or an invalid row number if
+ *                          the step writes blank pages
+ * \param[out] destination  Destination row of the step
+ *
+ * \return Whether the destination row is free when the step starts.
+ */
+static bool _eeprom_emulator_migration_step_rows(
+		const struct _eeprom_migration_plan *const plan,
+		const uint8_t step,
+		uint8_t *const source,
+		uint8_t *const destination)
+{
+	uint8_t index = step;
+	uint8_t source_count = 0;
+
+	*source = EEPROM_INVALID_ROW_NUMBER;
+
+	for (uint8_t row = 0; row < plan->layout.data_rows; row++) {
+		if (_eeprom_emulator_migration_row_is_free(plan, row) == false) {
+			if (source_count++ == step) {
+				*source = row;
+			}
+		}
+	}
+
+	for (uint8_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+		if (_eeprom_emulator_migration_row_is_free(plan, row) &&
+				(index-- == 0)) {
+			*destination = row;
+			return true;
+		}
+	}
+
+	source_count = 0;
+
+	for (uint8_t row = 0; row < plan->layout.data_rows; row++) {
+		if (_eeprom_emulator_migration_row_is_free(plan, row)) {
+			continue;
+		}
+
+		/* Source rows are only free once they have been rewritten */
+		if (source_count++ >= step) {
+			break;
+		}
+
+		if ((row < _eeprom_emulator_data_rows()) && (index-- == 0)) {
+			*destination = row;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * \brief Counts the rows and steps of a format migration.
+ *
+ * \param[in,out] plan  Format migration to count the steps of
+ */
+static void _eeprom_emulator_migration_count_steps(
+		struct _eeprom_migration_plan *const plan)
+{
+	uint16_t logical_pages = _eeprom_emulator_logical_pages();
+
+	plan->source_rows = 0;
+
+	for (uint8_t row = 0; row < plan->layout.data_rows; row++) {
+		if (_eeprom_emulator_migration_row_is_free(plan, row) == false) {
+			plan->source_rows++;
+		}
+	}
+
+	plan->steps = plan->source_rows;
+
+	if (logical_pages > plan->layout.logical_pages) {
+		plan->steps += (logical_pages - plan->layout.logical_pages + 1) / 2;
+	}
+}
+
+/**
+ * \brief Checks that memory can be migrated, and finds its source rows.
+ *
+ * Maps each logical page carried over to the new layout to its newest
+ * revision, as the old layout would, using the page map as scratch space. The
+ * migration is refused if a logical page is missing, if a transaction was
+ * left unfinished, if the dropped logical pages or page bytes are not erased,
+ * if a row holds both current pages and stale copies of pages stored
+ * elsewhere, or if there are not enough free rows.
+ *
+ * \param[in,out] plan  Format migration to prepare, whose journal is filled
+ *                      with the free rows
+ *
+ * \return Whether the memory can be migrated.
+ */
+static bool _eeprom_emulator_migration_prepare(
+		struct _eeprom_migration_plan *const plan)
+{
+	const struct _eeprom_migration_layout *layout = &plan->layout;
+	uint8_t page[NVMCTRL_PAGE_SIZE];
+	uint8_t data[NVMCTRL_PAGE_SIZE];
+	struct _eeprom_migration_header header;
+	struct _eeprom_migration_header mapped_header;
+	uint8_t page_size = NVMCTRL_PAGE_SIZE - layout->header_size;
+
+	memset(_eeprom_instance.page_map, EEPROM_INVALID_PAGE_NUMBER,
+			sizeof(_eeprom_instance.page_map));
+
+	for (uint16_t physical_page = 0;
+			physical_page < (layout->data_rows * NVMCTRL_ROW_PAGES);
+			physical_page++) {
+		if (_eeprom_emulator_migration_read_header(layout, physical_page,
+				page, &header) == false) {
+			continue;
+		}
+
+		if (layout->transactions &&
+				((header.flags & EEPROM_PAGE_FLAG_STAGED) == 0) &&
+				(header.flags & EEPROM_PAGE_FLAG_PUBLISHED)) {
+			return false;
+		}
+
+		if (header.logical_page >= plan->kept_pages) {
+			continue;
+		}
+
+		uint16_t mapped = _eeprom_instance.page_map[header.logical_page];
+
+		if ((mapped != EEPROM_INVALID_PAGE_NUMBER) && (layout->crc == true)) {
+			_eeprom_emulator_migration_read_header(layout, mapped, page,
+					&mapped_header);
+
+			if ((int16_t)(header.sequence - mapped_header.sequence) <= 0) {
+				continue;
+			}
+		}
+
+		_eeprom_instance.page_map[header.logical_page] = physical_page;
+	}
+
+	for (uint16_t c = 0; c < plan->kept_pages; c++) {
+		if (_eeprom_instance.page_map[c] == EEPROM_INVALID_PAGE_NUMBER) {
+			return false;
+		}
+	}
+
+	for (uint8_t row = 0;
+			row < ((_eeprom_emulator_physical_pages() / NVMCTRL_ROW_PAGES) - 1);
+			row++) {
+		bool current = false;
+		bool stale   = false;
+
+		for (uint8_t c = 0; (row < layout->data_rows) &&
+				(c < NVMCTRL_ROW_PAGES); c++) {
+			uint16_t physical_page = (row * NVMCTRL_ROW_PAGES) + c;
+			uint16_t mapped;
+
+			if (_eeprom_emulator_migration_read_header(layout, physical_page,
+					page, &header) == false) {
+				continue;
+			}
+
+			if (header.logical_page >= plan->kept_pages) {
+				/* Logical pages dropped by the new layout must be blank */
+				_eeprom_emulator_migration_find_page(layout, row,
+						header.logical_page, &physical_page);
+				_eeprom_emulator_migration_read_page(layout, physical_page,
+						header.logical_page, data);
+
+				for (uint8_t b = 0; b < page_size; b++) {
+					if (data[b] != 0xFF) {
+						return false;
+					}
+				}
+
+				continue;
+			}
+
+			mapped = _eeprom_instance.page_map[header.logical_page];
+
+			if (mapped == physical_page) {
+				current = true;
+
+				/* Bytes dropped by a smaller page size must be blank */
+				_eeprom_emulator_migration_read_page(layout, physical_page,
+						header.logical_page, data);
+
+				for (uint8_t b = EEPROM_PAGE_SIZE; b < page_size; b++) {
+					if (data[b] != 0xFF) {
+						return false;
+					}
+				}
+			} else if ((mapped / NVMCTRL_ROW_PAGES) != row) {
+				stale = true;
+			}
+		}
+
+		if (current && stale) {
+			return false;
+		}
+
+		if (current == false) {
+			plan->journal.free_rows[row / 8] &= ~(1 << (row % 8));
+		}
+	}
+
+	_eeprom_emulator_migration_count_steps(plan);
+
+	/* Every step needs a free row, and the spare rows must be left over */
+	if (plan->steps >
+			(_eeprom_emulator_data_rows() - EEPROM_SPARE_ROWS)) {
+		return false;
+	}
+
+	for (uint8_t step = 0; step < plan->steps; step++) {
+		uint8_t source;
+		uint8_t destination;
+
+		if (_eeprom_emulator_migration_step_rows(plan, step, &source,
+				&destination) == false) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * \brief Programs a page of the master row with the format migration state.
+ *
+ * The page may have been programmed before, with the same contents or with
+ * fewer bits cleared.
+ *
+ * \param[in] physical_page  Physical page of the master row to program
+ * \param[in] data           Contents to program
+ */
+static void _eeprom_emulator_migration_program(
+		const uint16_t physical_page,
+		const void *const data)
+{
+	_eeprom_emulator_nvm_fill_cache(physical_page, data);
+	_eeprom_emulator_nvm_commit_cache(physical_page);
+}
+
+/**
+ * \brief Rewrites a row of memory being migrated in the new layout.
+ *
+ * Erases the source row of the previous step, whose pages have all been
+ * rewritten, and the destination row, then writes the newest revision of each
+ * logical page of the source row, or blank pages, and records the step as
+ * done. A step interrupted by a reset is simply done again.
+ *
+ * \param[in] plan  Format migration in progress
+ * \param[in] step  Index of the step to do
+ */
+static void _eeprom_emulator_migration_step(
+		const struct _eeprom_migration_plan *const plan,
+		const uint8_t step)
+{
+	const struct _eeprom_migration_layout *layout = &plan->layout;
+	uint8_t buffer[NVMCTRL_PAGE_SIZE];
+	struct _eeprom_migration_header header;
+	struct _eeprom_page page;
+	uint8_t source;
+	uint8_t destination;
+	uint8_t previous_source;
+	uint8_t previous_destination;
+	uint16_t physical_page;
+
+	_eeprom_emulator_migration_step_rows(plan, step, &source, &destination);
+
+	if (step > 0) {
+		_eeprom_emulator_migration_step_rows(plan, step - 1,
+				&previous_source, &previous_destination);
+
+		if ((previous_source != EEPROM_INVALID_ROW_NUMBER) &&
+				(previous_source != destination)) {
+			_eeprom_emulator_nvm_erase_row(previous_source);
+		}
+	}
+
+	_eeprom_emulator_nvm_erase_row(destination);
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+	/* Erase counts are not carried over from the old page headers */
+	memset(_eeprom_instance.erased_rows, EEPROM_INVALID_ROW_NUMBER,
+			sizeof(_eeprom_instance.erased_rows));
+#endif
+
+	physical_page = destination * NVMCTRL_ROW_PAGES;
+
+	for (uint8_t c = 0; c < NVMCTRL_ROW_PAGES; c++) {
+		uint16_t logical_page;
+		uint16_t newest;
+
+		memset(&page, 0xFF, sizeof(page));
+
+		if (source != EEPROM_INVALID_ROW_NUMBER) {
+			uint16_t candidate = (source * NVMCTRL_ROW_PAGES) + c;
+
+			/* Copy each logical page of the row once, from its newest
+			 * revision */
+			if ((_eeprom_emulator_migration_read_header(layout, candidate,
+					buffer, &header) == false) ||
+					(header.logical_page >= plan->kept_pages) ||
+					(_eeprom_emulator_migration_find_page(layout, source,
+						header.logical_page, &newest) == false) ||
+					(newest != candidate)) {
+				continue;
+			}
+
+			logical_page = header.logical_page;
+
+			_eeprom_emulator_migration_read_page(layout, newest,
+					logical_page, buffer);
+			memcpy(page.data, buffer, EEPROM_PAGE_SIZE);
+		} else {
+			/* Blank pages for the logical pages added by the new layout */
+			logical_page = layout->logical_pages +
+					((step - plan->source_rows) * 2) + c;
+
+			if ((c >= 2) ||
+					(logical_page >= _eeprom_emulator_logical_pages())) {
+				break;
+			}
+		}
+
+		page.header.logical_page = logical_page;
+		_eeprom_emulator_nvm_write_page(physical_page++, &page);
+	}
+
+	/* Record the step as done */
+	_eeprom_emulator_nvm_read_page(EEPROM_MIGRATION_PROGRESS_PAGE_NUMBER,
+			buffer);
+	buffer[step / 8] &= ~(1 << (step % 8));
+	_eeprom_emulator_migration_program(EEPROM_MIGRATION_PROGRESS_PAGE_NUMBER,
+			buffer);
+}
+
+/**
+ * \brief Completes a format migration.
+ *
+ * Erases the rows that received no data, including the last source row, the
+ * old spare rows and the metadata rows, and makes the new master page the one
+ * in force.
+ *
+ * \param[in,out] plan  Format migration in progress
+ */
+static void _eeprom_emulator_migration_finish(
+		struct _eeprom_migration_plan *const plan)
+{
+	uint8_t used_rows[32];
+	struct _eeprom_master_page master_page;
+
+	memset(used_rows, 0, sizeof(used_rows));
+
+	for (uint8_t step = 0; step < plan->steps; step++) {
+		uint8_t source;
+		uint8_t destination;
+
+		_eeprom_emulator_migration_step_rows(plan, step, &source,
+				&destination);
+		used_rows[destination / 8] |= (1 << (destination % 8));
+	}
+
+	for (uint8_t row = 0;
+			row < ((_eeprom_emulator_physical_pages() / NVMCTRL_ROW_PAGES) - 1);
+			row++) {
+		if (used_rows[row / 8] & (1 << (row % 8))) {
+			continue;
+		}
+
+		if (_eeprom_emulator_row_is_erased(row) == false) {
+			_eeprom_emulator_nvm_erase_row(row);
+		}
+	}
+
+	_eeprom_emulator_fill_master_page(&master_page);
+	_eeprom_emulator_migration_program(EEPROM_MIGRATION_MASTER_PAGE_NUMBER,
+			&master_page);
+
+	plan->journal.state &= ~EEPROM_MIGRATION_STATE_DONE;
+	_eeprom_emulator_migration_program(EEPROM_MIGRATION_JOURNAL_PAGE_NUMBER,
+			&plan->journal);
+}
+#endif
+
+/**
+ * \brief Retrieves the parameters of the EEPROM Emulator memory layout.
+ *
+ * Retrieves the configuration parameters of the EEPROM Emulator, after it has
+ * been initialized.
+ *
+ * \param[out] parameters  EEPROM Emulator parameter struct to fill
+ *
+ * \return Status of the operation.
+ *
+ * \retval STATUS_OK                    If the emulator parameters were retrieved
+ *                                      successfully
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM Emulator is not initialized
+ */
+enum status_code eeprom_emulator_get_parameters(
+	struct eeprom_emulator_parameters *const parameters)
+{
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	parameters->page_size              = EEPROM_PAGE_SIZE;
+	parameters->eeprom_number_of_pages = _eeprom_emulator_logical_pages();
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Retrieves the usage statistics of the EEPROM Emulator.
+ *
+ * Retrieves the counters kept by the EEPROM Emulator since it was last
+ * initialized.
+ *
+ * \param[out] statistics  EEPROM Emulator statistics struct to fill
+ *
+ * \return Status of the operation.
+ *
+ * \retval STATUS_OK                    If the statistics were retrieved
+ *                                      successfully
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM Emulator is not initialized
+ */
+enum status_code eeprom_emulator_get_statistics(
+	struct eeprom_emulator_statistics *const statistics)
+{
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	*statistics = _eeprom_instance.statistics;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Initializes the EEPROM Emulator service.
+ *
+ * Initializes the emulated EEPROM memory space; if the emulated EEPROM memory
+ * has not been previously initialized, it will need to be explicitly formatted
+ * via \ref eeprom_emulator_erase_memory(). The EEPROM memory space will \b not
+ * be automatically erased by the initialization function, so that partial data
+ * may be recovered by the user application manually if the service is unable to
+ * initialize successfully.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK              EEPROM emulation service was successfully
+ *                                initialized
+ * \retval STATUS_ERR_NO_MEMORY   No EEPROM section has been allocated in the
+ *                                device
+ * \retval STATUS_ERR_BAD_FORMAT  Emulated EEPROM memory is corrupt or not
+ *                                formatted
+ * \retval STATUS_ERR_IO          EEPROM data is incompatible with this version
+ *                                or scheme of the EEPROM emulator, and may be
+ *                                migrated by \ref eeprom_emulator_migrate()
+ */
+enum status_code eeprom_emulator_init(void)
+{
+	enum status_code error_code = STATUS_OK;
+	struct nvm_config config;
+	struct nvm_parameters parameters;
+
+	/* Retrieve the NVM controller configuration - enable manual page writing
+	 * mode so that the emulator has exclusive control over page writes to
+	 * allow for caching */
+	nvm_get_config_defaults(&config);
+	config.manual_page_write = true;
+
+	/* Apply new NVM configuration */
+	do {
+		error_code = nvm_set_config(&config);
+	} while (error_code == STATUS_BUSY);
+
+	/* Get the NVM controller configuration parameters */
+	nvm_get_parameters(&parameters);
+
+	_eeprom_instance.initialized = false;
+#if (EEPROM_FORMAT_MIGRATION == true)
+	_eeprom_instance.migration_pending = false;
+#endif
+
+	/* Ensure the device fuses are configured for at least one master page row,
+	 * one user EEPROM data row and the spare rows (plus the metadata row, if
+	 * enabled) */
+	if (parameters.eeprom_number_of_pages <
+			((2 + EEPROM_SPARE_ROWS + (EEPROM_METADATA_ROW == true)) *
+			NVMCTRL_ROW_PAGES)) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	/* Ensure every physical page can be numbered in the page map */
+	if (parameters.eeprom_number_of_pages > EEPROM_MAX_PAGES) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	/* Configure the EEPROM instance physical and logical number of pages:
+	 *  - One row is reserved for the master page
+	 *  - One row is reserved for the metadata, if enabled
+	 *  - Rows are reserved for the spare rows
+	 *  - Two logical pages can be stored in one physical row
+	 */
+#if (EEPROM_PHYSICAL_PAGES > 0)
+	/* The geometry is fixed at build time, and must match the fuses */
+	if (parameters.eeprom_number_of_pages != EEPROM_PHYSICAL_PAGES) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+#else
+	_eeprom_instance.physical_pages =
+			parameters.eeprom_number_of_pages;
+	_eeprom_instance.data_rows      =
+			(parameters.eeprom_number_of_pages / NVMCTRL_ROW_PAGES) - 1 -
+			(EEPROM_METADATA_ROW == true);
+	_eeprom_instance.logical_pages  =
+			(_eeprom_instance.data_rows - EEPROM_SPARE_ROWS) * 2;
+#endif
+
+	/* Configure the EEPROM instance starting physical address in FLASH and
+	 * pre-compute the index of the first page in FLASH used for EEPROM */
+	_eeprom_instance.flash_address =
+			(FLASH_SIZE -
+			((uint32_t)_eeprom_emulator_physical_pages() * NVMCTRL_PAGE_SIZE));
+	_eeprom_instance.flash =
+			EEPROM_NVM_POINTER(_eeprom_instance.flash_address);
+
+#if (EEPROM_WEAR_LEVELING_THRESHOLD > 0)
+	/* The erase counts of the erased rows are not known until their next
+	 * use */
+	memset(_eeprom_instance.erased_rows, EEPROM_INVALID_ROW_NUMBER,
+			sizeof(_eeprom_instance.erased_rows));
+#endif
+
+	/* Clear EEPROM page write cache on initialization */
+	for (uint8_t c = 0; c < EEPROM_CACHE_ENTRIES; c++) {
+		_eeprom_instance.cache[c].active = false;
+	}
+
+	/* The memory may have been changed or recovered since pages were read */
+	_eeprom_emulator_read_cache_clear();
+
+	_eeprom_instance.move_row = EEPROM_INVALID_ROW_NUMBER;
+
+	memset(&_eeprom_instance.statistics, 0,
+			sizeof(_eeprom_instance.statistics));
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/* Discard any transaction staged before initialization */
+	_eeprom_instance.transaction_active = false;
+	_eeprom_instance.transaction_pages  = 0;
+	_eeprom_instance.recovery_count     = 0;
+	_eeprom_instance.recovery_committed = false;
+#endif
+
+#if (EEPROM_METADATA_ROW == true)
+	/* Restore the logical to physical page mapping table from the newest
+	 * checkpoint, falling back to a full scan of the physical memory */
+	bool checkpoint_valid = _eeprom_emulator_load_checkpoint();
+
+	if (checkpoint_valid == false) {
+		_eeprom_emulator_update_page_mapping();
+	}
+#else
+	/* Scan physical memory and re-create logical to physical page mapping
+	 * table to locate logical pages of EEPROM data in physical FLASH */
+	_eeprom_emulator_update_page_mapping();
+#endif
+
+	/* Verify that the master page contains valid data for this service */
+	error_code = _eeprom_emulator_verify_master_page();
+	if (error_code != STATUS_OK) {
+#if (EEPROM_FORMAT_MIGRATION == true)
+		/* Data written with another layout may still be migrated */
+		_eeprom_instance.migration_pending = (error_code == STATUS_ERR_IO);
+#endif
+		return error_code;
+	}
+
+#if (EEPROM_PAGE_CRC == true)
+	/* Finish or roll back a row move interrupted by a reset */
+	if (_eeprom_instance.spare_rows[EEPROM_SPARE_ROWS - 1] ==
+			EEPROM_INVALID_ROW_NUMBER) {
+		_eeprom_emulator_repair_rows();
+	}
+#endif
+
+#if (EEPROM_SPARE_ROWS > 1)
+	/* Erase a row of the pool if none of them was erased before the reset */
+	if ((_eeprom_instance.spare_row == EEPROM_INVALID_ROW_NUMBER) &&
+			(_eeprom_emulator_erase_spare_begin() == true)) {
+		while (_eeprom_instance.move_row != EEPROM_INVALID_ROW_NUMBER) {
+			_eeprom_emulator_move_step();
+		}
+	}
+#endif
+
+	/* Could not find the spare rows - abort as the memory appears to be
+	 * corrupt */
+	if ((_eeprom_instance.spare_row == EEPROM_INVALID_ROW_NUMBER) ||
+			(_eeprom_instance.spare_rows[EEPROM_SPARE_ROWS - 1] ==
+				EEPROM_INVALID_ROW_NUMBER)) {
+		return STATUS_ERR_BAD_FORMAT;
+	}
+
+	/* Every logical page must have an intact revision somewhere in memory */
+	for (uint16_t c = 0; c < _eeprom_emulator_logical_pages(); c++) {
+		if (_eeprom_instance.page_map[c] == EEPROM_INVALID_PAGE_NUMBER) {
+			return STATUS_ERR_BAD_FORMAT;
+		}
+	}
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/* Finish or roll back a transaction interrupted by a reset */
+	_eeprom_emulator_recover_transaction();
+#endif
+
+#if (EEPROM_METADATA_ROW == true)
+	/* Take a new checkpoint so that the next initialization is fast */
+	if (checkpoint_valid == false) {
+		_eeprom_emulator_write_checkpoint();
+	}
+#endif
+
+	/* Mark initialization as complete */
+	_eeprom_instance.initialized = true;
+	_eeprom_instance.view_generation++;
+
+	return error_code;
+}
+
+/**
+ * \brief Erases the entire emulated EEPROM memory space.
+ *
+ * Erases and re-initializes the emulated EEPROM memory space, destroying any
+ * existing data.
+ */
+void eeprom_emulator_erase_memory(void)
+{
+	/* Abandon any row move in progress, as its source row is erased */
+	_eeprom_instance.move_row = EEPROM_INVALID_ROW_NUMBER;
+
+	/* Every page is blank from now on */
+	_eeprom_emulator_read_cache_clear();
+
+	/* Create new EEPROM memory block in EEPROM emulation section */
+	_eeprom_emulator_format_memory();
+
+	/* Write EEPROM emulation master block */
+	_eeprom_emulator_create_master_page();
+
+	/* Map the newly created EEPROM memory block */
+	_eeprom_emulator_update_page_mapping();
+}
+
+/**
+ * \brief Writes a page of data to an emulated EEPROM memory page.
+ *
+ * Writes an emulated EEPROM page of data to the emulated EEPROM memory space.
+ * Writes that would leave the page contents unchanged are skipped, and counted
+ * in the emulator statistics.
+ *
+ * \note Data stored in pages may be cached in volatile RAM memory; to commit
+ *       any cached data to physical non-volatile memory, the
+ *       \ref eeprom_emulator_commit_page_buffer() function should be called.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to write to
+ * \param[in] data          Pointer to the data buffer containing source data to
+ *                          write
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the page was successfully read
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ */
+enum status_code eeprom_emulator_write_page(
+		const uint16_t logical_page,
+		const uint8_t *const data)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Make sure the write address is within the allowable address space */
+	if (logical_page >= _eeprom_emulator_logical_pages()) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	/* Finish any row move started by an asynchronous write first */
+	_eeprom_emulator_move_complete();
+
+	/* Check if the page is already cached, in which case only the cached
+	 * contents need updating */
+	struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_find(logical_page);
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/* Stage the page in the current transaction, if there is one */
+	if (_eeprom_instance.transaction_active == true) {
+		struct _eeprom_page *staged =
+				_eeprom_emulator_transaction_find(logical_page);
+
+		if (staged == NULL) {
+			/* Skip writes that would not change the current page contents */
+			if (((entry != NULL) &&
+					(memcmp(entry->page.data, data, EEPROM_PAGE_SIZE) == 0)) ||
+					((entry == NULL) &&
+					(_eeprom_emulator_page_matches(logical_page, data) == true))) {
+				_eeprom_instance.statistics.elided_writes++;
+				return STATUS_OK;
+			}
+
+			if (_eeprom_instance.transaction_pages >= EEPROM_TRANSACTION_PAGES) {
+				return STATUS_ERR_NO_MEMORY;
+			}
+
+			staged = &_eeprom_instance.transaction[
+					_eeprom_instance.transaction_pages++];
+
+			memset(&staged->header, 0xFF, sizeof(staged->header));
+			staged->header.logical_page = logical_page;
+		}
+
+		_eeprom_instance.view_generation++;
+		_eeprom_emulator_read_cache_invalidate(logical_page);
+		memcpy(staged->data, data, EEPROM_PAGE_SIZE);
+		return STATUS_OK;
+	}
+#endif
+
+	/* Skip writes that would not change the current page contents */
+	if ((entry != NULL) &&
+			(memcmp(entry->page.data, data, EEPROM_PAGE_SIZE) == 0)) {
+		_eeprom_instance.statistics.elided_writes++;
+		return STATUS_OK;
+	}
+
+	/* If the new data matches the page in physical memory, nothing needs to be
+	 * written; drop any pending cached revision as it is now out of date */
+	if (_eeprom_emulator_page_matches(logical_page, data) == true) {
+		if (entry != NULL) {
+			entry->active = false;
+			_eeprom_instance.view_generation++;
+		}
+
+		_eeprom_instance.statistics.elided_writes++;
+		return STATUS_OK;
+	}
+
+	/* The page contents change from here on */
+	_eeprom_instance.view_generation++;
+	_eeprom_emulator_read_cache_invalidate(logical_page);
+
+	if (entry == NULL) {
+		/* Get a free cache entry, committing the least recently used cached
+		 * page to non-volatile memory if needed */
+		entry = _eeprom_emulator_cache_allocate();
+
+		/* Check if the current page location's physical row still has a free
+		 * page for the new version once all the other cached pages of the row
+		 * are written, and if not swap it out with a spare row right away */
+		uint8_t row = _eeprom_instance.page_map[logical_page] / NVMCTRL_ROW_PAGES;
+
+		if (((_eeprom_instance.row_fill[row] +
+				_eeprom_emulator_cache_pending_on_row(row)) >= NVMCTRL_ROW_PAGES) &&
+				(_eeprom_emulator_delta_fits(logical_page, data) == false)) {
+			/* Move the other page we aren't writing that is stored in the same
+			 * page to the new row, and replace the old current page with the
+			 * new page contents */
+			return _eeprom_emulator_move_data_to_spare(row, logical_page, data);
+		}
+
+		/* Set up the page cache header section with the new page header */
+		entry->page.header.logical_page = logical_page;
+		entry->page.header.flags        = 0xFF;
+		entry->page.header.row_erases   = EEPROM_UNKNOWN_ERASE_COUNT;
+	}
+
+	/* Update the page cache contents with the new data */
+	memcpy(entry->page.data, data, EEPROM_PAGE_SIZE);
+
+	/* Update the cache parameters and mark the entry as active */
+	entry->last_use = ++_eeprom_instance.cache_clock;
+	barrier(); // Enforce ordering to prevent incorrect cache state
+	entry->active   = true;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Writes a page of data to an emulated EEPROM memory page without
+ *        waiting for the NVM controller.
+ *
+ * Stores the new page contents in the write cache and returns straight away;
+ * the page is written to physical memory, one NVM operation at a time, by
+ * subsequent calls to \ref eeprom_emulator_poll(). Writes that would leave the
+ * page contents unchanged are skipped, and counted in the emulator statistics.
+ *
+ * Writes made while a transaction is in progress are staged in the
+ * transaction as with \ref eeprom_emulator_write_page().
+ *
+ * \param[in] logical_page  Logical EEPROM page number to write to
+ * \param[in] data          Pointer to the data buffer containing source data to
+ *                          write
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the page was stored in the cache
+ * \retval STATUS_BUSY                  If no cache entry is free for the page,
+ *                                      or its previous contents are still being
+ *                                      written; the write should be retried
+ *                                      after \ref eeprom_emulator_poll()
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ */
+enum status_code eeprom_emulator_write_page_async(
+		const uint16_t logical_page,
+		const uint8_t *const data)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Make sure the write address is within the allowable address space */
+	if (logical_page >= _eeprom_emulator_logical_pages()) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/* Staging a page in a transaction only involves SRAM */
+	if (_eeprom_instance.transaction_active == true) {
+		return eeprom_emulator_write_page(logical_page, data);
+	}
+#endif
+
+	struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_find(logical_page);
+
+	/* The cached contents of a page being written by a row move must not
+	 * change until the move completes */
+	if ((entry != NULL) && (entry == _eeprom_instance.move_entry) &&
+			(_eeprom_instance.move_row != EEPROM_INVALID_ROW_NUMBER)) {
+		return STATUS_BUSY;
+	}
+
+	/* Skip writes that would not change the current page contents */
+	if ((entry != NULL) &&
+			(memcmp(entry->page.data, data, EEPROM_PAGE_SIZE) == 0)) {
+		_eeprom_instance.statistics.elided_writes++;
+		return STATUS_OK;
+	}
+
+	/* The physical memory can only be compared against while it is readable
+	 * without stalling on an NVM operation in progress */
+	if ((nvm_is_ready() == true) &&
+			(_eeprom_emulator_page_matches(logical_page, data) == true)) {
+		if (entry != NULL) {
+			entry->active = false;
+			_eeprom_instance.view_generation++;
+		}
+
+		_eeprom_instance.statistics.elided_writes++;
+		return STATUS_OK;
+	}
+
+	/* The page contents change from here on */
+	_eeprom_instance.view_generation++;
+	_eeprom_emulator_read_cache_invalidate(logical_page);
+
+	if (entry == NULL) {
+		/* Only a free cache entry can be used, as committing another cached
+		 * page would mean waiting for the NVM controller */
+		for (uint8_t c = 0; c < EEPROM_CACHE_ENTRIES; c++) {
+			if (_eeprom_instance.cache[c].active == false) {
+				entry = &_eeprom_instance.cache[c];
+				break;
+			}
+		}
+
+		if (entry == NULL) {
+			return STATUS_BUSY;
+		}
+
+		/* Set up the page cache header section with the new page header */
+		entry->page.header.logical_page = logical_page;
+		entry->page.header.flags        = 0xFF;
+		entry->page.header.row_erases   = EEPROM_UNKNOWN_ERASE_COUNT;
+	}
+
+	/* Update the page cache contents with the new data */
+	memcpy(entry->page.data, data, EEPROM_PAGE_SIZE);
+
+	/* Update the cache parameters and mark the entry as active */
+	entry->last_use = ++_eeprom_instance.cache_clock;
+	barrier(); // Enforce ordering to prevent incorrect cache state
+	entry->active   = true;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Reads a page of data from an emulated EEPROM memory page.
+ *
+ * Reads an emulated EEPROM page of data from the emulated EEPROM memory space.
+ *
+ * \param[in]  logical_page  Logical EEPROM page number to read from
+ * \param[out] data          Pointer to the destination data buffer to fill
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the page was successfully read
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ */
+enum status_code eeprom_emulator_read_page(
+		const uint16_t logical_page,
+		uint8_t *const data)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Make sure the read address is within the allowable address space */
+	if (logical_page >= _eeprom_emulator_logical_pages()) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	/* Check if the page to read is currently cached (and potentially out of
+	 * sync/newer than the physical memory) */
+	struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_find(logical_page);
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/* Pages staged in the current transaction are newer than any other copy */
+	struct _eeprom_page *staged = _eeprom_emulator_transaction_find(logical_page);
+
+	if (staged != NULL) {
+		memcpy(data, staged->data, EEPROM_PAGE_SIZE);
+		return STATUS_OK;
+	}
+#endif
+
+	if (entry != NULL) {
+		/* Copy the potentially newer cached data into the user buffer */
+		memcpy(data, entry->page.data, EEPROM_PAGE_SIZE);
+	} else {
+#if (EEPROM_READ_CACHE_ENTRIES > 0)
+		_eeprom_emulator_read_cache_read(logical_page, data);
+#else
+		struct _eeprom_page temp;
+
+		/* Copy the data from non-volatile memory into the temporary buffer */
+		_eeprom_emulator_read_logical_page(logical_page, &temp);
+
+		/* Copy the data portion of the read page to the user's buffer */
+		memcpy(data, temp.data, EEPROM_PAGE_SIZE);
+#endif
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Maps an emulated EEPROM memory page for reading without a copy.
+ *
+ * Points a page view at the current contents of an emulated EEPROM page,
+ * which are read in place from the memory mapped physical memory, or from the
+ * page cache if they have not been committed yet. Pages stored as delta
+ * records are spread over several physical pages and cannot be mapped; they
+ * must be read with \ref eeprom_emulator_read_page() instead.
+ *
+ * The view stays valid until the next page write, transaction abort or row
+ * erase, any of which may change or move the mapped data; this is checked
+ * with \ref eeprom_emulator_page_view_is_valid().
+ *
+ * \param[in]  logical_page  Logical EEPROM page number to map
+ * \param[out] view          Page view to set up
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the page was successfully mapped
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ * \retval STATUS_ERR_DENIED            If the page is stored as delta records
+ */
+enum status_code eeprom_emulator_map_page(
+		const uint16_t logical_page,
+		struct eeprom_emulator_page_view *const view)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Make sure the read address is within the allowable address space */
+	if (logical_page >= _eeprom_emulator_logical_pages()) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_find(logical_page);
+
+	view->length     = EEPROM_PAGE_SIZE;
+	view->generation = _eeprom_instance.view_generation;
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	/* Pages staged in the current transaction are newer than any other copy */
+	struct _eeprom_page *staged = _eeprom_emulator_transaction_find(logical_page);
+
+	if (staged != NULL) {
+		view->data = staged->data;
+		return STATUS_OK;
+	}
+#endif
+
+	if (entry != NULL) {
+		view->data = entry->page.data;
+		return STATUS_OK;
+	}
+
+	uint16_t physical_page = _eeprom_instance.page_map[logical_page];
+
+#if (EEPROM_DELTA_RECORDS == true)
+	/* Only a full page revision holds the whole page contents */
+	uint8_t flags = _eeprom_emulator_page_flags(physical_page);
+
+	if (!(flags & EEPROM_PAGE_FLAG_DELTA) ||
+			!(flags & EEPROM_PAGE_FLAG_DISCARDED) ||
+			(_eeprom_emulator_page_is_intact(physical_page) == false)) {
+		return STATUS_ERR_DENIED;
+	}
+#endif
+
+	EEPROM_NVM_TRACE_READ(_eeprom_emulator_page_address(physical_page) +
+			EEPROM_HEADER_SIZE, EEPROM_PAGE_SIZE);
+
+	view->data = _eeprom_instance.flash[physical_page].data;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Checks whether a page view still shows the page contents.
+ *
+ * \param[in] view  Page view set up by \ref eeprom_emulator_map_page()
+ *
+ * \return Whether the data of the view is still current.
+ *
+ * \retval true   If the view can still be read
+ * \retval false  If the page may have changed or moved since it was mapped
+ */
+bool eeprom_emulator_page_view_is_valid(
+		const struct eeprom_emulator_page_view *const view)
+{
+	return (_eeprom_instance.initialized == true) &&
+			(view->generation == _eeprom_instance.view_generation);
+}
+
+/**
+ * \brief Writes a buffer of data to the emulated EEPROM memory space.
+ *
+ * Writes a buffer of data to a section of emulated EEPROM memory space. The
+ * source buffer may be of any size, and the destination may lie outside of an
+ * emulated EEPROM page boundary. Pages whose contents are left unchanged by
+ * the write are not rewritten, and pages entirely covered by the write are not
+ * read first. A write running past the end of the emulated EEPROM memory space
+ * is rejected before any page is changed.
+ *
+ * \note Data stored in pages may be cached in volatile RAM memory; to commit
+ *       any cached data to physical non-volatile memory, the
+ *       \ref eeprom_emulator_commit_page_buffer() function should be called.
+ *
+ * \param[in] offset  Starting byte offset to write to, in emulated EEPROM
+ *                    memory space
+ * \param[in] data    Pointer to the data buffer containing source data to write
+ * \param[in] length  Length of the data to write, in bytes
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the page was successfully read
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ */
+enum status_code eeprom_emulator_write_buffer(
+		const uint16_t offset,
+		const uint8_t *const data,
+		const uint16_t length)
+{
+	enum status_code error_code = STATUS_OK;
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	uint16_t logical_page = offset / EEPROM_PAGE_SIZE;
+	uint8_t page_offset  = offset % EEPROM_PAGE_SIZE;
+	uint16_t c = 0;
+
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Reject writes running past the end before any page is changed */
+	if (((uint32_t)offset + length) >
+			((uint32_t)_eeprom_emulator_logical_pages() * EEPROM_PAGE_SIZE)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	/* Write the data one page segment at a time: a partial head page, whole
+	 * pages, then a partial tail page */
+	while (c < length) {
+		uint16_t segment = EEPROM_PAGE_SIZE - page_offset;
+
+		if (segment > (length - c)) {
+			segment = length - c;
+		}
+
+		if (segment == EEPROM_PAGE_SIZE) {
+			/* Whole pages are written straight from the user's buffer */
+			error_code = eeprom_emulator_write_page(logical_page, &data[c]);
+		} else {
+			/* Partial pages are merged with their current contents */
+			error_code = eeprom_emulator_read_page(logical_page, buffer);
+
+			if (error_code == STATUS_OK) {
+				memcpy(&buffer[page_offset], &data[c], segment);
+				error_code = eeprom_emulator_write_page(logical_page, buffer);
+			}
+		}
+
+		if (error_code != STATUS_OK) {
+			break;
+		}
+
+		c += segment;
+		logical_page++;
+		page_offset = 0;
+	}
+
+	return error_code;
+}
+
+/** \internal
+ *  \brief Copies data from a list of buffer segments.
+ *
+ *  Gathers the next bytes of a list of segments into a destination buffer,
+ *  moving the segment position past them.
+ *
+ *  \param[in]     segments  List of source buffer segments
+ *  \param[in,out] segment   Index of the current segment
+ *  \param[in,out] position  Offset of the next byte in the current segment
+ *  \param[out]    data      Destination buffer to fill
+ *  \param[in]     length    Number of bytes to copy
+ */
+static void _eeprom_emulator_gather_segments(
+		const struct eeprom_emulator_segment *const segments,
+		uint8_t *const segment,
+		uint16_t *const position,
+		uint8_t *const data,
+		uint16_t length)
+{
+	uint16_t c = 0;
+
+	while (c < length) {
+		uint16_t chunk = segments[*segment].length - *position;
+
+		if (chunk > (length - c)) {
+			chunk = length - c;
+		}
+
+		memcpy(&data[c], &segments[*segment].data[*position], chunk);
+		c         += chunk;
+		*position += chunk;
+
+		/* Move on to the next segment once this one is used up */
+		if (*position == segments[*segment].length) {
+			(*segment)++;
+			*position = 0;
+		}
+	}
+}
+
+/**
+ * \brief Writes a list of buffer segments to the emulated EEPROM memory space.
+ *
+ * Writes the concatenation of several source buffers to a section of emulated
+ * EEPROM memory space, as \ref eeprom_emulator_write_buffer() would write them
+ * once copied into a single buffer, so that a structured record need not be
+ * assembled in RAM first. Each emulated EEPROM page covered by the write is
+ * written once, whatever the number of segments spanning it. Whole pages
+ * held by a single segment are written straight from it, and only partially
+ * covered pages are read first.
+ *
+ * \note Data stored in pages may be cached in volatile RAM memory; to commit
+ *       any cached data to physical non-volatile memory, the
+ *       \ref eeprom_emulator_commit_page_buffer() function should be called.
+ *
+ * \param[in] offset         Starting byte offset to write to, in emulated
+ *                           EEPROM memory space
+ * \param[in] segments       List of source buffer segments, written in order
+ * \param[in] segment_count  Number of segments in the list
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the data was successfully written
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ */
+enum status_code eeprom_emulator_write_segments(
+		const uint16_t offset,
+		const struct eeprom_emulator_segment *const segments,
+		const uint8_t segment_count)
+{
+	enum status_code error_code = STATUS_OK;
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	uint16_t logical_page = offset / EEPROM_PAGE_SIZE;
+	uint8_t page_offset  = offset % EEPROM_PAGE_SIZE;
+	uint32_t length   = 0;
+	uint8_t segment   = 0;
+	uint16_t position = 0;
+	uint32_t c = 0;
+
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	for (uint8_t s = 0; s < segment_count; s++) {
+		length += segments[s].length;
+	}
+
+	/* Reject writes running past the end before any page is changed */
+	if ((offset + length) >
+			((uint32_t)_eeprom_emulator_logical_pages() * EEPROM_PAGE_SIZE)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	/* Skip any leading empty segments */
+	while ((segment < segment_count) && (segments[segment].length == 0)) {
+		segment++;
+	}
+
+	/* Fill and write each page covered by the segments once */
+	while (c < length) {
+		uint16_t covered = EEPROM_PAGE_SIZE - page_offset;
+
+		if (covered > (length - c)) {
+			covered = length - c;
+		}
+
+		if ((covered == EEPROM_PAGE_SIZE) &&
+				((segments[segment].length - position) >= EEPROM_PAGE_SIZE)) {
+			/* Whole pages held by one segment are written straight from it */
+			error_code = eeprom_emulator_write_page(logical_page,
+					&segments[segment].data[position]);
+			position += EEPROM_PAGE_SIZE;
+
+			if (position == segments[segment].length) {
+				segment++;
+				position = 0;
+			}
+		} else {
+			/* Partial pages are merged with their current contents */
+			if (covered < EEPROM_PAGE_SIZE) {
+				error_code = eeprom_emulator_read_page(logical_page, buffer);
+			}
+
+			if (error_code == STATUS_OK) {
+				_eeprom_emulator_gather_segments(segments, &segment, &position,
+						&buffer[page_offset], covered);
+				error_code = eeprom_emulator_write_page(logical_page, buffer);
+			}
+		}
+
+		if (error_code != STATUS_OK) {
+			break;
+		}
+
+		/* Skip empty segments before the next page */
+		while ((segment < segment_count) && (segments[segment].length == 0)) {
+			segment++;
+		}
+
+		c += covered;
+		logical_page++;
+		page_offset = 0;
+	}
+
+	return error_code;
+}
+
+/**
+ * \brief Reads a buffer of data from the emulated EEPROM memory space.
+ *
+ * Reads a buffer of data from a section of emulated EEPROM memory space. The
+ * destination buffer may be of any size, and the source may lie outside of an
+ * emulated EEPROM page boundary.
+ *
+ * \param[in]  offset  Starting byte offset to read from, in emulated EEPROM
+ *                     memory space
+ * \param[out] data    Pointer to the data buffer containing source data to read
+ * \param[in]  length  Length of the data to read, in bytes
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the page was successfully read
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ */
+enum status_code eeprom_emulator_read_buffer(
+		const uint16_t offset,
+		uint8_t *const data,
+		const uint16_t length)
+{
+	enum status_code error_code = STATUS_OK;
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	uint16_t logical_page = offset / EEPROM_PAGE_SIZE;
+	uint8_t page_offset  = offset % EEPROM_PAGE_SIZE;
+	uint16_t c = 0;
+
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if (((uint32_t)offset + length) >
+			((uint32_t)_eeprom_emulator_logical_pages() * EEPROM_PAGE_SIZE)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	/* Read the data one page segment at a time: a partial head page, whole
+	 * pages, then a partial tail page */
+	while (c < length) {
+		uint16_t segment = EEPROM_PAGE_SIZE - page_offset;
+
+		if (segment > (length - c)) {
+			segment = length - c;
+		}
+
+		if (segment == EEPROM_PAGE_SIZE) {
+			/* Whole pages are read straight into the user's buffer */
+			error_code = eeprom_emulator_read_page(logical_page, &data[c]);
+		} else {
+			error_code = eeprom_emulator_read_page(logical_page, buffer);
+
+			if (error_code == STATUS_OK) {
+				memcpy(&data[c], &buffer[page_offset], segment);
+			}
+		}
+
+		if (error_code != STATUS_OK) {
+			break;
+		}
+
+		c += segment;
+		logical_page++;
+		page_offset = 0;
+	}
+
+	return error_code;
+}
+
+/**
+ * \brief Commits any cached data to physical non-volatile memory.
+ *
+ * Commits the internal SRAM caches to physical non-volatile memory, to ensure
+ * that any outstanding cached data is preserved. This function should be called
+ * prior to a system reset or shutdown to prevent data loss.
+ *
+ * \note This should be the first function executed in a BOD33 Early Warning
+ *       callback to ensure that any outstanding cache data is fully written to
+ *       prevent data loss. Up to \ref EEPROM_CACHE_ENTRIES page writes may be
+ *       needed, so the BOD33 level should leave enough hold-up time for them.
+ *
+ *
+ * \note This function should also be called before using the NVM controller
+ *       directly in the user-application for any other purposes to prevent
+ *       data loss.
+ *
+ * \return Status code indicating the status of the operation.
+ */
+enum status_code eeprom_emulator_commit_page_buffer(void)
+{
+	enum status_code error_code = STATUS_OK;
+	struct _eeprom_cache_entry *entry;
+
+	/* Finish any row move started by an asynchronous write first */
+	_eeprom_emulator_move_complete();
+
+	/* Write out all cached pages, least recently used first; once the cache
+	 * is inactive, there is no need to commit anything to physical memory */
+	while ((entry = _eeprom_emulator_cache_oldest()) != NULL) {
+		_eeprom_emulator_cache_flush(entry);
+	}
+
+	return error_code;
+}
+
+/**
+ * \brief Advances the writing of cached pages to physical memory.
+ *
+ * Starts at most one NVM page write or row erase towards committing the write
+ * cache, and returns without waiting for it to complete; a row move needed by
+ * a page write is thus spread over several calls. This function should be
+ * called periodically after \ref eeprom_emulator_write_page_async(), for
+ * instance from the main loop, from a protothread with
+ * <tt>PT_WAIT_UNTIL(pt, eeprom_emulator_poll() != STATUS_BUSY)</tt>, or from
+ * the NVM controller ready interrupt as long as the emulator is not used from
+ * any other context at the same time.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the write cache is fully committed
+ * \retval STATUS_BUSY                  If an NVM operation is in progress, or
+ *                                      cached pages remain to be written
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ */
+enum status_code eeprom_emulator_poll(void)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Wait for the previous NVM operation to complete */
+	if (nvm_is_ready() == false) {
+		return STATUS_BUSY;
+	}
+
+	/* Start writing out the least recently used cached page, unless a row move
+	 * is already in progress */
+	if (_eeprom_instance.move_row == EEPROM_INVALID_ROW_NUMBER) {
+		struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_oldest();
+
+		if (entry == NULL) {
+			return STATUS_OK;
+		}
+
+		if (_eeprom_emulator_cache_flush_begin(entry) == true) {
+			return STATUS_BUSY;
+		}
+	}
+
+	_eeprom_emulator_move_step();
+
+	return STATUS_BUSY;
+}
+
+/**
+ * \brief Moves nearly full rows to the spare row in the background.
+ *
+ * Starts at most one NVM page write or row erase towards moving a row with no
+ * more than \ref EEPROM_COMPACTION_FREE_PAGES free pages left, once the pages
+ * cached for it are accounted, to the spare row, and returns without waiting
+ * for it to complete. Calling this function while the application is idle
+ * keeps later page writes from having to move a row themselves, which would
+ * wait for the row erase. It is called the same way as
+ * \ref eeprom_emulator_poll(), until it no longer returns \c STATUS_BUSY.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If no row needs to be moved
+ * \retval STATUS_BUSY                  If an NVM operation is in progress, or
+ *                                      rows remain to be moved
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ */
+enum status_code eeprom_emulator_compact(void)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Wait for the previous NVM operation to complete */
+	if (nvm_is_ready() == false) {
+		return STATUS_BUSY;
+	}
+
+	/* Find the row with the fewest free pages left, unless a row move is
+	 * already in progress */
+	if (_eeprom_instance.move_row == EEPROM_INVALID_ROW_NUMBER) {
+		uint8_t compact_row = EEPROM_INVALID_ROW_NUMBER;
+		uint8_t compact_fill = NVMCTRL_ROW_PAGES - EEPROM_COMPACTION_FREE_PAGES;
+
+		for (uint8_t row = 0; row < _eeprom_emulator_data_rows(); row++) {
+			if (_eeprom_emulator_is_spare_row(row) == true) {
+				continue;
+			}
+
+			uint8_t fill = _eeprom_instance.row_fill[row] +
+					_eeprom_emulator_cache_pending_on_row(row);
+
+			if (fill >= compact_fill) {
+				compact_row  = row;
+				compact_fill = fill;
+			}
+		}
+
+		if (compact_row == EEPROM_INVALID_ROW_NUMBER) {
+#if (EEPROM_SPARE_ROWS > 1)
+			/* Refill the pool of erased spare rows */
+			if (_eeprom_emulator_erase_spare_begin() == true) {
+				_eeprom_emulator_move_step();
+				return STATUS_BUSY;
+			}
+#endif
+			return STATUS_OK;
+		}
+
+		_eeprom_instance.statistics.compaction_moves++;
+
+		/* Cached pages of the row are written to the spare row by the move */
+		_eeprom_emulator_move_begin(
+				compact_row, EEPROM_INVALID_PAGE_NUMBER, NULL, NULL);
+	}
+
+	_eeprom_emulator_move_step();
+
+	return STATUS_BUSY;
+}
+
+#if (EEPROM_METADATA_ROW == true) || defined(__DOXYGEN__)
+/**
+ * \brief Writes a checkpoint of the emulator state to the metadata row.
+ *
+ * Commits the write cache and records the current logical to physical page
+ * map, so that the next initialization of the emulator only needs to scan the
+ * rows written after this call. A checkpoint is written automatically when
+ * initialization had to fall back to a full scan.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the checkpoint was written
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ */
+enum status_code eeprom_emulator_checkpoint(void)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* Only committed pages may be recorded in the checkpoint */
+	eeprom_emulator_commit_page_buffer();
+
+	_eeprom_emulator_write_checkpoint();
+
+	return STATUS_OK;
+}
+#endif
+
+#if (EEPROM_FORMAT_MIGRATION == true) || defined(__DOXYGEN__)
+/**
+ * \brief Migrates the emulated EEPROM memory to the configured layout.
+ *
+ * Rewrites memory that \ref eeprom_emulator_init() found to be written with
+ * another physical layout of the same emulator scheme, one row per call, so
+ * that the application may report the progress or keep running between
+ * calls. Once the last row has been rewritten, the emulator is initialized.
+ * A migration interrupted by a reset is resumed by calling
+ * \ref eeprom_emulator_init() and this function again.
+ *
+ * \param[out] progress  Migration progress structure to fill
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the migration is complete, and the
+ *                                      emulator initialized
+ * \retval STATUS_BUSY                  If a row was rewritten, and the function
+ *                                      must be called again
+ * \retval STATUS_ERR_NOT_INITIALIZED   If initialization did not find memory
+ *                                      with another layout
+ * \retval STATUS_ERR_IO                If the memory cannot be migrated without
+ *                                      losing data; it is left unchanged
+ * \retval STATUS_ERR_BAD_FORMAT        If the migrated memory is corrupt
+ */
+enum status_code eeprom_emulator_migrate(
+		struct eeprom_emulator_migration *const progress)
+{
+	struct _eeprom_migration_plan plan;
+	struct _eeprom_master_page master_page;
+	uint8_t bits[NVMCTRL_PAGE_SIZE];
+	uint8_t step = 0;
+	uint16_t copy;
+
+	progress->rows_done  = 0;
+	progress->rows_total = 0;
+
+	if (_eeprom_instance.initialized == true) {
+		return STATUS_OK;
+	}
+
+	if (_eeprom_instance.migration_pending == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	/* New pages are numbered from scratch, as the only revision of their
+	 * logical page */
+	memset(_eeprom_instance.page_map, EEPROM_INVALID_PAGE_NUMBER,
+			sizeof(_eeprom_instance.page_map));
+
+	_eeprom_emulator_read_master_page(&master_page);
+
+	if (_eeprom_emulator_migration_layout(&master_page, &plan.layout) == false) {
+		return STATUS_ERR_IO;
+	}
+
+	plan.kept_pages = _eeprom_emulator_logical_pages();
+	if (plan.kept_pages > plan.layout.logical_pages) {
+		plan.kept_pages = plan.layout.logical_pages;
+	}
+
+	_eeprom_emulator_fill_master_page(&master_page);
+	_eeprom_emulator_nvm_read_page(EEPROM_MIGRATION_JOURNAL_PAGE_NUMBER,
+			&plan.journal);
+
+	if (((plan.journal.state & EEPROM_MIGRATION_STATE_STARTED) == 0) &&
+			(plan.journal.state & EEPROM_MIGRATION_STATE_DONE)) {
+		/* A migration in progress can only be resumed to the same layout */
+		if ((plan.journal.layout != master_page.layout) ||
+				(plan.journal.spare_rows != master_page.spare_rows)) {
+			return STATUS_ERR_IO;
+		}
+	} else {
+		const uint8_t *journal = (const uint8_t *)&plan.journal;
+		bool programmable = true;
+
+		/* Keep the current journal contents */
+		memcpy(bits, &plan.journal, sizeof(bits));
+		memset(&plan.journal, 0xFF, sizeof(plan.journal));
+		plan.journal.layout     = master_page.layout;
+		plan.journal.spare_rows = master_page.spare_rows;
+
+		if (_eeprom_emulator_migration_prepare(&plan) == false) {
+			return STATUS_ERR_IO;
+		}
+
+		/* A journal left by an earlier migration, or by a different one that
+		 * was interrupted before it started, is cleared with the master row */
+		for (uint8_t c = 0; c < NVMCTRL_PAGE_SIZE; c++) {
+			if (journal[c] & ~bits[c]) {
+				programmable = false;
+			}
+		}
+
+		/* The master page is copied to an erased row while the master row
+		 * is erased, and restored from the copy after a reset */
+		copy = _eeprom_emulator_find_master_copy(&master_page);
+
+		if (copy == EEPROM_MASTER_PAGE_NUMBER) {
+			_eeprom_emulator_nvm_read_page(
+					_eeprom_emulator_master_page_number(), &master_page);
+		}
+
+		if ((programmable == false) && (copy == EEPROM_MASTER_PAGE_NUMBER)) {
+			copy = _eeprom_emulator_save_master_copy(&master_page);
+
+			if (copy == EEPROM_MASTER_PAGE_NUMBER) {
+				return STATUS_ERR_IO;
+			}
+		}
+
+		if (copy != EEPROM_MASTER_PAGE_NUMBER) {
+			if (programmable == false) {
+				_eeprom_emulator_nvm_erase_row(
+						EEPROM_MASTER_PAGE_NUMBER / NVMCTRL_ROW_PAGES);
+			}
+
+			_eeprom_emulator_migration_program(EEPROM_MASTER_PAGE_NUMBER,
+					&master_page);
+			_eeprom_emulator_nvm_erase_row(copy / NVMCTRL_ROW_PAGES);
+		}
+
+		/* Write the journal in full before marking the migration started */
+		_eeprom_emulator_migration_program(
+				EEPROM_MIGRATION_JOURNAL_PAGE_NUMBER, &plan.journal);
+		plan.journal.state &= ~EEPROM_MIGRATION_STATE_STARTED;
+		_eeprom_emulator_migration_program(
+				EEPROM_MIGRATION_JOURNAL_PAGE_NUMBER, &plan.journal);
+
+		progress->rows_total = plan.steps;
+
+		return STATUS_BUSY;
+	}
+
+	_eeprom_emulator_migration_count_steps(&plan);
+
+	_eeprom_emulator_nvm_read_page(EEPROM_MIGRATION_PROGRESS_PAGE_NUMBER, bits);
+
+	while ((step < plan.steps) && ((bits[step / 8] & (1 << (step % 8))) == 0)) {
+		step++;
+	}
+
+	progress->rows_total = plan.steps;
+
+	if (step < plan.steps) {
+		_eeprom_emulator_migration_step(&plan, step);
+		progress->rows_done = step + 1;
+
+		return STATUS_BUSY;
+	}
+
+	_eeprom_emulator_migration_finish(&plan);
+	progress->rows_done = plan.steps;
+
+	return eeprom_emulator_init();
+}
+#endif
+
+#if (EEPROM_TRANSACTION_PAGES > 0) || defined(__DOXYGEN__)
+/**
+ * \brief Starts a transaction of logical page writes.
+ *
+ * Page writes made until the transaction is committed or aborted are staged in
+ * SRAM, and are only written to physical memory when the transaction is
+ * committed, all together or not at all. Up to \ref EEPROM_TRANSACTION_PAGES
+ * different logical pages may be written within a transaction.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the transaction was started
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_DENIED            If a transaction is already in progress
+ */
+enum status_code eeprom_emulator_begin_transaction(void)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if (_eeprom_instance.transaction_active == true) {
+		return STATUS_ERR_DENIED;
+	}
+
+	_eeprom_instance.transaction_pages  = 0;
+	_eeprom_instance.transaction_active = true;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Commits the current transaction to physical memory.
+ *
+ * Writes all pages staged in the current transaction to physical memory, so
+ * that after a reset either all or none of them are found. Rows without enough
+ * free pages for the staged pages are moved to the spare row first. The staged
+ * pages are then written, the last one carrying the commit record of the
+ * transaction, and finally marked as published.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the transaction was committed
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_DENIED            If no transaction is in progress
+ * \retval STATUS_ERR_NO_MEMORY         If no free page could be made for a
+ *                                      staged page; the transaction is
+ *                                      aborted
+ */
+enum status_code eeprom_emulator_commit_transaction(void)
+{
+	uint8_t count = _eeprom_instance.transaction_pages;
+	uint16_t physical_pages[EEPROM_TRANSACTION_PAGES];
+
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if (_eeprom_instance.transaction_active == false) {
+		return STATUS_ERR_DENIED;
+	}
+
+	/* Finish any row move started by an asynchronous write first */
+	_eeprom_emulator_move_complete();
+
+	/* Cached revisions of the staged pages are superseded */
+	for (uint8_t c = 0; c < count; c++) {
+		struct _eeprom_cache_entry *entry = _eeprom_emulator_cache_find(
+				_eeprom_instance.transaction[c].header.logical_page);
+
+		if (entry != NULL) {
+			entry->active = false;
+		}
+	}
+
+	/* Make room for all staged pages before any of them is written, keeping a
+	 * free page reserved for every cached page as usual */
+	for (uint8_t c = 0; c < count; c++) {
+		uint8_t row = _eeprom_instance.page_map[
+				_eeprom_instance.transaction[c].header.logical_page] /
+				NVMCTRL_ROW_PAGES;
+		uint8_t needed = _eeprom_emulator_cache_pending_on_row(row);
+
+		for (uint8_t c2 = 0; c2 < count; c2++) {
+			if ((_eeprom_instance.page_map[
+					_eeprom_instance.transaction[c2].header.logical_page] /
+					NVMCTRL_ROW_PAGES) == row) {
+				needed++;
+			}
+		}
+
+		if ((_eeprom_instance.row_fill[row] + needed) > NVMCTRL_ROW_PAGES) {
+			_eeprom_emulator_move_data_to_spare(
+					row, EEPROM_INVALID_PAGE_NUMBER, NULL);
+		}
+	}
+
+	/* Write out the staged pages; a single page is written as an ordinary
+	 * page, as its write is atomic on its own */
+	for (uint8_t c = 0; c < count; c++) {
+		struct _eeprom_page *page = &_eeprom_instance.transaction[c];
+
+		if (count > 1) {
+			page->header.flags &= ~EEPROM_PAGE_FLAG_STAGED;
+		}
+
+		if ((count > 1) && (c == (count - 1))) {
+			page->header.flags &= ~EEPROM_PAGE_FLAG_COMMIT;
+		}
+
+		/* Room was made for every staged page above; should a row still be
+		 * full, the pages written so far lack the commit record and are
+		 * discarded at the next initialization */
+		if (_eeprom_emulator_is_page_free_on_row(
+				_eeprom_instance.page_map[page->header.logical_page],
+				&physical_pages[c]) == false) {
+			_eeprom_instance.transaction_active = false;
+			_eeprom_instance.transaction_pages  = 0;
+			_eeprom_instance.view_generation++;
+			return STATUS_ERR_NO_MEMORY;
+		}
+
+		_eeprom_emulator_nvm_write_page(physical_pages[c], page);
+	}
+
+	/* Publish the transaction, the page holding the commit record last */
+	for (uint8_t c = 0; c < count; c++) {
+		if (count > 1) {
+			_eeprom_emulator_clear_page_flags(physical_pages[c],
+					EEPROM_PAGE_FLAG_PUBLISHED);
+		}
+
+		_eeprom_instance.page_map[
+				_eeprom_instance.transaction[c].header.logical_page] =
+				physical_pages[c];
+	}
+
+	_eeprom_instance.transaction_active = false;
+	_eeprom_instance.transaction_pages  = 0;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Aborts the current transaction.
+ *
+ * Discards all pages staged in the current transaction; physical memory is
+ * left untouched.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the transaction was aborted
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_DENIED            If no transaction is in progress
+ */
+enum status_code eeprom_emulator_abort_transaction(void)
+{
+	/* Ensure the emulated EEPROM has been initialized first */
+	if (_eeprom_instance.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if (_eeprom_instance.transaction_active == false) {
+		return STATUS_ERR_DENIED;
+	}
+
+	_eeprom_instance.transaction_active = false;
+	_eeprom_instance.transaction_pages  = 0;
+	_eeprom_instance.view_generation++;
+
+	return STATUS_OK;
+}
+#endif
+
+/**
+ * \brief Updates a CRC-16/CCITT with a block of data.
+ *
+ * Processes the data a nibble at a time with a 16-entry table, which is a
+ * good trade-off between speed and table size on small devices. Used by the
+ * page checksums, and by the records of the modules built on the emulator.
+ *
+ * \param[in] crc     CRC of the preceding data, or 0xFFFF to start a new one
+ * \param[in] data    Data to add to the CRC
+ * \param[in] length  Length of the data, in bytes
+ *
+ * \return Updated CRC.
+ */
+uint16_t eeprom_emulator_crc16(
+		uint16_t crc,
+		const uint8_t *const data,
+		const uint16_t length)
+{
+	static const uint16_t crc_table[16] = {
+		0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+		0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	};
+
+	for (uint16_t c = 0; c < length; c++) {
+		crc = (crc << 4) ^ crc_table[(crc >> 12) ^ (data[c] >> 4)];
+		crc = (crc << 4) ^ crc_table[(crc >> 12) ^ (data[c] & 0x0F)];
+	}
+
+	return crc;
+}
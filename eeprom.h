@@ -1,538 +1,959 @@
-/**
- * \file
- *
- * \brief SAM EEPROM Emulator
- *
- * Copyright (C) 2012-2015 Atmel Corporation. All rights reserved.
- *
- * \asf_license_start
- *
- * \page License
- *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions are met:
- *
- * 1. Redistributions of source code must retain the above copyright notice,
- *    this list of conditions and the following disclaimer.
- *
- * 2. Redistributions in binary form must reproduce the above copyright notice,
- *    this list of conditions and the following disclaimer in the documentation
- *    and/or other materials provided with the distribution.
- *
- * 3. The name of Atmel may not be used to endorse or promote products derived
- *    from this software without specific prior written permission.
- *
- * 4. This software may only be redistributed and used in connection with an
- *    Atmel microcontroller product.
- *
- * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
- * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
- * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
- * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
- * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
- * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
- * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
- * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
- * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
- * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
- * POSSIBILITY OF SUCH DAMAGE.
- *
- * \asf_license_stop
- *
- */
-/*
- * Support and FAQ: visit <a href="http://www.atmel.com/design-support/">Atmel Support</a>
- */
-#ifndef EEPROM_H_INCLUDED
-#define EEPROM_H_INCLUDED
-
-/**
- * \defgroup asfdoc_sam0_eeprom_group SAM EEPROM Emulator (EEPROM) Service
- *
- * This driver for Atmel&reg; | SMART ARM&reg;-based microcontrollers provides an emulated EEPROM memory space in
- * the device's FLASH memory, for the storage and retrieval of user-application
- * configuration data into and out of non-volatile memory.
- *
- * The following peripherals are used by this module:
- *  - NVM (Non-Volatile Memory Controller)
- *
- * The following devices can use this module:
- *  - Atmel | SMART SAM D20/D21
- *  - Atmel | SMART SAM R21
- *  - Atmel | SMART SAM D10/D11
- *  - Atmel | SMART SAM L21/L22
- *  - Atmel | SMART SAM C20/C21
- *  - Atmel | SMART SAM DA1
- *
- * The outline of this documentation is as follows:
- *  - \ref asfdoc_sam0_eeprom_prerequisites
- *  - \ref asfdoc_sam0_eeprom_module_overview
- *  - \ref asfdoc_sam0_eeprom_special_considerations
- *  - \ref asfdoc_sam0_eeprom_extra_info
- *  - \ref asfdoc_sam0_eeprom_examples
- *  - \ref asfdoc_sam0_eeprom_api_overview
- *
- *
- * \section asfdoc_sam0_eeprom_prerequisites Prerequisites
- *
- * The SAM device fuses must be configured via an external programmer or
- * debugger, so that an EEPROM section is allocated in the main NVM flash
- * memory contents. If a NVM section is not allocated for the EEPROM emulator,
- * or if insufficient space for the emulator is reserved, the module will fail
- * to initialize.
- *
- *
- * \section asfdoc_sam0_eeprom_module_overview Module Overview
- *
- * As the SAM devices do not contain any physical EEPROM memory, the storage
- * of non-volatile user data is instead emulated using a special section of the
- * device's main FLASH memory. The use of FLASH memory technology over EEPROM
- * presents several difficulties over true EEPROM memory; data must be written
- * as a number of physical memory pages (of several bytes each) rather than
- * being individually byte addressable, and entire rows of FLASH must be erased
- * before new data may be stored. To help abstract these characteristics away
- * from the user application an emulation scheme is implemented to present a
- * more user-friendly API for data storage and retrieval.
- *
- * This module provides an EEPROM emulation layer on top of the device's
- * internal NVM controller, to provide a standard interface for the reading and
- * writing of non-volatile configuration data. This data is placed into the
- * EEPROM emulated section of the device's main FLASH memory storage section,
- * the size of which is configured using the device's fuses. Emulated EEPROM is
- * exempt from the usual device NVM region lock bits, so that it may be read
- * from or written to at any point in the user application.
- *
- * There are many different algorithms that may be employed for EEPROM emulation
- * using FLASH memory, to tune the write and read latencies, RAM usage, wear
- * levelling and other characteristics. As a result, multiple different emulator
- * schemes may be implemented, so that the most appropriate scheme for a
- * specific application's requirements may be used.
- *
- * \subsection asfdoc_sam0_eeprom_module_overview_implementation Implementation Details
- * The following information is relevant for <b>EEPROM Emulator scheme 1,
- * version 1.0.0</b>, as implemented by this module. Other revisions or
- * emulation schemes may vary in their implementation details and may have
- * different wear-leveling, latency, and other characteristics.
- *
- * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_ec Emulator Characteristics
- * This emulator is designed for <b>best reliability, with a good balance of
- * available storage and write-cycle limits</b>. It is designed to ensure that
- * page data is automatically updated so that in the event of a failed update the
- * previous data is not lost (when used correctly). With the exception of a
- * system reset with data cached to the internal write-cache buffer, at most
- * only the latest write to physical non-volatile memory will be lost in the
- * event of a failed write.
- *
- * This emulator scheme is tuned to give best write-cycle longevity when writes
- * are confined to the same logical EEPROM page (where possible) and when writes
- * across multiple logical EEPROM pages are made in a linear fashion through the
- * entire emulated EEPROM space.
- *
- * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_pf Physical Memory
- * The SAM non-volatile FLASH is divided into a number of physical rows, each
- * containing four identically sized flash pages. Pages may be read or written
- * to individually, however pages must be erased before being reprogrammed and
- * the smallest granularity available for erasure is one single row.
- *
- * This discrepancy results in the need for an emulator scheme that is able to
- * handle the versioning and moving of page data to different physical rows as
- * needed, erasing old rows ready for re-use by future page write operations.
- *
- * Physically, the emulated EEPROM segment is located at the end of the physical
- * FLASH memory space, as shown in
- * \ref asfdoc_sam0_eeprom_module_mem_layout "the figure below".
- *
- * \anchor asfdoc_sam0_eeprom_module_mem_layout
- * \dot
- * digraph memory_layout {
- *  size="5,5"
- *  node [shape=plaintext]
- *  memory [label=<
- *   <table border="0" cellborder="1" cellspacing="0" >
- *    <tr>
- *     <td align="right" border="0"> End of NVM Memory </td>
- *     <td rowspan="3" align="center"> Reserved EEPROM Section </td>
- *    </tr>
- *    <tr>
- *     <td align="right" border="0"> </td>
- *    </tr>
- *    <tr>
- *     <td align="right" border="0"> Start of EEPROM Memory </td>
- *    </tr>
- *    <tr>
- *     <td align="right" border="0"> End of Application Memory </td>
- *     <td rowspan="3" align="center"> Application Section </td>
- *    </tr>
- *    <tr>
- *     <td height="300" align="right" border="0"> </td>
- *    </tr>
- *    <tr>
- *     <td align="right" border="0"> Start of Application Memory </td>
- *    </tr>
- *    <tr>
- *     <td align="right" border="0"> End of Bootloader Memory </td>
- *     <td rowspan="3" align="center"> BOOT Section </td>
- *    </tr>
- *    <tr>
- *     <td align="right" border="0"> </td>
- *    </tr>
- *    <tr>
- *     <td align="right" border="0"> Start of NVM Memory</td>
- *    </tr>
- *   </table>
- *  >]
- * }
- * \enddot
- *
- * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_mp Master Row
- * One physical FLASH row at the end of the emulated EEPROM memory space is
- * reserved for use by the emulator to store configuration data. The master row
- * is not user-accessible, and is reserved solely for internal use by the
- * emulator.
- *
- * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_sr Spare Row
- * As data needs to be preserved between row erasures, a single FLASH row is kept
- * unused to act as destination for copied data when a write request is made to
- * an already full row. When the write request is made, any logical pages of
- * data in the full row that need to be preserved are written to the spare row
- * along with the new (updated) logical page data, before the old row is erased
- * and marked as the new spare.
- *
- * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_rc Row Contents
- * Each physical FLASH row initially stores the contents of two logical EEPROM
- * memory pages. This halves the available storage space for the emulated EEPROM
- * but reduces the overall number of row erases that are required, by reserving
- * two pages within each row for updated versions of the logical page contents.
- * See \ref asfdoc_sam0_eeprom_init_layout "here" for a visual layout of the
- * EEPROM Emulator physical memory.
- *
- * As logical pages within a physical row are updated, the new data is filled
- * into the remaining unused pages in the row. Once the entire row is full, a
- * new write request will copy the logical page not being written to in the
- * current row to the spare row with the new (updated) logical page data, before
- * the old row is erased.
- *
- * This system allows for the same logical page to be updated up to three times
- * into physical memory before a row erasure procedure is needed. In the case of
- * multiple versions of the same logical EEPROM page being stored in the same
- * physical row, the right-most (highest physical FLASH memory page address)
- * version is considered to be the most current.
- *
- * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_wc Write Cache
- * As a typical EEPROM use case is to write to multiple sections of the same
- * EEPROM page sequentially, the emulator is optimized with a single logical
- * EEPROM page write cache to buffer writes before they are written to the
- * physical backing memory store. The cache is automatically committed when a
- * new write request to a different logical EEPROM memory page is requested, or
- * when the user manually commits the write cache.
- *
- * Without the write cache, each write request to an EEPROM memory page would
- * require a full page write, reducing the system performance and significantly
- * reducing the lifespan of the non-volatile memory.
- *
- * \subsection asfdoc_sam0_eeprom_special_considerations_memlayout Memory Layout
- * A single logical EEPROM page is physically stored as the page contents and a
- * header inside a single physical FLASH page, as shown in
- * \ref asfdoc_sam0_eeprom_page_layout "the following figure".
- *
- * \anchor asfdoc_sam0_eeprom_page_layout
- * \image html page_layout.svg "Internal Layout of An Emulated EEPROM Page"
- *
- * Within the EEPROM memory reservation section at the top of the NVM memory
- * space, this emulator will produce the layout as shown in
- * \ref asfdoc_sam0_eeprom_init_layout "the figure below" when initialized for
- * the first time.
- *
- * \anchor asfdoc_sam0_eeprom_init_layout
- * \image html init_layout.svg "Initial Physical Layout of The Emulated EEPROM Memory"
- *
- * When an EEPROM page needs to be committed to physical memory, the next free
- * FLASH page in the same row will be chosen - this makes recovery simple, as the
- * right-most version of a logical page in a row is considered the most current.
- * With four pages to a physical NVM row, this allows for up to three updates to
- * the same logical page to be made before an erase is needed.
- * \ref asfdoc_sam0_eeprom_page_write1 "The figure below" shows the result of
- * the user writing an updated version of logical EEPROM page <tt>N-1</tt> to
- * the physical memory.
- *
- * \anchor asfdoc_sam0_eeprom_page_write1
- * \image html nm1_page_write.svg "First Write to Logical EEPROM Page N-1"
- *
- * A second write of the same logical EEPROM page results in the layout shown
- * in \ref asfdoc_sam0_eeprom_page_write2 "the figure below".
- *
- * \anchor asfdoc_sam0_eeprom_page_write2
- * \image html nm1_page_write2.svg "Second Write to Logical EEPROM Page N-1"
- *
- * A third write of the same logical page requires that the EEPROM emulator
- * erase the row, as it has become full. Prior to this, the contents of the
- * unmodified page in the same row as the page being updated will be copied into
- * the spare row, along with the new version of the page being updated. The old
- * (full) row is then erased, resulting in the layout shown in
- * \ref asfdoc_sam0_eeprom_page_write3 "the figure below".
- *
- * \anchor asfdoc_sam0_eeprom_page_write3
- * \image html nm1_page_write3.svg "Third Write to Logical EEPROM Page N-1"
- *
- *
- * \section asfdoc_sam0_eeprom_special_considerations Special Considerations
- *
- * \subsection asfdoc_sam0_eeprom_special_considerations_nvm_config NVM Controller Configuration
- * The EEPROM Emulator service will initialize the NVM controller as part of its
- * own initialization routine; the NVM controller will be placed in Manual Write
- * mode, so that explicit write commands must be sent to the controller to
- * commit a buffered page to physical memory. The manual write command must thus
- * be issued to the NVM controller whenever the user application wishes to write
- * to a NVM page for its own purposes.
- *
- * \subsection asfdoc_sam0_eeprom_special_considerations_pagesize Logical EEPROM Page Size
- * As a small amount of information needs to be stored in a header before the
- * contents of a logical EEPROM page in memory (for use by the emulation
- * service), the available data in each EEPROM page is less than the total size
- * of a single NVM memory page by several bytes.
- *
- * \subsection asfdoc_sam0_eeprom_special_considerations_committing Committing of the Write Cache
- * A single-page write cache is used internally to buffer data written to pages
- * in order to reduce the number of physical writes required to store the user
- * data, and to preserve the physical memory lifespan. As a result, it is
- * important that the write cache is committed to physical memory <b>as soon as
- * possible after a BOD low power condition</b>, to ensure that enough power is
- * available to guarantee a completed write so that no data is lost.
- *
- * The write cache must also be manually committed to physical memory if the
- * user application is to perform any NVM operations using the NVM controller
- * directly.
- *
- *
- * \section asfdoc_sam0_eeprom_extra_info Extra Information
- *
- * For extra information, see \ref asfdoc_sam0_eeprom_extra. This includes:
- *  - \ref asfdoc_sam0_eeprom_extra_acronyms
- *  - \ref asfdoc_sam0_eeprom_extra_dependencies
- *  - \ref asfdoc_sam0_eeprom_extra_errata
- *  - \ref asfdoc_sam0_eeprom_extra_history
- *
- *
- * \section asfdoc_sam0_eeprom_examples Examples
- *
- * For a list of examples related to this driver, see
- * \ref asfdoc_sam0_eeprom_exqsg.
- *
- *
- * \section asfdoc_sam0_eeprom_api_overview API Overview
- * @{
- */
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include <compiler.h>
-
-#if !defined(__DOXYGEN__)
-#  define EEPROM_MAX_PAGES            (64 * NVMCTRL_ROW_PAGES)
-#  define EEPROM_MASTER_PAGE_NUMBER   (_eeprom_instance.physical_pages - 1)
-#  define EEPROM_INVALID_PAGE_NUMBER  0xFF
-#  define EEPROM_INVALID_ROW_NUMBER   (EEPROM_INVALID_PAGE_NUMBER / NVMCTRL_ROW_PAGES)
-#  define EEPROM_HEADER_SIZE          4
-#endif
-
-
-/** \name EEPROM Emulator Information
- * @{
- */
-
-/** Emulator scheme ID, identifying the scheme used to emulated EEPROM storage. */
-#define EEPROM_EMULATOR_ID          1
-
-/** Emulator major version number, identifying the emulator major version. */
-#define EEPROM_MAJOR_VERSION        1
-
-/** Emulator minor version number, identifying the emulator minor version. */
-#define EEPROM_MINOR_VERSION        0
-
-/** Emulator revision version number, identifying the emulator revision. */
-#define EEPROM_REVISION             0
-
-/** Size of the user data portion of each logical EEPROM page, in bytes. */
-#define EEPROM_PAGE_SIZE            (NVMCTRL_PAGE_SIZE - EEPROM_HEADER_SIZE)
-
-/**
- * \brief EEPROM memory parameter structure.
- *
- * Structure containing the memory layout parameters of the EEPROM emulator module.
- */
-struct eeprom_emulator_parameters {
-	/** Number of bytes per emulated EEPROM page. */
-	uint8_t  page_size;
-	/** Number of emulated pages of EEPROM. */
-	uint16_t eeprom_number_of_pages;
-};
-
-/** @} */
-
-/** \name Configuration and Initialization
- * @{
- */
-
-enum status_code eeprom_emulator_init(void);
-
-void eeprom_emulator_erase_memory(void);
-
-enum status_code eeprom_emulator_get_parameters(
-		struct eeprom_emulator_parameters *const parameters);
-
-/** @} */
-
-
-/** \name Logical EEPROM Page Reading/Writing
- * @{
- */
-
-enum status_code eeprom_emulator_commit_page_buffer(void);
-
-enum status_code eeprom_emulator_write_page(
-		const uint8_t logical_page,
-		const uint8_t *const data);
-
-enum status_code eeprom_emulator_read_page(
-		const uint8_t logical_page,
-		uint8_t *const data);
-
-/** @} */
-
-/** \name Buffer EEPROM Reading/Writing
- * @{
- */
-
-enum status_code eeprom_emulator_write_buffer(
-		const uint16_t offset,
-		const uint8_t *const data,
-		const uint16_t length);
-
-enum status_code eeprom_emulator_read_buffer(
-		const uint16_t offset,
-		uint8_t *const data,
-		const uint16_t length);
-
-/** @} */
-
-#ifdef __cplusplus
-}
-#endif
-
-/** @} */
-
-/**
- * \page asfdoc_sam0_eeprom_extra Extra Information
- *
- * \section asfdoc_sam0_eeprom_extra_acronyms Acronyms
- * Below is a table listing the acronyms used in this module, along with their
- * intended meanings.
- *
- * <table>
- *	<tr>
- *		<th>Acronym</th>
- *		<th>Description</th>
- *	</tr>
- *	<tr>
- *		<td>EEPROM</td>
- *		<td>Electronically Erasable Read-Only Memory</td>
- *	</tr>
- *	<tr>
- *		<td>NVM</td>
- *		<td>Non-Volatile Memory</td>
- *	</tr>
- * </table>
- *
- *
- * \section asfdoc_sam0_eeprom_extra_dependencies Dependencies
- * This driver has the following dependencies:
- *
- *  - \ref asfdoc_sam0_nvm_group "Non-Volatile Memory Controller Driver"
- *
- *
- * \section asfdoc_sam0_eeprom_extra_errata Errata
- * There are no errata related to this driver.
- *
- *
- * \section asfdoc_sam0_eeprom_extra_history Module History
- * An overview of the module history is presented in the table below, with
- * details on the enhancements and fixes made to the module since its first
- * release. The current version of this corresponds to the newest version in
- * the table.
- *
- * <table>
- *	<tr>
- *		<th>Changelog</th>
- *	</tr>
- *	<tr>
- *		<td>Fix warnings</td>
- *	</tr>
- *	<tr>
- *		<td>Initial Release</td>
- *	</tr>
- * </table>
- */
-
-/**
- * \page asfdoc_sam0_eeprom_exqsg Examples for Emulated EEPROM Service
- *
- * This is a list of the available Quick Start guides (QSGs) and example
- * applications for \ref asfdoc_sam0_eeprom_group. QSGs are simple examples with
- * step-by-step instructions to configure and use this driver in a selection of
- * use cases. Note that QSGs can be compiled as a standalone application or be
- * added to the user application.
- *
- *  - \subpage asfdoc_sam0_eeprom_basic_use_case
- *
- * \page asfdoc_sam0_eeprom_document_revision_history Document Revision History
- *
- * <table>
- *	<tr>
- *		<th>Doc. Rev.</th>
- *		<th>Date</th>
- *		<th>Comments</th>
- *	</tr>
- *	<tr>
- *		<td>42125F</td>
- *		<td>12/2015</td>
- *		<td>Added support for SAM L22, SAM DA1, and SAM C20/C21</td>
- *	</tr>
- *	<tr>
- *		<td>42125E</td>
- *		<td>11/2014</td>
- *		<td>Added support for SAM L21</td>
- *	</tr>
- *	<tr>
- *		<td>42125D</td>
- *		<td>09/2014</td>
- *		<td>Added support for SAM R21, and SAM D10/D11</td>
- *	</tr>
- *	<tr>
- *		<td>42125C</td>
- *		<td>07/2014</td>
- *		<td>Add support for SAM D21</td>
- *	</tr>
- *  <tr>
- *	   <td>42125B</td>
- *	   <td>11/2013</td>
- *     <td>
- *        - ASF 3.13: Fixed bugs related to eeprom_emulator_write_buffer() and
- *          eeprom_emulator_read_buffer(). The functions now handle offsets that
- *          are multiples of 60. The length can now be smaller than one page without
- *          risking corruption. Addresses that are multiples of 60 will be written
- *          correctly
- *        - Updated module figures and re-worded the module overview. Corrected
- *          documentation typos
- *     </td>
- *	</tr>
- *	<tr>
- *		<td>42125A</td>
- *		<td>06/2013</td>
- *		<td>Initial release</td>
- *	</tr>
- * </table>
- */
-
-#endif /* EEPROM_H_INCLUDED */
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator
+ *
+ * Copyright (C) 2012-2015 Atmel Corporation. All rights reserved.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ *    Atmel microcontroller product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \asf_license_stop
+ *
+ */
+/*
+ * Support and FAQ: visit <a href="http://www.atmel.com/design-support/">Atmel Support</a>
+ */
+#ifndef EEPROM_H_INCLUDED
+#define EEPROM_H_INCLUDED
+
+/**
+ * \defgroup asfdoc_sam0_eeprom_group SAM EEPROM Emulator (EEPROM) Service
+ *
+ * This driver for Atmel&reg; | SMART ARM&reg;-based microcontrollers provides an emulated EEPROM memory space in
+ * the device's FLASH memory, for the storage and retrieval of user-application
+ * configuration data into and out of non-volatile memory.
+ *
+ * The following peripherals are used by this module:
+ *  - NVM (Non-Volatile Memory Controller)
+ *
+ * The following devices can use this module:
+ *  - Atmel | SMART SAM D20/D21
+ *  - Atmel | SMART SAM R21
+ *  - Atmel | SMART SAM D10/D11
+ *  - Atmel | SMART SAM L21/L22
+ *  - Atmel | SMART SAM C20/C21
+ *  - Atmel | SMART SAM DA1
+ *
+ * The outline of this documentation is as follows:
+ *  - \ref asfdoc_sam0_eeprom_prerequisites
+ *  - \ref asfdoc_sam0_eeprom_module_overview
+ *  - \ref asfdoc_sam0_eeprom_special_considerations
+ *  - \ref asfdoc_sam0_eeprom_extra_info
+ *  - \ref asfdoc_sam0_eeprom_examples
+ *  - \ref asfdoc_sam0_eeprom_api_overview
+ *
+ *
+ * \section asfdoc_sam0_eeprom_prerequisites Prerequisites
+ *
+ * The SAM device fuses must be configured via an external programmer or
+ * debugger, so that an EEPROM section is allocated in the main NVM flash
+ * memory contents. If a NVM section is not allocated for the EEPROM emulator,
+ * or if insufficient space for the emulator is reserved, the module will fail
+ * to initialize.
+ *
+ *
+ * \section asfdoc_sam0_eeprom_module_overview Module Overview
+ *
+ * As the SAM devices do not contain any physical EEPROM memory, the storage
+ * of non-volatile user data is instead emulated using a special section of the
+ * device's main FLASH memory. The use of FLASH memory technology over EEPROM
+ * presents several difficulties over true EEPROM memory; data must be written
+ * as a number of physical memory pages (of several bytes each) rather than
+ * being individually byte addressable, and entire rows of FLASH must be erased
+ * before new data may be stored. To help abstract these characteristics away
+ * from the user application an emulation scheme is implemented to present a
+ * more user-friendly API for data storage and retrieval.
+ *
+ * This module provides an EEPROM emulation layer on top of the device's
+ * internal NVM controller, to provide a standard interface for the reading and
+ * writing of non-volatile configuration data. This data is placed into the
+ * EEPROM emulated section of the device's main FLASH memory storage section,
+ * the size of which is configured using the device's fuses. Emulated EEPROM is
+ * exempt from the usual device NVM region lock bits, so that it may be read
+ * from or written to at any point in the user application.
+ *
+ * There are many different algorithms that may be employed for EEPROM emulation
+ * using FLASH memory, to tune the write and read latencies, RAM usage, wear
+ * levelling and other characteristics. As a result, multiple different emulator
+ * schemes may be implemented, so that the most appropriate scheme for a
+ * specific application's requirements may be used.
+ *
+ * \subsection asfdoc_sam0_eeprom_module_overview_implementation Implementation Details
+ * The following information is relevant for <b>EEPROM Emulator scheme 1,
+ * version 1.0.0</b>, as implemented by this module. Other revisions or
+ * emulation schemes may vary in their implementation details and may have
+ * different wear-leveling, latency, and other characteristics.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_ec Emulator Characteristics
+ * This emulator is designed for <b>best reliability, with a good balance of
+ * available storage and write-cycle limits</b>. It is designed to ensure that
+ * page data is automatically updated so that in the event of a failed update the
+ * previous data is not lost (when used correctly). With the exception of a
+ * system reset with data cached to the internal write-cache buffer, at most
+ * only the latest write to physical non-volatile memory will be lost in the
+ * event of a failed write.
+ *
+ * This emulator scheme is tuned to give best write-cycle longevity when writes
+ * are confined to the same logical EEPROM page (where possible) and when writes
+ * across multiple logical EEPROM pages are made in a linear fashion through the
+ * entire emulated EEPROM space.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_pf Physical Memory
+ * The SAM non-volatile FLASH is divided into a number of physical rows, each
+ * containing four identically sized flash pages. Pages may be read or written
+ * to individually, however pages must be erased before being reprogrammed and
+ * the smallest granularity available for erasure is one single row.
+ *
+ * This discrepancy results in the need for an emulator scheme that is able to
+ * handle the versioning and moving of page data to different physical rows as
+ * needed, erasing old rows ready for re-use by future page write operations.
+ *
+ * Physically, the emulated EEPROM segment is located at the end of the physical
+ * FLASH memory space, as shown in
+ * \ref asfdoc_sam0_eeprom_module_mem_layout "the figure below".
+ *
+ * \anchor asfdoc_sam0_eeprom_module_mem_layout
+ * \dot
+ * digraph memory_layout {
+ *  size="5,5"
+ *  node [shape=plaintext]
+ *  memory [label=<
+ *   <table border="0" cellborder="1" cellspacing="0" >
+ *    <tr>
+ *     <td align="right" border="0"> End of NVM Memory </td>
+ *     <td rowspan="3" align="center"> Reserved EEPROM Section </td>
+ *    </tr>
+ *    <tr>
+ *     <td align="right" border="0"> </td>
+ *    </tr>
+ *    <tr>
+ *     <td align="right" border="0"> Start of EEPROM Memory </td>
+ *    </tr>
+ *    <tr>
+ *     <td align="right" border="0"> End of Application Memory </td>
+ *     <td rowspan="3" align="center"> Application Section </td>
+ *    </tr>
+ *    <tr>
+ *     <td height="300" align="right" border="0"> </td>
+ *    </tr>
+ *    <tr>
+ *     <td align="right" border="0"> Start of Application Memory </td>
+ *    </tr>
+ *    <tr>
+ *     <td align="right" border="0"> End of Bootloader Memory </td>
+ *     <td rowspan="3" align="center"> BOOT Section </td>
+ *    </tr>
+ *    <tr>
+ *     <td align="right" border="0"> </td>
+ *    </tr>
+ *    <tr>
+ *     <td align="right" border="0"> Start of NVM Memory</td>
+ *    </tr>
+ *   </table>
+ *  >]
+ * }
+ * \enddot
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_mp Master Row
+ * One physical FLASH row at the end of the emulated EEPROM memory space is
+ * reserved for use by the emulator to store configuration data. The master row
+ * is not user-accessible, and is reserved solely for internal use by the
+ * emulator.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_sr Spare Row
+ * As data needs to be preserved between row erasures, a single FLASH row is kept
+ * unused to act as destination for copied data when a write request is made to
+ * an already full row. When the write request is made, any logical pages of
+ * data in the full row that need to be preserved are written to the spare row
+ * along with the new (updated) logical page data, before the old row is erased
+ * and marked as the new spare.
+ *
+ * With page CRCs enabled, a pool of \c EEPROM_SPARE_ROWS spare rows may be kept
+ * instead, at the cost of two logical pages per additional row. A row moved to
+ * an erased spare row then joins the pool without being erased, as the
+ * sequence numbers of its pages tell them apart from the newer copies; it is
+ * only erased once no erased spare row is left, or in the background by
+ * \ref eeprom_emulator_compact(). A burst of row moves thus waits for no row
+ * erase until the pool runs out. The pool is found again at initialization as
+ * the rows holding no current logical page.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_crc Page Integrity
+ * When \c EEPROM_PAGE_CRC is enabled, each page header also holds a sequence
+ * number, incremented for every new revision of its logical page, and a
+ * CRC-16 of the header and the page contents. The page flags are left out of
+ * the CRC, as they may be programmed again, and so are the contents of delta
+ * record pages, which grow as records are appended; their replay stops at
+ * the first incomplete record instead.
+ *
+ * At initialization, pages with a bad CRC are ignored, and each logical page
+ * is mapped to its revision with the highest sequence number, wherever it is
+ * stored. If a reset interrupted a row move and no erased row is left, the
+ * move is completed or rolled back: a row whose first two pages are not both
+ * intact, as left by a partial copy, or else a row of which no page is mapped
+ * any longer, is erased to become the spare row again.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_wl Wear Leveling
+ * As the logical pages written most often are moved to the spare row whenever
+ * their row is full, they keep alternating between the same two physical rows
+ * while other rows are hardly ever erased. When
+ * \c EEPROM_WEAR_LEVELING_THRESHOLD is non-zero, each page header records how
+ * many times its row had been erased. Whenever a row move leaves a spare row
+ * whose erase count exceeds that of the least worn data row by more than the
+ * threshold, the contents of the least worn row are moved into the spare row
+ * as well, and the least worn row becomes the new spare row.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_md Metadata Row
+ * When \c EEPROM_METADATA_ROW is enabled, the FLASH row just below the master
+ * row is reserved for emulator metadata, reducing the number of logical pages
+ * by two. It holds checkpoints of the logical to physical page map, the row
+ * fill levels and the spare row, each with a generation number and a checksum.
+ * At initialization the newest valid checkpoint is loaded, and only the rows
+ * written after it was taken are scanned; the full scan of every physical
+ * page is still used whenever no checkpoint can be trusted, and a new
+ * checkpoint is written afterwards. Formatting the memory erases the metadata
+ * row before any data row, so that no checkpoint outlives the rows it maps.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_rc Row Contents
+ * Each physical FLASH row initially stores the contents of two logical EEPROM
+ * memory pages. This halves the available storage space for the emulated EEPROM
+ * but reduces the overall number of row erases that are required, by reserving
+ * two pages within each row for updated versions of the logical page contents.
+ * See \ref asfdoc_sam0_eeprom_init_layout "here" for a visual layout of the
+ * EEPROM Emulator physical memory.
+ *
+ * As logical pages within a physical row are updated, the new data is filled
+ * into the remaining unused pages in the row. Once the entire row is full, a
+ * new write request will copy the logical page not being written to in the
+ * current row to the spare row with the new (updated) logical page data, before
+ * the old row is erased.
+ *
+ * This system allows for the same logical page to be updated up to three times
+ * into physical memory before a row erasure procedure is needed. In the case of
+ * multiple versions of the same logical EEPROM page being stored in the same
+ * physical row, the right-most (highest physical FLASH memory page address)
+ * version is considered to be the most current.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_dr Delta Records
+ * When \c EEPROM_DELTA_RECORDS is enabled, a committed update that changes
+ * only a few bytes of a logical page is stored as a delta record instead of a
+ * full page revision. A record holds the offset and length of the changed
+ * span of the page, followed by the new bytes. Records of a logical page are
+ * appended to a delta page in the same row, which is marked as such in its
+ * header, by programming only the erased bytes following the previous record.
+ * A new delta page is started in a free page of the row once the current one
+ * is full.
+ *
+ * Reading a logical page replays its delta records over the newest full
+ * revision in the row. When the row is moved to the spare row, the full
+ * contents of both logical pages are written out and the records are
+ * discarded. Many small updates can thus be stored in a row before it needs
+ * an erase.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_tr Transactions
+ * When \c EEPROM_TRANSACTION_PAGES is non-zero, several logical pages may be
+ * updated atomically. Page writes made between
+ * \ref eeprom_emulator_begin_transaction() and
+ * \ref eeprom_emulator_commit_transaction() are staged in SRAM. On commit,
+ * rows without enough free pages are first moved to the spare row. The staged
+ * pages are then written with a staged flag in their headers, the last one
+ * also carrying a commit flag, and each page is finally programmed again to
+ * mark it as published, the page with the commit flag last.
+ *
+ * At initialization, staged pages that were not published are published if
+ * the commit flag of their transaction is found, and marked as discarded
+ * otherwise; discarded pages are never mapped to their logical page again.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_wc Write Cache
+ * As a typical EEPROM use case is to write to multiple sections of the same
+ * EEPROM page sequentially, the emulator is optimized with a logical EEPROM
+ * page write-back cache to buffer writes before they are written to the
+ * physical backing memory store. The cache holds up to \c EEPROM_CACHE_ENTRIES
+ * logical pages (one by default); when a write request is made to a page that
+ * is not cached and the cache is full, the least recently written page is
+ * committed to make room for it. All cached pages are committed when the user
+ * manually commits the write cache.
+ *
+ * A free page is kept in each physical row for every cached page stored in the
+ * row; if a row has none left when a page is cached, the row is moved to the
+ * spare row immediately. Committing the cache therefore never requires a row
+ * erase.
+ *
+ * Write requests that would not change the contents of a logical page, as
+ * found in the write cache or in physical memory, are skipped entirely.
+ *
+ * Without the write cache, each write request to an EEPROM memory page would
+ * require a full page write, reducing the system performance and significantly
+ * reducing the lifespan of the non-volatile memory.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_nb Non-blocking Writes
+ * A row move takes two page writes and a row erase, during which
+ * \ref eeprom_emulator_write_page() and
+ * \ref eeprom_emulator_commit_page_buffer() wait for the NVM controller. For
+ * applications that must keep servicing events meanwhile,
+ * \ref eeprom_emulator_write_page_async() only stores the new page contents in
+ * a free write cache entry, and \ref eeprom_emulator_poll() then starts one NVM
+ * operation at a time towards committing the cache, returning \c STATUS_BUSY
+ * until it is fully committed. A row move started this way is resumed by the
+ * next call to \ref eeprom_emulator_poll(), or completed straight away by the
+ * blocking functions.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_bc Background Compaction
+ * A write to a logical page whose row has no free page left moves the row to
+ * the spare row first. \ref eeprom_emulator_compact() does these moves ahead
+ * of time, one NVM operation per call, for rows with at most
+ * \c EEPROM_COMPACTION_FREE_PAGES free pages left, and then erases the rows of
+ * the spare row pool waiting for it. Calling it while the application is idle
+ * keeps the foreground writes down to a single page write. Row moves that a
+ * blocking call still had to wait for are counted in the emulator statistics.
+ * Compaction trades wear for latency: the row of a page written alone is
+ * erased every two writes instead of every three, or every write with
+ * \c EEPROM_COMPACTION_FREE_PAGES set to one. Applications whose writes may
+ * wait for a row erase, such as the Find Me application, do not call it.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_zc Zero-copy Reads
+ * As the physical memory is memory mapped, \ref eeprom_emulator_map_page()
+ * can point a page view straight at the stored page contents instead of
+ * copying them, which suits parsers reading a few fields of a page. Each view
+ * holds the value of a counter that the emulator changes on every page write,
+ * transaction abort and row erase; \ref eeprom_emulator_page_view_is_valid()
+ * compares it to tell whether the view may be stale and must be mapped again.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_cache Read Cache
+ * Reading a page that is not in the write cache copies it out of the physical
+ * memory, replaying its delta records if it has any. With
+ * \c EEPROM_READ_CACHE_ENTRIES set, the contents of the pages read most
+ * recently are also kept in SRAM, so that configuration and index pages
+ * looked up over and over are copied straight from there. An entry is dropped
+ * when its page is written; row moves keep the contents of the pages, and
+ * leave the entries in place. Hits and misses are counted in the emulator
+ * statistics, to size the cache against the SRAM it takes.
+ *
+ * \subsubsection asfdoc_sam0_eeprom_module_overview_implementation_fm Format Migration
+ * The physical layout options are recorded in the master page, and
+ * \ref eeprom_emulator_init() fails with \c STATUS_ERR_IO when they differ
+ * from the configuration. \c EEPROM_FORMAT_MIGRATION is off by default, and
+ * must be enabled in the firmware build that changes the layout options;
+ * \ref eeprom_emulator_migrate() then rewrites the memory into the configured
+ * layout one row per call: the newest revision of each logical page held by a
+ * row is written to an erased row in the new page format, starting with the
+ * spare row, and the old row is erased to receive the next one. The logical
+ * page numbers and contents are kept; a migration that would drop logical
+ * pages or page bytes that are not erased is refused, leaving the memory
+ * untouched.
+ *
+ * The progress is kept in the three unused pages of the master row: the rows
+ * that were free when the migration started, one bit per rewritten row, and
+ * the new master page, which replaces the old one once every row has been
+ * rewritten. A migration interrupted by a reset resumes where it stopped,
+ * redoing at most the row in progress. The master row is erased again before
+ * a later migration starts; the master page is first copied to an erased data
+ * row, from which initialization reads it and the migration restores it if a
+ * reset cuts the rewrite of the master row short.
+ *
+ * \subsection asfdoc_sam0_eeprom_special_considerations_memlayout Memory Layout
+ * A single logical EEPROM page is physically stored as the page contents and a
+ * header inside a single physical FLASH page, as shown in
+ * \ref asfdoc_sam0_eeprom_page_layout "the following figure".
+ *
+ * \anchor asfdoc_sam0_eeprom_page_layout
+ * \image html page_layout.svg "Internal Layout of An Emulated EEPROM Page"
+ *
+ * Within the EEPROM memory reservation section at the top of the NVM memory
+ * space, this emulator will produce the layout as shown in
+ * \ref asfdoc_sam0_eeprom_init_layout "the figure below" when initialized for
+ * the first time.
+ *
+ * \anchor asfdoc_sam0_eeprom_init_layout
+ * \image html init_layout.svg "Initial Physical Layout of The Emulated EEPROM Memory"
+ *
+ * When an EEPROM page needs to be committed to physical memory, the next free
+ * FLASH page in the same row will be chosen - this makes recovery simple, as the
+ * right-most version of a logical page in a row is considered the most current.
+ * With four pages to a physical NVM row, this allows for up to three updates to
+ * the same logical page to be made before an erase is needed.
+ * \ref asfdoc_sam0_eeprom_page_write1 "The figure below" shows the result of
+ * the user writing an updated version of logical EEPROM page <tt>N-1</tt> to
+ * the physical memory.
+ *
+ * \anchor asfdoc_sam0_eeprom_page_write1
+ * \image html nm1_page_write.svg "First Write to Logical EEPROM Page N-1"
+ *
+ * A second write of the same logical EEPROM page results in the layout shown
+ * in \ref asfdoc_sam0_eeprom_page_write2 "the figure below".
+ *
+ * \anchor asfdoc_sam0_eeprom_page_write2
+ * \image html nm1_page_write2.svg "Second Write to Logical EEPROM Page N-1"
+ *
+ * A third write of the same logical page requires that the EEPROM emulator
+ * erase the row, as it has become full. Prior to this, the contents of the
+ * unmodified page in the same row as the page being updated will be copied into
+ * the spare row, along with the new version of the page being updated. The old
+ * (full) row is then erased, resulting in the layout shown in
+ * \ref asfdoc_sam0_eeprom_page_write3 "the figure below".
+ *
+ * \anchor asfdoc_sam0_eeprom_page_write3
+ * \image html nm1_page_write3.svg "Third Write to Logical EEPROM Page N-1"
+ *
+ *
+ * \section asfdoc_sam0_eeprom_special_considerations Special Considerations
+ *
+ * \subsection asfdoc_sam0_eeprom_special_considerations_nvm_config NVM Controller Configuration
+ * The EEPROM Emulator service will initialize the NVM controller as part of its
+ * own initialization routine; the NVM controller will be placed in Manual Write
+ * mode, so that explicit write commands must be sent to the controller to
+ * commit a buffered page to physical memory. The manual write command must thus
+ * be issued to the NVM controller whenever the user application wishes to write
+ * to a NVM page for its own purposes.
+ *
+ * \subsection asfdoc_sam0_eeprom_special_considerations_pagesize Logical EEPROM Page Size
+ * As a small amount of information needs to be stored in a header before the
+ * contents of a logical EEPROM page in memory (for use by the emulation
+ * service), the available data in each EEPROM page is less than the total size
+ * of a single NVM memory page by several bytes.
+ *
+ * \subsection asfdoc_sam0_eeprom_special_considerations_committing Committing of the Write Cache
+ * A page write cache is used internally to buffer data written to pages
+ * in order to reduce the number of physical writes required to store the user
+ * data, and to preserve the physical memory lifespan. As a result, it is
+ * important that the write cache is committed to physical memory <b>as soon as
+ * possible after a BOD low power condition</b>, to ensure that enough power is
+ * available to guarantee a completed write so that no data is lost.
+ *
+ * The write cache must also be manually committed to physical memory if the
+ * user application is to perform any NVM operations using the NVM controller
+ * directly.
+ *
+ * \subsection asfdoc_sam0_eeprom_special_considerations_host Host NVM Backend
+ * The emulator may be built for a development host by defining
+ * \c EEPROM_EMULATOR_HOST_NVM, in which case the NVM driver is replaced by the
+ * RAM-backed FLASH model declared in eeprom_host_nvm.h. The model enforces
+ * FLASH programming and erase semantics and counts every NVM operation, so that
+ * the write, erase and timing cost of application workloads may be measured
+ * without a device.
+ *
+ *
+ * \section asfdoc_sam0_eeprom_extra_info Extra Information
+ *
+ * For extra information, see \ref asfdoc_sam0_eeprom_extra. This includes:
+ *  - \ref asfdoc_sam0_eeprom_extra_acronyms
+ *  - \ref asfdoc_sam0_eeprom_extra_dependencies
+ *  - \ref asfdoc_sam0_eeprom_extra_errata
+ *  - \ref asfdoc_sam0_eeprom_extra_history
+ *
+ *
+ * \section asfdoc_sam0_eeprom_examples Examples
+ *
+ * For a list of examples related to this driver, see
+ * \ref asfdoc_sam0_eeprom_exqsg.
+ *
+ *
+ * \section asfdoc_sam0_eeprom_api_overview API Overview
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(EEPROM_EMULATOR_HOST_NVM)
+#  include "eeprom_host_nvm.h"
+#else
+#  include <compiler.h>
+#endif
+
+#if !defined(__DOXYGEN__)
+#  define EEPROM_MAX_PAGES            \
+		(((EEPROM_WIDE_PAGE_INDEX == true) ? 256 : 64) * NVMCTRL_ROW_PAGES)
+#  define EEPROM_MASTER_PAGE_NUMBER   (_eeprom_emulator_physical_pages() - 1)
+#  define EEPROM_INVALID_PAGE_NUMBER  ((EEPROM_WIDE_PAGE_INDEX == true) ? 0xFFFF : 0xFF)
+#  define EEPROM_INVALID_ROW_NUMBER   ((EEPROM_MAX_PAGES - 1) / NVMCTRL_ROW_PAGES)
+#  define EEPROM_HEADER_SIZE          (((EEPROM_PAGE_CRC == true) ? 8 : 4) + \
+		((EEPROM_WIDE_PAGE_INDEX == true) ? 2 : 0))
+#endif
+
+
+/** \name EEPROM Emulator Configuration
+ * @{
+ */
+
+#if !defined(EEPROM_METADATA_ROW) || defined(__DOXYGEN__)
+/** Reserve one FLASH row, just below the master row, for emulator metadata
+ *  such as fast-mount checkpoints of the logical to physical page map. This
+ *  changes the physical layout of the emulated EEPROM, and is recorded in the
+ *  master page. */
+#  define EEPROM_METADATA_ROW         false
+#endif
+
+#if !defined(EEPROM_PAGE_CRC) || defined(__DOXYGEN__)
+/** Store a sequence number and a CRC in the header of each page, so that torn
+ *  page writes are detected and the newest intact revision of each logical
+ *  page is found after a reset. This enlarges the page header by four bytes,
+ *  reducing \ref EEPROM_PAGE_SIZE accordingly. It changes the physical layout
+ *  of the emulated EEPROM, and is recorded in the master page. */
+#  define EEPROM_PAGE_CRC             false
+#endif
+
+#if !defined(EEPROM_DELTA_RECORDS) || defined(__DOXYGEN__)
+/** Store small updates of a logical page as delta records appended to pages
+ *  of its row, instead of full page revisions. This programs already written
+ *  FLASH pages again, only ever writing bytes that are still erased. It
+ *  changes the physical layout of the emulated EEPROM, and is recorded in the
+ *  master page. */
+#  define EEPROM_DELTA_RECORDS        false
+#endif
+
+#if !defined(EEPROM_TRANSACTION_PAGES) || defined(__DOXYGEN__)
+/** Maximum number of logical pages written within a single transaction, or
+ *  zero to disable transactions. Enabling transactions changes the physical
+ *  layout of the emulated EEPROM, and is recorded in the master page. */
+#  define EEPROM_TRANSACTION_PAGES    0
+#endif
+
+#if !defined(EEPROM_WEAR_LEVELING_THRESHOLD) || defined(__DOXYGEN__)
+/** Difference in erase counts between the spare row and the least worn data
+ *  row above which their roles are swapped, or zero to disable wear leveling.
+ *  Erase counts are kept in the page headers. */
+#  define EEPROM_WEAR_LEVELING_THRESHOLD  0
+#endif
+
+#if !defined(EEPROM_CACHE_ENTRIES) || defined(__DOXYGEN__)
+/** Number of logical pages held in the SRAM write-back cache. */
+#  define EEPROM_CACHE_ENTRIES        1
+#endif
+
+#if !defined(EEPROM_READ_CACHE_ENTRIES) || defined(__DOXYGEN__)
+/** Number of logical pages held in the SRAM read cache, or zero to disable
+ *  it. Each entry takes \ref EEPROM_PAGE_SIZE bytes plus eight bytes of
+ *  bookkeeping. */
+#  define EEPROM_READ_CACHE_ENTRIES   0
+#endif
+
+#if (EEPROM_READ_CACHE_ENTRIES > 255)
+#  error EEPROM_READ_CACHE_ENTRIES must be at most 255.
+#endif
+
+#if !defined(EEPROM_SPARE_ROWS) || defined(__DOXYGEN__)
+/** Number of spare rows kept to receive the contents of full rows. More than
+ *  one spare row lets rows be moved without waiting for a row erase, and
+ *  requires \ref EEPROM_PAGE_CRC. Each additional spare row reduces the number
+ *  of logical pages by two. This changes the physical layout of the emulated
+ *  EEPROM, and is recorded in the master page. */
+#  define EEPROM_SPARE_ROWS           1
+#endif
+
+#if (EEPROM_SPARE_ROWS < 1) || ((EEPROM_SPARE_ROWS > 1) && (EEPROM_PAGE_CRC != true))
+#  error EEPROM_SPARE_ROWS must be one, or more with EEPROM_PAGE_CRC enabled.
+#endif
+
+#if !defined(EEPROM_COMPACTION_FREE_PAGES) || defined(__DOXYGEN__)
+/** Number of free pages at or below which a row is moved to the spare row by
+ *  \ref eeprom_emulator_compact(), either zero or one. Zero only moves full
+ *  rows, which then take two page writes between erases instead of three, as
+ *  the write that would have moved the row is no longer part of the move. One
+ *  also moves rows with a single free page left, leaving room for two writes
+ *  before the next idle period but taking only one write between erases. */
+#  define EEPROM_COMPACTION_FREE_PAGES  0
+#endif
+
+#if (EEPROM_COMPACTION_FREE_PAGES > 1)
+#  error EEPROM_COMPACTION_FREE_PAGES must be zero or one.
+#endif
+
+#if !defined(EEPROM_WIDE_PAGE_INDEX) || defined(__DOXYGEN__)
+/** Store 16-bit page numbers in the page headers and the page map, so that
+ *  the emulated EEPROM may span up to 1024 physical pages instead of 256.
+ *  This enlarges the page header by two bytes, reducing
+ *  \ref EEPROM_PAGE_SIZE accordingly, and doubles the size of the page map
+ *  in SRAM. It changes the physical layout of the emulated EEPROM, and is
+ *  recorded in the master page. */
+#  define EEPROM_WIDE_PAGE_INDEX      false
+#endif
+
+#if (EEPROM_WIDE_PAGE_INDEX == true) && (EEPROM_METADATA_ROW == true)
+#  error EEPROM_METADATA_ROW checkpoints do not fit a metadata row with EEPROM_WIDE_PAGE_INDEX.
+#endif
+
+#if !defined(EEPROM_PHYSICAL_PAGES) || defined(__DOXYGEN__)
+/** Number of physical FLASH pages reserved for the emulated EEPROM by the
+ *  device fuses, or zero to read it from the NVM controller at
+ *  initialization. A fixed number turns the emulator geometry into compile
+ *  time constants and sizes its SRAM tables exactly, in which case
+ *  initialization fails if the fuses reserve a different number of pages. */
+#  define EEPROM_PHYSICAL_PAGES       0
+#endif
+
+#if !defined(EEPROM_FORMAT_MIGRATION) || defined(__DOXYGEN__)
+/** Allow emulated EEPROM memory written with another physical layout of the
+ *  same emulator scheme to be rewritten into the layout of this configuration
+ *  by \ref eeprom_emulator_migrate(), instead of having to be erased. Adds
+ *  about 4 KB of code, so it is off by default; the firmware build that
+ *  changes the layout options must enable it. */
+#  define EEPROM_FORMAT_MIGRATION     false
+#endif
+
+#if (EEPROM_PHYSICAL_PAGES != 0) && \
+		((EEPROM_PHYSICAL_PAGES % NVMCTRL_ROW_PAGES) || \
+		(EEPROM_PHYSICAL_PAGES > EEPROM_MAX_PAGES) || \
+		(EEPROM_PHYSICAL_PAGES < ((2 + EEPROM_SPARE_ROWS + \
+			(EEPROM_METADATA_ROW == true)) * NVMCTRL_ROW_PAGES)))
+#  error EEPROM_PHYSICAL_PAGES must be zero or a valid fuse setting for the emulator rows.
+#endif
+
+/** @} */
+
+/** \name EEPROM Emulator Information
+ * @{
+ */
+
+/** Emulator scheme ID, identifying the scheme used to emulated EEPROM storage. */
+#define EEPROM_EMULATOR_ID          1
+
+/** Emulator major version number, identifying the emulator major version. */
+#define EEPROM_MAJOR_VERSION        1
+
+/** Emulator minor version number, identifying the emulator minor version. */
+#define EEPROM_MINOR_VERSION        0
+
+/** Emulator revision version number, identifying the emulator revision. */
+#define EEPROM_REVISION             0
+
+/** Size of the user data portion of each logical EEPROM page, in bytes. */
+#define EEPROM_PAGE_SIZE            (NVMCTRL_PAGE_SIZE - EEPROM_HEADER_SIZE)
+
+/**
+ * \brief EEPROM memory parameter structure.
+ *
+ * Structure containing the memory layout parameters of the EEPROM emulator module.
+ */
+struct eeprom_emulator_parameters {
+	/** Number of bytes per emulated EEPROM page. */
+	uint8_t  page_size;
+	/** Number of emulated pages of EEPROM. */
+	uint16_t eeprom_number_of_pages;
+};
+
+/**
+ * \brief EEPROM emulator statistics structure.
+ *
+ * Structure containing the usage counters of the EEPROM emulator module, kept
+ * since it was last initialized.
+ */
+struct eeprom_emulator_statistics {
+	/** Number of page writes skipped as they did not change the page. */
+	uint32_t elided_writes;
+	/** Number of page updates stored as delta records. */
+	uint32_t delta_records;
+	/** Number of rows moved to level the wear of the physical memory. */
+	uint32_t wear_leveling_moves;
+	/** Number of rows moved in the background by
+	 *  \ref eeprom_emulator_compact(). */
+	uint32_t compaction_moves;
+	/** Number of row moves that a blocking call had to wait for. */
+	uint32_t blocking_moves;
+	/** Number of page reads served by the read cache. */
+	uint32_t read_cache_hits;
+	/** Number of page reads copied out of the physical memory while the read
+	 *  cache is enabled. Reads served by the write cache or a transaction
+	 *  are counted in neither. */
+	uint32_t read_cache_misses;
+};
+
+/**
+ * \brief EEPROM page view structure.
+ *
+ * Read-only view of the contents of a logical EEPROM page, set up by
+ * \ref eeprom_emulator_map_page().
+ */
+struct eeprom_emulator_page_view {
+	/** Pointer to the page contents. */
+	const uint8_t *data;
+	/** Number of bytes of page contents. */
+	uint8_t length;
+	/** Emulator state the view was mapped in, checked by
+	 *  \ref eeprom_emulator_page_view_is_valid(). */
+	uint32_t generation;
+};
+
+/**
+ * \brief EEPROM buffer segment structure.
+ *
+ * Source buffer of one of the consecutive parts of the data written by
+ * \ref eeprom_emulator_write_segments().
+ */
+struct eeprom_emulator_segment {
+	/** Pointer to the source data of the segment. */
+	const uint8_t *data;
+	/** Length of the segment, in bytes. */
+	uint16_t length;
+};
+
+#if (EEPROM_FORMAT_MIGRATION == true) || defined(__DOXYGEN__)
+/**
+ * \brief EEPROM format migration progress structure.
+ *
+ * Structure containing the progress of a migration of the emulated EEPROM
+ * memory to the current physical layout, filled by
+ * \ref eeprom_emulator_migrate().
+ */
+struct eeprom_emulator_migration {
+	/** Number of rows rewritten in the current layout so far. */
+	uint8_t rows_done;
+	/** Number of rows rewritten by the whole migration. */
+	uint8_t rows_total;
+};
+#endif
+
+/** @} */
+
+/** \name Configuration and Initialization
+ * @{
+ */
+
+enum status_code eeprom_emulator_init(void);
+
+void eeprom_emulator_erase_memory(void);
+
+enum status_code eeprom_emulator_get_parameters(
+		struct eeprom_emulator_parameters *const parameters);
+
+enum status_code eeprom_emulator_get_statistics(
+		struct eeprom_emulator_statistics *const statistics);
+
+#if (EEPROM_METADATA_ROW == true) || defined(__DOXYGEN__)
+enum status_code eeprom_emulator_checkpoint(void);
+#endif
+
+#if (EEPROM_FORMAT_MIGRATION == true) || defined(__DOXYGEN__)
+enum status_code eeprom_emulator_migrate(
+		struct eeprom_emulator_migration *const progress);
+#endif
+
+/** @} */
+
+
+/** \name Logical EEPROM Page Reading/Writing
+ * @{
+ */
+
+enum status_code eeprom_emulator_commit_page_buffer(void);
+
+enum status_code eeprom_emulator_write_page(
+		const uint16_t logical_page,
+		const uint8_t *const data);
+
+enum status_code eeprom_emulator_read_page(
+		const uint16_t logical_page,
+		uint8_t *const data);
+
+enum status_code eeprom_emulator_map_page(
+		const uint16_t logical_page,
+		struct eeprom_emulator_page_view *const view);
+
+bool eeprom_emulator_page_view_is_valid(
+		const struct eeprom_emulator_page_view *const view);
+
+enum status_code eeprom_emulator_write_page_async(
+		const uint16_t logical_page,
+		const uint8_t *const data);
+
+enum status_code eeprom_emulator_poll(void);
+
+enum status_code eeprom_emulator_compact(void);
+
+/** @} */
+
+#if (EEPROM_TRANSACTION_PAGES > 0) || defined(__DOXYGEN__)
+/** \name Transactions
+ * @{
+ */
+
+enum status_code eeprom_emulator_begin_transaction(void);
+
+enum status_code eeprom_emulator_commit_transaction(void);
+
+enum status_code eeprom_emulator_abort_transaction(void);
+
+/** @} */
+#endif
+
+/** \name Buffer EEPROM Reading/Writing
+ * @{
+ */
+
+enum status_code eeprom_emulator_write_buffer(
+		const uint16_t offset,
+		const uint8_t *const data,
+		const uint16_t length);
+
+enum status_code eeprom_emulator_write_segments(
+		const uint16_t offset,
+		const struct eeprom_emulator_segment *const segments,
+		const uint8_t segment_count);
+
+enum status_code eeprom_emulator_read_buffer(
+		const uint16_t offset,
+		uint8_t *const data,
+		const uint16_t length);
+
+/** @} */
+
+/** \name Checksums
+ * @{
+ */
+
+uint16_t eeprom_emulator_crc16(
+		uint16_t crc,
+		const uint8_t *const data,
+		const uint16_t length);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+/**
+ * \page asfdoc_sam0_eeprom_extra Extra Information
+ *
+ * \section asfdoc_sam0_eeprom_extra_acronyms Acronyms
+ * Below is a table listing the acronyms used in this module, along with their
+ * intended meanings.
+ *
+ * <table>
+ *	<tr>
+ *		<th>Acronym</th>
+ *		<th>Description</th>
+ *	</tr>
+ *	<tr>
+ *		<td>EEPROM</td>
+ *		<td>Electronically Erasable Read-Only Memory</td>
+ *	</tr>
+ *	<tr>
+ *		<td>NVM</td>
+ *		<td>Non-Volatile Memory</td>
+ *	</tr>
+ * </table>
+ *
+ *
+ * \section asfdoc_sam0_eeprom_extra_dependencies Dependencies
+ * This driver has the following dependencies:
+ *
+ *  - \ref asfdoc_sam0_nvm_group "Non-Volatile Memory Controller Driver"
+ *
+ *
+ * \section asfdoc_sam0_eeprom_extra_errata Errata
+ * There are no errata related to this driver.
+ *
+ *
+ * \section asfdoc_sam0_eeprom_extra_history Module History
+ * An overview of the module history is presented in the table below, with
+ * details on the enhancements and fixes made to the module since its first
+ * release. The current version of this corresponds to the newest version in
+ * the table.
+ *
+ * <table>
+ *	<tr>
+ *		<th>Changelog</th>
+ *	</tr>
+ *	<tr>
+ *		<td>Fix warnings</td>
+ *	</tr>
+ *	<tr>
+ *		<td>Initial Release</td>
+ *	</tr>
+ * </table>
+ */
+
+/**
+ * \page asfdoc_sam0_eeprom_exqsg Examples for Emulated EEPROM Service
+ *
+ * This is a list of the available Quick Start guides (QSGs) and example
+ * applications for \ref asfdoc_sam0_eeprom_group. QSGs are simple examples with
+ * step-by-step instructions to configure and use this driver in a selection of
+ * use cases. Note that QSGs can be compiled as a standalone application or be
+ * added to the user application.
+ *
+ *  - \subpage asfdoc_sam0_eeprom_basic_use_case
+ *
+ * \page asfdoc_sam0_eeprom_document_revision_history Document Revision History
+ *
+ * <table>
+ *	<tr>
+ *		<th>Doc. Rev.</th>
+ *		<th>Date</th>
+ *		<th>Comments</th>
+ *	</tr>
+ *	<tr>
+ *		<td>42125F</td>
+ *		<td>12/2015</td>
+ *		<td>Added support for SAM L22, SAM DA1, and SAM C20/C21</td>
+ *	</tr>
+ *	<tr>
+ *		<td>42125E</td>
+ *		<td>11/2014</td>
+ *		<td>Added support for SAM L21</td>
+ *	</tr>
+ *	<tr>
+ *		<td>42125D</td>
+ *		<td>09/2014</td>
+ *		<td>Added support for SAM R21, and SAM D10/D11</td>
+ *	</tr>
+ *	<tr>
+ *		<td>42125C</td>
+ *		<td>07/2014</td>
+ *		<td>Add support for SAM D21</td>
+ *	</tr>
+ *  <tr>
+ *	   <td>42125B</td>
+ *	   <td>11/2013</td>
+ *     <td>
+ *        - ASF 3.13: Fixed bugs related to eeprom_emulator_write_buffer() and
+ *          eeprom_emulator_read_buffer(). The functions now handle offsets that
+ *          are multiples of 60. The length can now be smaller than one page without
+ *          risking corruption. Addresses that are multiples of 60 will be written
+ *          correctly
+ *        - Updated module figures and re-worded the module overview. Corrected
+ *          documentation typos
+ *     </td>
+ *	</tr>
+ *	<tr>
+ *		<td>42125A</td>
+ *		<td>06/2013</td>
+ *		<td>Initial release</td>
+ *	</tr>
+ * </table>
+ */
+
+#endif /* EEPROM_H_INCLUDED */
@@ -0,0 +1,179 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator write coalescing commit policy
+ *
+ * Time window and update count commit policy; see eeprom_commit.h.
+ */
+#include "eeprom_commit.h"
+
+/**
+ * \internal
+ * \brief Internal commit policy instance struct.
+ */
+struct _eeprom_commit_module {
+	/** Number of updates held since the write cache was last committed. */
+	uint16_t updates;
+	/** Time of the oldest update held, in milliseconds. */
+	uint32_t first_update_ms;
+	/** Whether the write cache is being committed. */
+	bool committing;
+};
+
+/**
+ * \internal
+ * \brief Internal commit policy instance.
+ */
+static struct _eeprom_commit_module _eeprom_commit;
+
+/** \internal
+ *  \brief Checks whether the oldest held update has waited for the window.
+ *
+ *  \param[in] time_ms  Current time, in milliseconds
+ */
+static inline bool _eeprom_commit_window_elapsed(
+		const uint32_t time_ms)
+{
+#if (EEPROM_COMMIT_WINDOW_MS > 0)
+	/* The difference is correct across a wrap of the millisecond counter */
+	return ((uint32_t)(time_ms - _eeprom_commit.first_update_ms) >=
+			EEPROM_COMMIT_WINDOW_MS);
+#else
+	(void)time_ms;
+
+	return true;
+#endif
+}
+
+/**
+ * \brief Writes a page of data to the emulated EEPROM, holding it in the write
+ *        cache.
+ *
+ * Stores the new page contents in the write cache as
+ * \ref eeprom_emulator_write_page_async() does, and counts the update towards
+ * the commit policy. No NVM operation is started.
+ *
+ * \param[in] logical_page  Logical EEPROM page number to write to
+ * \param[in] data          Pointer to the data buffer containing source data to
+ *                          write
+ * \param[in] time_ms       Current time, in milliseconds
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the page was stored in the cache
+ * \retval STATUS_BUSY                  If the write cache must be committed
+ *                                      first; the write should be retried
+ *                                      after \ref eeprom_commit_poll()
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ * \retval STATUS_ERR_BAD_ADDRESS       If an address outside the valid emulated
+ *                                      EEPROM memory space was supplied
+ */
+enum status_code eeprom_commit_write_page(
+		const uint16_t logical_page,
+		const uint8_t *const data,
+		const uint32_t time_ms)
+{
+	enum status_code error_code =
+			eeprom_emulator_write_page_async(logical_page, data);
+
+	/* The cache has no room left for the page, so the window ends now */
+	if (error_code == STATUS_BUSY) {
+		_eeprom_commit.committing = true;
+		return error_code;
+	}
+
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	if (_eeprom_commit.updates == 0) {
+		_eeprom_commit.first_update_ms = time_ms;
+	}
+
+	if (_eeprom_commit.updates < UINT16_MAX) {
+		_eeprom_commit.updates++;
+	}
+
+#if (EEPROM_COMMIT_MAX_UPDATES > 0)
+	if (_eeprom_commit.updates >= EEPROM_COMMIT_MAX_UPDATES) {
+		_eeprom_commit.committing = true;
+	}
+#endif
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Advances the commit of held pages to physical memory.
+ *
+ * Once the window of the oldest held update has elapsed, or enough updates
+ * are held, commits the write cache with \ref eeprom_emulator_poll(), one NVM
+ * operation per call. This function should be called periodically, in place
+ * of \ref eeprom_emulator_poll().
+ *
+ * \param[in] time_ms  Current time, in milliseconds
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If no NVM operation is in progress;
+ *                                      updates may still be held, see
+ *                                      \ref eeprom_commit_idle()
+ * \retval STATUS_BUSY                  If the write cache is being committed
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not initialized
+ */
+enum status_code eeprom_commit_poll(
+		const uint32_t time_ms)
+{
+	enum status_code error_code;
+
+	if ((_eeprom_commit.updates > 0) &&
+			(_eeprom_commit_window_elapsed(time_ms) == true)) {
+		_eeprom_commit.committing = true;
+	}
+
+	if (_eeprom_commit.committing == false) {
+		return STATUS_OK;
+	}
+
+	error_code = eeprom_emulator_poll();
+
+	/* Updates made while committing are committed along */
+	if (error_code != STATUS_BUSY) {
+		_eeprom_commit.updates    = 0;
+		_eeprom_commit.committing = false;
+	}
+
+	return error_code;
+}
+
+/**
+ * \brief Commits all held pages to physical memory.
+ *
+ * Commits the write cache with \ref eeprom_emulator_commit_page_buffer(),
+ * waiting for the NVM operations, whatever the policy.
+ *
+ * \return Status code indicating the status of the operation.
+ */
+enum status_code eeprom_commit_flush(void)
+{
+	_eeprom_commit.updates    = 0;
+	_eeprom_commit.committing = false;
+
+	return eeprom_emulator_commit_page_buffer();
+}
+
+/**
+ * \brief Checks whether no update is held in the write cache.
+ *
+ * Background work on physical memory, such as
+ * \ref eeprom_emulator_compact(), should only be done while the policy is
+ * idle: moving a row writes the held pages of the row along, before the end of
+ * their window.
+ *
+ * \return Whether no update is held or being committed.
+ */
+bool eeprom_commit_idle(void)
+{
+	return ((_eeprom_commit.updates == 0) &&
+			(_eeprom_commit.committing == false));
+}
@@ -0,0 +1,91 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator write coalescing commit policy
+ *
+ * Policy deciding when the pages written to the emulated EEPROM (eeprom.c)
+ * are committed to physical memory. Pages are written to the write cache with
+ * \ref eeprom_commit_write_page(), and held there until the oldest update has
+ * waited for \ref EEPROM_COMMIT_WINDOW_MS, or until
+ * \ref EEPROM_COMMIT_MAX_UPDATES updates have accumulated. Meanwhile, updates
+ * of a cached page replace its cached contents, and an update restoring the
+ * contents in physical memory drops the cached page, so that a burst of
+ * updates costs at most one page write per page.
+ *
+ * \ref eeprom_commit_poll() is called from the main loop in place of
+ * \ref eeprom_emulator_poll(), with the current time of a millisecond counter:
+ *
+ * \code
+	eeprom_commit_write_page(0, page_data, time_ms);
+
+	while (true) {
+		eeprom_commit_poll(time_ms);
+
+		if (eeprom_commit_idle() == true) {
+			eeprom_emulator_compact();
+		}
+	}
+ * \endcode
+ *
+ * Background work on physical memory, such as compaction, is only done while
+ * \ref eeprom_commit_idle() reports that no update is held, as a row move
+ * would commit the held pages of the row before the end of their window.
+ *
+ * Held pages are lost if the device is reset before they are committed. The
+ * brown-out detector interrupt is thus still expected to call
+ * \ref eeprom_emulator_commit_page_buffer() when the supply voltage drops, as
+ * in the Find Me application; \ref eeprom_commit_flush() commits them before a
+ * planned reset or sleep. The interrupt must not preempt a call to this module
+ * or to the emulator in progress: the Find Me application masks it around its
+ * calls, which only start NVM operations, and takes it once they return.
+ */
+#ifndef EEPROM_COMMIT_H_INCLUDED
+#define EEPROM_COMMIT_H_INCLUDED
+
+#include "eeprom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \name Commit Policy Configuration
+ * @{
+ */
+
+#if !defined(EEPROM_COMMIT_WINDOW_MS) || defined(__DOXYGEN__)
+/** Longest time an update is held in the write cache before the cache is
+ *  committed, in milliseconds, or zero to commit every update at once. */
+#  define EEPROM_COMMIT_WINDOW_MS     5000
+#endif
+
+#if !defined(EEPROM_COMMIT_MAX_UPDATES) || defined(__DOXYGEN__)
+/** Number of held updates after which the write cache is committed before the
+ *  end of the window, or zero for no limit. */
+#  define EEPROM_COMMIT_MAX_UPDATES   16
+#endif
+
+/** @} */
+
+/** \name Page Writing/Committing
+ * @{
+ */
+
+enum status_code eeprom_commit_write_page(
+		const uint16_t logical_page,
+		const uint8_t *const data,
+		const uint32_t time_ms);
+
+enum status_code eeprom_commit_poll(
+		const uint32_t time_ms);
+
+enum status_code eeprom_commit_flush(void);
+
+bool eeprom_commit_idle(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_COMMIT_H_INCLUDED */
@@ -0,0 +1,1337 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator host benchmarks
+ *
+ * Benchmark program measuring the emulated EEPROM (eeprom.c) on the host NVM
+ * model (eeprom_host_nvm.c), built by the host Makefile. Each benchmark
+ * prints a table of its results; benchmarks are run by name, or all of them
+ * when none is given:
+ *
+ * \code
+	make bench
+	./eeprom_host_bench writes
+	./eeprom_host_bench --trace alerts.trace endurance
+ * \endcode
+ *
+ * NVM operations are counted by the model, and times are modeled NVM time
+ * unless stated as host CPU time. The emulator options are those of the
+ * build; benchmarks comparing options are run on one build per option set by
+ * the Makefile.
+ */
+#include "eeprom.h"
+#include "eeprom_commit.h"
+#include "eeprom_host_endurance.h"
+#include "eeprom_host_fault.h"
+#include "eeprom_kv.h"
+#include "eeprom_log.h"
+#include "eeprom_name.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+
+/** Number of logical pages of the modeled EEPROM section. */
+#define EEPROM_HOST_BENCH_PAGES    64
+
+/** Number of writes made by each workload of the write benchmark. */
+#define EEPROM_HOST_BENCH_WRITES   10000
+
+/** Number of writes of the hot page simulated by the lifetime benchmark. */
+#define EEPROM_HOST_BENCH_LIFETIME_WRITES  200000
+
+/** Number of calls timed for each operation of the CPU time benchmark. */
+#define EEPROM_HOST_BENCH_CPU_CALLS        20000
+
+/** Number of runs of the CPU time benchmark, of which the fastest is kept. */
+#define EEPROM_HOST_BENCH_CPU_RUNS         10
+
+/** Number of calls made for each transfer of the buffer benchmark. */
+#define EEPROM_HOST_BENCH_TRANSFERS        2000
+
+/** Size of the records appended by the log benchmark, in bytes. */
+#define EEPROM_HOST_BENCH_RECORD_SIZE      16
+
+/** Number of device names of the name benchmark. */
+#define EEPROM_HOST_BENCH_NAMES            2000
+
+/** Size of the device names of the name benchmark, terminator included. */
+#define EEPROM_HOST_BENCH_NAME_SIZE        32
+
+/** Number of passes over the device names when timing their encoding. */
+#define EEPROM_HOST_BENCH_NAME_PASSES      200
+
+/** Number of bursts of the burst benchmark. */
+#define EEPROM_HOST_BENCH_BURSTS           200
+
+/** Length of the alert trace of the alert benchmark, in minutes. */
+#define EEPROM_HOST_BENCH_ALERT_MINUTES    (24 * 60)
+
+#if !defined(EEPROM_HOST_BENCH_FAULT_STEPS)
+/** Number of steps of the workload of the power cut benchmark. */
+#  define EEPROM_HOST_BENCH_FAULT_STEPS    400
+#endif
+
+#if (EEPROM_PAGE_CRC == true)
+/** Number of partial operation points of each power cut point. Torn page
+ *  programs are only detected by the page checksums. */
+#  define EEPROM_HOST_BENCH_FAULT_TORN_POINTS  7
+#else
+#  define EEPROM_HOST_BENCH_FAULT_TORN_POINTS  0
+#endif
+
+/** Largest number of logical pages written by a transaction step. */
+#define EEPROM_HOST_BENCH_FAULT_TRANSACTION_PAGES  3
+
+/** Number of step types of the power cut benchmark. */
+#define EEPROM_HOST_BENCH_FAULT_TYPES      6
+
+/** Number of unrecovered power cuts listed by the power cut benchmark. */
+#define EEPROM_HOST_BENCH_FAULT_LISTED     10
+
+/**
+ * \internal
+ * \brief Alert trace file of the endurance benchmark, given with \c --trace.
+ */
+static const char *_eeprom_host_bench_trace_path;
+
+/**
+ * \internal
+ * \brief Benchmark structure.
+ */
+struct _eeprom_host_bench {
+	/** Name of the benchmark, as given on the command line. */
+	const char *name;
+	/** Description of the benchmark. */
+	const char *description;
+	/** Runs the benchmark and prints its results. */
+	void (*run)(void);
+};
+
+/** \internal
+ *  \brief Formats a modeled EEPROM section and initializes the emulator on
+ *         it.
+ *
+ *  \param[in] pages  Number of pages of the section
+ */
+static void _eeprom_host_bench_mount(
+		const uint16_t pages)
+{
+	eeprom_host_nvm_init(pages);
+	eeprom_emulator_init();
+	eeprom_emulator_erase_memory();
+
+	if (eeprom_emulator_init() != STATUS_OK) {
+		fprintf(stderr, "EEPROM emulator initialization failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	eeprom_host_nvm_clear_statistics();
+}
+
+/** \internal
+ *  \brief Writes a logical page of the write benchmark and commits it.
+ *
+ *  \param[in] workload  Index of the workload
+ *  \param[in] write     Index of the write within the workload
+ *  \param[in] data      Page contents, changed by the write
+ */
+static void _eeprom_host_bench_write(
+		const uint8_t workload,
+		const uint32_t write,
+		uint8_t *const data)
+{
+	uint16_t logical_pages = EEPROM_HOST_BENCH_PAGES / 2 - 2;
+	uint16_t logical_page;
+
+	switch (workload) {
+	case 0:
+		/* Alert level of the Find Me application */
+		data[0] = write % 3;
+		eeprom_emulator_write_page(0, data);
+		break;
+
+	case 1:
+		/* Every page in turn, each holding a counter */
+		logical_page = write % logical_pages;
+		memcpy(data, &write, sizeof(write));
+		eeprom_emulator_write_page(logical_page, data);
+		break;
+
+	case 2:
+		/* Four configuration pages taking most writes */
+		logical_page = ((rand() % 5) != 0) ? (rand() % 4) :
+				(rand() % logical_pages);
+		memcpy(data, &write, sizeof(write));
+		eeprom_emulator_write_page(logical_page, data);
+		break;
+
+	default:
+		/* Records of 16 bytes anywhere in the memory */
+		memcpy(data, &write, sizeof(write));
+		eeprom_emulator_write_buffer(
+				rand() % ((logical_pages * EEPROM_PAGE_SIZE) - 16), data, 16);
+		break;
+	}
+
+	eeprom_emulator_commit_page_buffer();
+}
+
+/** \internal
+ *  \brief Reports the NVM operations and modeled time per logical write of
+ *         typical write loads, each write being committed.
+ *
+ *  Page reads copy a whole page out of the FLASH, and direct reads are
+ *  memory-mapped reads of page headers or contents. The next free page of a
+ *  row comes from the row fill table: a write without a row move only reads
+ *  the current revision, to elide unchanged writes, and the other reads are
+ *  made by row moves.
+ */
+static void _eeprom_host_bench_writes(void)
+{
+	static const char *const workloads[] = {
+		"alert page",
+		"round robin",
+		"hot pages",
+		"16 B records",
+	};
+
+	printf("%-14s %8s %8s %8s %8s %8s %10s\n", "workload", "fills",
+			"commits", "erases", "pg reads", "direct", "time (ms)");
+
+	for (uint8_t c = 0; c < sizeof(workloads) / sizeof(workloads[0]); c++) {
+		struct eeprom_host_nvm_statistics statistics;
+		uint8_t data[EEPROM_PAGE_SIZE];
+
+		_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+		memset(data, 0, sizeof(data));
+		srand(1);
+
+		for (uint32_t write = 0; write < EEPROM_HOST_BENCH_WRITES; write++) {
+			_eeprom_host_bench_write(c, write, data);
+		}
+
+		eeprom_host_nvm_get_statistics(&statistics);
+
+		printf("%-14s %8.3f %8.3f %8.3f %8.3f %8.3f %10.2f\n", workloads[c],
+				(double)statistics.page_fills / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.page_writes / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.row_erases / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.page_reads / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.direct_reads / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.elapsed_ns / EEPROM_HOST_BENCH_WRITES / 1000000);
+	}
+}
+
+/** \internal
+ *  \brief Reports the page commits per write of records interleaved between
+ *         logical pages of different rows, written without committing each
+ *         write.
+ *
+ *  The number of write cache entries is that of the build; the Makefile runs
+ *  this benchmark with one and several entries.
+ */
+static void _eeprom_host_bench_alternating(void)
+{
+	printf("%-8s %-8s %11s %10s %10s\n", "entries", "pages",
+			"commits/wr", "erases/wr", "time (ms)");
+
+	for (uint8_t pages = 2; pages <= 4; pages++) {
+		struct eeprom_host_nvm_statistics statistics;
+		uint8_t data[4][EEPROM_PAGE_SIZE];
+		uint8_t read[EEPROM_PAGE_SIZE];
+
+		_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+		memset(data, 0, sizeof(data));
+
+		for (uint32_t write = 0; write < EEPROM_HOST_BENCH_WRITES; write++) {
+			uint8_t record = write % pages;
+
+			/* Two logical pages per row, so even pages are in different rows */
+			memcpy(data[record], &write, sizeof(write));
+			eeprom_emulator_write_page(record * 2, data[record]);
+		}
+
+		eeprom_emulator_commit_page_buffer();
+		eeprom_host_nvm_get_statistics(&statistics);
+
+		for (uint8_t record = 0; record < pages; record++) {
+			eeprom_emulator_read_page(record * 2, read);
+
+			if (memcmp(read, data[record], EEPROM_PAGE_SIZE) != 0) {
+				fprintf(stderr, "Record contents lost\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		printf("%-8u %-8u %11.4f %10.4f %10.3f\n", EEPROM_CACHE_ENTRIES, pages,
+				(double)statistics.page_writes / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.row_erases / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.elapsed_ns / EEPROM_HOST_BENCH_WRITES / 1000000);
+	}
+}
+
+/** \internal
+ *  \brief Reads the host monotonic clock.
+ *
+ *  \return Host CPU time, in nanoseconds.
+ */
+static uint64_t _eeprom_host_bench_clock_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+/** \internal
+ *  \brief Reports the host CPU time per call of initialization, page reads
+ *         and page writes, with the memory geometry of the build.
+ *
+ *  Writes are timed into the write cache, and committed at each call. The
+ *  Makefile runs this benchmark with the geometry read at initialization and
+ *  fixed at build time.
+ */
+static void _eeprom_host_bench_cpu(void)
+{
+	static const uint32_t calls = EEPROM_HOST_BENCH_CPU_CALLS;
+	struct eeprom_emulator_parameters parameters;
+	uint8_t data[EEPROM_PAGE_SIZE];
+	uint64_t best_ns[4] = {UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX};
+	uint16_t pages;
+
+	_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+	eeprom_emulator_get_parameters(&parameters);
+	pages = parameters.eeprom_number_of_pages;
+	memset(data, 0, sizeof(data));
+
+	for (uint16_t page = 0; page < pages; page++) {
+		eeprom_emulator_write_page(page, data);
+	}
+	eeprom_emulator_commit_page_buffer();
+
+	/* Keep the fastest of several runs, as the least disturbed by the host */
+	for (uint8_t run = 0; run < EEPROM_HOST_BENCH_CPU_RUNS; run++) {
+		uint64_t ns[4];
+
+		ns[0] = _eeprom_host_bench_clock_ns();
+		for (uint32_t call = 0; call < calls / 100; call++) {
+			eeprom_emulator_init();
+		}
+		ns[0] = _eeprom_host_bench_clock_ns() - ns[0];
+
+		ns[1] = _eeprom_host_bench_clock_ns();
+		for (uint32_t call = 0; call < calls; call++) {
+			eeprom_emulator_read_page((call * 7) % pages, data);
+		}
+		ns[1] = _eeprom_host_bench_clock_ns() - ns[1];
+
+		ns[2] = _eeprom_host_bench_clock_ns();
+		for (uint32_t call = 0; call < calls; call++) {
+			memcpy(data, &call, sizeof(call));
+			eeprom_emulator_write_page(0, data);
+		}
+		ns[2] = _eeprom_host_bench_clock_ns() - ns[2];
+
+		ns[3] = _eeprom_host_bench_clock_ns();
+		for (uint32_t call = 0; call < calls; call++) {
+			memcpy(data, &call, sizeof(call));
+			eeprom_emulator_write_page((call * 7) % pages, data);
+			eeprom_emulator_commit_page_buffer();
+		}
+		ns[3] = _eeprom_host_bench_clock_ns() - ns[3];
+
+		for (uint8_t c = 0; c < 4; c++) {
+			if (ns[c] < best_ns[c]) {
+				best_ns[c] = ns[c];
+			}
+		}
+	}
+
+	printf("%-10s %10s %10s %10s %12s\n", "geometry", "init ns", "read ns",
+			"write ns", "commit ns");
+	printf("%-10s %10.0f %10.1f %10.1f %12.1f\n",
+			(EEPROM_PHYSICAL_PAGES == 0) ? "runtime" : "fixed",
+			(double)best_ns[0] / (calls / 100),
+			(double)best_ns[1] / calls,
+			(double)best_ns[2] / calls,
+			(double)best_ns[3] / calls);
+}
+
+/** \internal
+ *  \brief Reports the host CPU time and NVM operations of buffer reads and
+ *         writes, page aligned or not, within a page or across several.
+ *
+ *  Writes are committed once per transfer, after all of its calls.
+ */
+static void _eeprom_host_bench_buffer(void)
+{
+	static const struct {
+		const char *name;
+		uint16_t offset;
+		uint16_t length;
+	} transfers[] = {
+		{"aligned 4 B",          0,    4},
+		{"misaligned 4 B",      37,    4},
+		{"aligned 1 page",       0,   60},
+		{"misaligned 60 B",     17,   60},
+		{"aligned 4 pages",      0,  240},
+		{"misaligned 240 B",    23,  240},
+		{"misaligned 1000 B",    7, 1000},
+	};
+
+	printf("%-18s %9s %9s %8s %8s\n", "transfer", "read ns", "write ns",
+			"reads", "commits");
+
+	_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+
+	for (uint8_t c = 0; c < sizeof(transfers) / sizeof(transfers[0]); c++) {
+		struct eeprom_host_nvm_statistics before;
+		struct eeprom_host_nvm_statistics after;
+		uint16_t offset = transfers[c].offset;
+		uint16_t length = transfers[c].length;
+		uint8_t data[1024];
+		uint8_t read[1024];
+		uint64_t read_ns;
+		uint64_t write_ns;
+
+		read_ns = _eeprom_host_bench_clock_ns();
+		for (uint16_t call = 0; call < EEPROM_HOST_BENCH_TRANSFERS; call++) {
+			eeprom_emulator_read_buffer(offset, read, length);
+		}
+		read_ns = _eeprom_host_bench_clock_ns() - read_ns;
+
+		eeprom_host_nvm_get_statistics(&before);
+
+		write_ns = _eeprom_host_bench_clock_ns();
+		for (uint16_t call = 0; call < EEPROM_HOST_BENCH_TRANSFERS; call++) {
+			memset(data, call, length);
+			eeprom_emulator_write_buffer(offset, data, length);
+		}
+		eeprom_emulator_commit_page_buffer();
+		write_ns = _eeprom_host_bench_clock_ns() - write_ns;
+
+		eeprom_host_nvm_get_statistics(&after);
+
+		eeprom_emulator_read_buffer(offset, read, length);
+		if (memcmp(read, data, length) != 0) {
+			fprintf(stderr, "Buffer contents lost\n");
+			exit(EXIT_FAILURE);
+		}
+
+		printf("%-18s %9.0f %9.0f %8.2f %8.2f\n", transfers[c].name,
+				(double)read_ns / EEPROM_HOST_BENCH_TRANSFERS,
+				(double)write_ns / EEPROM_HOST_BENCH_TRANSFERS,
+				(double)((after.page_reads + after.direct_reads) -
+					(before.page_reads + before.direct_reads)) /
+					EEPROM_HOST_BENCH_TRANSFERS,
+				(double)(after.page_writes - before.page_writes) /
+					EEPROM_HOST_BENCH_TRANSFERS);
+	}
+}
+
+/** \internal
+ *  \brief Reports the latency of committed writes of a hot page in bursts of
+ *         several lengths, the memory being compacted while idle between the
+ *         bursts.
+ *
+ *  Every other write of a burst moves the row of the page; the spare row pool
+ *  lets moves skip the row erase until it runs out. The number of spare rows
+ *  is that of the build; the Makefile runs this benchmark with several.
+ */
+static void _eeprom_host_bench_burst(void)
+{
+	static const uint8_t lengths[] = {4, 8, 16, 32};
+	uint8_t data[EEPROM_PAGE_SIZE];
+
+	printf("%-8s %8s %10s %10s %12s\n", "spares", "writes", "mean (ms)",
+			"max (ms)", "erases/burst");
+
+	for (uint8_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+		uint64_t burst_ns = 0;
+		uint64_t max_ns = 0;
+		uint32_t erases = 0;
+
+		_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+		memset(data, 0, sizeof(data));
+
+		for (uint16_t burst = 0; burst < EEPROM_HOST_BENCH_BURSTS; burst++) {
+			for (uint8_t c = 0; c < lengths[l]; c++) {
+				struct eeprom_host_nvm_statistics before;
+				struct eeprom_host_nvm_statistics after;
+				uint64_t ns;
+
+				data[0] = c;
+				data[1] = burst;
+
+				eeprom_host_nvm_get_statistics(&before);
+				eeprom_emulator_write_page(0, data);
+				eeprom_emulator_commit_page_buffer();
+				eeprom_host_nvm_get_statistics(&after);
+
+				ns        = after.elapsed_ns - before.elapsed_ns;
+				burst_ns += ns;
+				erases   += after.row_erases - before.row_erases;
+
+				if (ns > max_ns) {
+					max_ns = ns;
+				}
+			}
+
+			/* Idle until the next burst */
+			while (eeprom_emulator_compact() == STATUS_BUSY) {
+				eeprom_host_nvm_advance(EEPROM_HOST_NVM_ROW_ERASE_NS);
+			}
+		}
+
+		printf("%-8u %8u %10.2f %10.2f %12.2f\n", EEPROM_SPARE_ROWS,
+				lengths[l],
+				(double)burst_ns / EEPROM_HOST_BENCH_BURSTS / lengths[l] / 1000000,
+				(double)max_ns / 1000000,
+				(double)erases / EEPROM_HOST_BENCH_BURSTS);
+	}
+}
+
+/** \internal
+ *  \brief Projects the number of writes until a row wears out, under a hot
+ *         page written once per millisecond and a cold page written every 50
+ *         milliseconds.
+ *
+ *  The wear leveling threshold is that of the build; the Makefile runs this
+ *  benchmark with and without wear leveling.
+ */
+static void _eeprom_host_bench_lifetime(void)
+{
+	static const struct eeprom_host_endurance_source sources[] = {
+		{.logical_page = 0,  .period_ms = 1},
+		{.logical_page = 10, .period_ms = 50},
+	};
+	struct eeprom_host_endurance_config config;
+	struct eeprom_host_endurance_results results;
+	uint64_t total_erases = 0;
+
+	eeprom_host_endurance_get_config_defaults(&config);
+	config.eeprom_pages    = EEPROM_HOST_BENCH_PAGES;
+	config.sources         = sources;
+	config.source_count    = sizeof(sources) / sizeof(sources[0]);
+	config.duration_ms     = EEPROM_HOST_BENCH_LIFETIME_WRITES;
+	config.idle_compaction = false;
+
+	if (eeprom_host_endurance_run(&config, &results) != STATUS_OK) {
+		fprintf(stderr, "Endurance simulation failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (uint16_t row = 0; row < results.rows; row++) {
+		total_erases += results.row_erases[row];
+	}
+
+	printf("%-10s %8s %12s %12s %16s\n", "threshold", "writes",
+			"max erases", "all erases", "writes to 100k");
+	printf("%-10u %8llu %12lu %12llu %15.2fM\n",
+			EEPROM_WEAR_LEVELING_THRESHOLD,
+			(unsigned long long)results.writes,
+			(unsigned long)results.row_erases[results.hottest_row],
+			(unsigned long long)total_erases,
+			(double)results.target_ms[EEPROM_HOST_ENDURANCE_TARGETS - 1] *
+				results.writes / results.simulated_ms / 1000000);
+}
+
+/** \internal
+ *  \brief Appends a record to a ring of fixed size records kept with the raw
+ *         buffer API, after a 16-bit head offset at the start of the memory.
+ *
+ *  \param[in] record  Record to append, of \ref EEPROM_HOST_BENCH_RECORD_SIZE
+ *                     bytes
+ */
+static void _eeprom_host_bench_append_raw(
+		const uint8_t *const record)
+{
+	struct eeprom_emulator_parameters parameters;
+	uint16_t records;
+	uint16_t head;
+
+	eeprom_emulator_get_parameters(&parameters);
+	records = ((parameters.eeprom_number_of_pages * EEPROM_PAGE_SIZE) -
+			sizeof(head)) / EEPROM_HOST_BENCH_RECORD_SIZE;
+
+	eeprom_emulator_read_buffer(0, (uint8_t *)&head, sizeof(head));
+	eeprom_emulator_write_buffer(
+			sizeof(head) + (head * EEPROM_HOST_BENCH_RECORD_SIZE),
+			record, EEPROM_HOST_BENCH_RECORD_SIZE);
+
+	head = (head + 1) % records;
+	eeprom_emulator_write_buffer(0, (uint8_t *)&head, sizeof(head));
+}
+
+/** \internal
+ *  \brief Reports the NVM operations per record appended to the circular
+ *         record log of eeprom_log.c, against a ring of records kept with the
+ *         raw buffer API, each append being committed.
+ *
+ *  The mount column gives the physical pages read to find the newest record
+ *  after a reset. Delta records are those of the build; the Makefile runs this
+ *  benchmark with and without them.
+ */
+static void _eeprom_host_bench_log(void)
+{
+	static const char *const stores[] = {
+		"ring log",
+		"raw buffer",
+	};
+
+	printf("%-12s %8s %8s %8s %10s %8s\n", "store", "commits", "erases",
+			"deltas", "time (ms)", "mount");
+
+	for (uint8_t c = 0; c < sizeof(stores) / sizeof(stores[0]); c++) {
+		struct eeprom_host_nvm_statistics statistics;
+		struct eeprom_host_nvm_statistics mount;
+		struct eeprom_emulator_statistics emulator;
+		uint8_t record[EEPROM_HOST_BENCH_RECORD_SIZE];
+		uint16_t head = 0;
+
+		_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+
+		if (c == 0) {
+			eeprom_log_format();
+		} else {
+			eeprom_emulator_write_buffer(0, (uint8_t *)&head, sizeof(head));
+		}
+
+		eeprom_emulator_commit_page_buffer();
+		eeprom_emulator_init();
+		eeprom_host_nvm_clear_statistics();
+
+		for (uint32_t append = 0; append < EEPROM_HOST_BENCH_WRITES; append++) {
+			memset(record, append, sizeof(record));
+			memcpy(record, &append, sizeof(append));
+
+			if (c == 0) {
+				eeprom_log_append(record, sizeof(record));
+			} else {
+				_eeprom_host_bench_append_raw(record);
+			}
+
+			eeprom_emulator_commit_page_buffer();
+		}
+
+		eeprom_host_nvm_get_statistics(&statistics);
+		eeprom_emulator_get_statistics(&emulator);
+
+		/* Find the newest record again after a reset */
+		eeprom_emulator_init();
+		eeprom_host_nvm_clear_statistics();
+
+		if (c == 0) {
+			eeprom_log_init();
+		} else {
+			eeprom_emulator_read_buffer(0, (uint8_t *)&head, sizeof(head));
+		}
+
+		eeprom_host_nvm_get_statistics(&mount);
+
+		printf("%-12s %8.3f %8.3f %8.3f %10.2f %8lu\n", stores[c],
+				(double)statistics.page_writes / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.row_erases / EEPROM_HOST_BENCH_WRITES,
+				(double)emulator.delta_records / EEPROM_HOST_BENCH_WRITES,
+				(double)statistics.elapsed_ns / EEPROM_HOST_BENCH_WRITES / 1000000,
+				(unsigned long)(mount.page_reads + mount.direct_reads));
+	}
+}
+
+/** \internal
+ *  \brief Makes up a Bluetooth device name, as found around a phone.
+ *
+ *  \param[out] name  Buffer of \ref EEPROM_HOST_BENCH_NAME_SIZE bytes to
+ *                    write the name to
+ *
+ *  \return Length of the name, in bytes.
+ */
+static uint8_t _eeprom_host_bench_name(
+		char *const name)
+{
+	static const char *const numbered[] = {
+		"iPhone %d", "Galaxy S%d", "Galaxy Buds%d Pro", "Galaxy Watch%d",
+		"Mi Band %d", "Mi Smart Band %d", "JBL Flip %d", "WH-1000XM%d",
+		"Pixel %d Pro", "LE-Bose QC%d", "Fitbit Charge %d", "Amazfit GTS %d",
+		"HUAWEI P%d lite", "Redmi Note %d", "Tile", "ATMEL-FMP-%d",
+		"OnePlus %dT",
+	};
+	static const char *const owned[] = {
+		"iPhone de %s", "%s's AirPods", "%s_Keyboard", "MacBook Pro de %s",
+		"%s TV",
+	};
+	static const char *const owners[] = {
+		"Maria", "Joao", "Ana", "Pedro", "Lucas", "Julia", "Rafael", "Beatriz",
+	};
+	uint8_t kind = rand() % (sizeof(numbered) / sizeof(numbered[0]) +
+			sizeof(owned) / sizeof(owned[0]) + 1);
+	int length;
+
+	if (kind < sizeof(numbered) / sizeof(numbered[0])) {
+		length = snprintf(name, EEPROM_HOST_BENCH_NAME_SIZE, numbered[kind],
+				1 + (rand() % 20));
+	} else if ((kind -= sizeof(numbered) / sizeof(numbered[0])) <
+			sizeof(owned) / sizeof(owned[0])) {
+		length = snprintf(name, EEPROM_HOST_BENCH_NAME_SIZE, owned[kind],
+				owners[rand() % (sizeof(owners) / sizeof(owners[0]))]);
+	} else {
+		length = snprintf(name, EEPROM_HOST_BENCH_NAME_SIZE, "DESKTOP-%04X%03X",
+				rand() % 0x10000, rand() % 0x1000);
+	}
+
+	return length;
+}
+
+/** \internal
+ *  \brief Reports the size and the host CPU time of the encoding of device
+ *         names by eeprom_name.c, and how many names fit in a key-value store
+ *         (eeprom_kv.c) keyed by device address, stored as is or encoded.
+ */
+static void _eeprom_host_bench_names(void)
+{
+	static char names[EEPROM_HOST_BENCH_NAMES][EEPROM_HOST_BENCH_NAME_SIZE];
+	static uint8_t lengths[EEPROM_HOST_BENCH_NAMES];
+	uint8_t encoded[EEPROM_NAME_ENCODED_SIZE(EEPROM_HOST_BENCH_NAME_SIZE)];
+	uint8_t encoded_length;
+	uint32_t raw_bytes = 0;
+	uint32_t encoded_bytes = 0;
+	uint64_t encode_ns;
+	uint64_t decode_ns;
+
+	srand(5);
+
+	for (uint16_t c = 0; c < EEPROM_HOST_BENCH_NAMES; c++) {
+		lengths[c] = _eeprom_host_bench_name(names[c]);
+		eeprom_name_encode(names[c], lengths[c], encoded, &encoded_length);
+
+		raw_bytes     += lengths[c];
+		encoded_bytes += encoded_length;
+	}
+
+	encode_ns = _eeprom_host_bench_clock_ns();
+	for (uint16_t pass = 0; pass < EEPROM_HOST_BENCH_NAME_PASSES; pass++) {
+		for (uint16_t c = 0; c < EEPROM_HOST_BENCH_NAMES; c++) {
+			eeprom_name_encode(names[c], lengths[c], encoded, &encoded_length);
+		}
+	}
+	encode_ns = _eeprom_host_bench_clock_ns() - encode_ns;
+
+	/* Names are decoded in place, so each pass decodes a fresh copy */
+	decode_ns = 0;
+	for (uint16_t c = 0; c < EEPROM_HOST_BENCH_NAMES; c++) {
+		uint8_t name[EEPROM_NAME_ENCODED_SIZE(EEPROM_HOST_BENCH_NAME_SIZE)];
+		uint8_t name_length;
+		uint64_t start_ns;
+
+		eeprom_name_encode(names[c], lengths[c], encoded, &encoded_length);
+
+		start_ns = _eeprom_host_bench_clock_ns();
+		for (uint16_t pass = 0; pass < EEPROM_HOST_BENCH_NAME_PASSES; pass++) {
+			memcpy(name, encoded, encoded_length);
+			eeprom_name_decode(name, encoded_length, sizeof(name), &name_length);
+		}
+		decode_ns += _eeprom_host_bench_clock_ns() - start_ns;
+
+		if ((name_length != lengths[c]) ||
+				(memcmp(name, names[c], name_length) != 0)) {
+			fprintf(stderr, "Name lost: %s\n", names[c]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	printf("%-10s %10s %10s %10s %8s\n", "names", "bytes/name", "encode ns",
+			"decode ns", "stored");
+
+	for (uint8_t encode = 0; encode < 2; encode++) {
+		uint16_t stored;
+
+		_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+		eeprom_kv_format();
+
+		/* Names of distinct devices until the store is full */
+		for (stored = 0; stored < EEPROM_HOST_BENCH_NAMES; stored++) {
+			const uint8_t address[6] = {stored, stored >> 8, 0x12, 0x34, 0x56, 0x78};
+			const uint8_t *value = (const uint8_t *)names[stored];
+			uint8_t value_length = lengths[stored];
+
+			if (encode == 1) {
+				eeprom_name_encode(names[stored], lengths[stored], encoded,
+						&encoded_length);
+				value        = encoded;
+				value_length = encoded_length;
+			}
+
+			if (eeprom_kv_write(address, sizeof(address), value,
+					value_length) != STATUS_OK) {
+				break;
+			}
+		}
+
+		eeprom_emulator_commit_page_buffer();
+
+		if (encode == 0) {
+			printf("%-10s %10.1f %10s %10s %8u\n", "raw",
+					(double)raw_bytes / EEPROM_HOST_BENCH_NAMES, "-", "-",
+					stored);
+		} else {
+			printf("%-10s %10.1f %10.0f %10.0f %8u\n", "encoded",
+					(double)encoded_bytes / EEPROM_HOST_BENCH_NAMES,
+					(double)encode_ns / EEPROM_HOST_BENCH_NAME_PASSES /
+						EEPROM_HOST_BENCH_NAMES,
+					(double)decode_ns / EEPROM_HOST_BENCH_NAME_PASSES /
+						EEPROM_HOST_BENCH_NAMES,
+					stored);
+		}
+	}
+}
+
+/**
+ * \internal
+ * \brief Bursty alert trace structure.
+ */
+struct _eeprom_host_bench_alert_trace {
+	/** Time of the next alert, in milliseconds. */
+	uint32_t next_ms;
+	/** Number of alerts left in the current burst. */
+	uint8_t burst_left;
+	/** Current alert level. */
+	uint8_t level;
+};
+
+/** \internal
+ *  \brief Advances a bursty alert trace to its next alert.
+ *
+ *  A quarter of the alerts are isolated, and the others come in bursts of 4
+ *  to 19 alerts, 0.2 to 1.7 seconds apart, as when a phone looks for the
+ *  device. Bursts are 30 seconds to 6.5 minutes apart.
+ *
+ *  \param[in,out] trace  Alert trace to advance
+ */
+static void _eeprom_host_bench_next_alert(
+		struct _eeprom_host_bench_alert_trace *const trace)
+{
+	if (trace->burst_left == 0) {
+		trace->burst_left = ((rand() % 4) == 0) ? 1 : (4 + (rand() % 16));
+	}
+
+	/* Alerts are mostly raised and cleared, and sometimes changed */
+	if (trace->level == 0) {
+		trace->level = 1 + (rand() % 2);
+	} else {
+		trace->level = ((rand() % 3) == 0) ? (3 - trace->level) : 0;
+	}
+
+	trace->burst_left--;
+	trace->next_ms += (trace->burst_left > 0) ?
+			(200 + (rand() % 1500)) : (30000 + (rand() % (6 * 60000)));
+}
+
+/** \internal
+ *  \brief Reports the NVM operations per minute of the alert level page of the
+ *         Find Me application under a bursty alert trace, written through the
+ *         commit policy of eeprom_commit.c.
+ *
+ *  The trace is run without compaction, and with compaction while the commit
+ *  policy is idle. The commit window is that of the build; the Makefile runs
+ *  this benchmark with several windows.
+ */
+static void _eeprom_host_bench_alerts(void)
+{
+	static const uint32_t minutes = EEPROM_HOST_BENCH_ALERT_MINUTES;
+
+	printf("%-8s %-10s %12s %12s %12s\n", "window", "compaction",
+			"alerts/min", "writes/min", "erases/min");
+
+	for (uint8_t compaction = 0; compaction < 2; compaction++) {
+		struct _eeprom_host_bench_alert_trace trace = {.next_ms = 1000};
+		struct eeprom_host_nvm_statistics statistics;
+		uint8_t data[EEPROM_PAGE_SIZE];
+		uint32_t alerts = 0;
+		bool pending = false;
+
+		_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+		memset(data, 0, sizeof(data));
+		eeprom_emulator_write_page(0, data);
+		eeprom_emulator_commit_page_buffer();
+		eeprom_host_nvm_clear_statistics();
+		srand(7);
+
+		for (uint32_t time_ms = 0; time_ms < minutes * 60000; time_ms++) {
+			if (time_ms == trace.next_ms) {
+				_eeprom_host_bench_next_alert(&trace);
+				data[0] = trace.level;
+				alerts++;
+				pending = true;
+			}
+
+			/* Main loop of the application, once per millisecond */
+			if (pending == true) {
+				pending = (eeprom_commit_write_page(0, data, time_ms) ==
+						STATUS_BUSY);
+			}
+
+			eeprom_commit_poll(time_ms);
+
+			if ((compaction == 1) && (eeprom_commit_idle() == true)) {
+				eeprom_emulator_compact();
+			}
+
+			eeprom_host_nvm_advance(1000000);
+		}
+
+		eeprom_commit_flush();
+		eeprom_host_nvm_get_statistics(&statistics);
+
+		/* The last alert level must survive a reset */
+		eeprom_emulator_init();
+		eeprom_emulator_read_page(0, data);
+
+		if (data[0] != trace.level) {
+			fprintf(stderr, "Alert level lost\n");
+			exit(EXIT_FAILURE);
+		}
+
+		printf("%-8u %-10s %12.2f %12.2f %12.3f\n", EEPROM_COMMIT_WINDOW_MS,
+				(compaction == 1) ? "idle" : "none",
+				(double)alerts / minutes,
+				(double)statistics.page_writes / minutes,
+				(double)statistics.row_erases / minutes);
+	}
+}
+
+/** \internal
+ *  \brief Projects the wear of the rows under the alert level writes of the
+ *         Find Me application, repeating every day an alert trace loaded from
+ *         the file given with \c --trace, or a day of the bursty alert trace.
+ *
+ *  Reports the erases of each row, the device time until the most erased row
+ *  reaches each target number of erase cycles, and the logical pages whose
+ *  writes caused the most erases.
+ */
+static void _eeprom_host_bench_endurance(void)
+{
+	static const uint64_t day_ms = 24ULL * 60 * 60 * 1000;
+	static uint8_t levels[EEPROM_HOST_ENDURANCE_ALERT_LEVELS][EEPROM_PAGE_SIZE];
+	struct eeprom_host_endurance_trace trace;
+	struct eeprom_host_endurance_config config;
+	struct eeprom_host_endurance_results results;
+	enum status_code status;
+	uint64_t last_ms;
+
+	if (_eeprom_host_bench_trace_path != NULL) {
+		status = eeprom_host_endurance_load_alerts(
+				_eeprom_host_bench_trace_path, &trace);
+
+		if ((status != STATUS_OK) || (trace.event_count == 0)) {
+			fprintf(stderr, "Cannot load alert trace %s\n",
+					_eeprom_host_bench_trace_path);
+			exit(EXIT_FAILURE);
+		}
+	} else {
+		struct _eeprom_host_bench_alert_trace alerts = {.next_ms = 1000};
+
+		/* Count the alerts of the day, then generate them again */
+		trace.event_count = 0;
+		srand(7);
+		while (alerts.next_ms < day_ms) {
+			_eeprom_host_bench_next_alert(&alerts);
+			trace.event_count++;
+		}
+
+		trace.events = malloc(trace.event_count * sizeof(trace.events[0]));
+		if (trace.events == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+
+		for (uint8_t c = 0; c < EEPROM_HOST_ENDURANCE_ALERT_LEVELS; c++) {
+			memset(levels[c], 0xFF, EEPROM_PAGE_SIZE);
+			levels[c][0] = c;
+		}
+
+		alerts = (struct _eeprom_host_bench_alert_trace){.next_ms = 1000};
+		srand(7);
+		for (uint32_t c = 0; c < trace.event_count; c++) {
+			trace.events[c].time_ms      = alerts.next_ms;
+			trace.events[c].logical_page = 0;
+			_eeprom_host_bench_next_alert(&alerts);
+			trace.events[c].data         = levels[alerts.level];
+		}
+	}
+
+	last_ms = trace.events[trace.event_count - 1].time_ms;
+
+	eeprom_host_endurance_get_config_defaults(&config);
+	config.eeprom_pages    = EEPROM_HOST_BENCH_PAGES;
+	config.events          = trace.events;
+	config.event_count     = trace.event_count;
+	config.trace_period_ms = ((last_ms / day_ms) + 1) * day_ms;
+
+	status = eeprom_host_endurance_run(&config, &results);
+	if (status != STATUS_OK) {
+		fprintf(stderr, "Endurance simulation failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("%-10s %s\n", "trace", (_eeprom_host_bench_trace_path != NULL) ?
+			_eeprom_host_bench_trace_path : "bursty alerts");
+	printf("%-10s %lu alerts, repeated every %llu days\n", "load",
+			(unsigned long)trace.event_count,
+			(unsigned long long)(config.trace_period_ms / day_ms));
+	printf("%-10s %u\n", "threshold", EEPROM_WEAR_LEVELING_THRESHOLD);
+	printf("%-10s %.1f years, %llu writes\n\n", "simulated",
+			(double)results.simulated_ms / EEPROM_HOST_ENDURANCE_YEAR_MS,
+			(unsigned long long)results.writes);
+
+	printf("%-6s %10s\n", "row", "erases");
+	for (uint16_t row = 0; row < results.rows; row++) {
+		printf("%-6u %10lu%s\n", row, (unsigned long)results.row_erases[row],
+				(row == results.rows - 1) ? "  (master row)" : "");
+	}
+
+	printf("\n%-10s %12s\n", "cycles", "years");
+	for (uint8_t c = 0; c < EEPROM_HOST_ENDURANCE_TARGETS; c++) {
+		if (results.target_ms[c] == UINT64_MAX) {
+			printf("%-10lu %12s\n", (unsigned long)config.target_cycles[c],
+					"never");
+			continue;
+		}
+
+		printf("%-10lu %12.2f  (%s)\n", (unsigned long)config.target_cycles[c],
+				(double)results.target_ms[c] / EEPROM_HOST_ENDURANCE_YEAR_MS,
+				results.target_reached[c] ? "simulated" : "projected");
+	}
+
+	printf("\n%-10s %12s %12s\n", "page", "writes", "erases");
+	for (uint8_t c = 0; c < results.hot_page_count; c++) {
+		printf("%-10u %12llu %12llu\n", results.hot_pages[c].logical_page,
+				(unsigned long long)results.hot_pages[c].writes,
+				(unsigned long long)results.hot_pages[c].row_erases);
+	}
+
+	eeprom_host_endurance_free_trace(&trace);
+}
+
+/**
+ * \internal
+ * \brief Power cut benchmark results, per workload step type.
+ */
+static struct {
+	/** Steps of the workload. */
+	const struct eeprom_host_fault_step *steps;
+	/** Totals of the cut points of each step type. */
+	struct eeprom_host_fault_results types[EEPROM_HOST_BENCH_FAULT_TYPES];
+	/** Number of unrecovered cut points listed so far. */
+	uint32_t listed;
+} _eeprom_host_bench_faults_results;
+
+/** \internal
+ *  \brief Makes up the data of a workload step of the power cut benchmark,
+ *         either a copy of the current contents with a single byte changed, as
+ *         for a counter or a setting, or random contents.
+ *
+ *  \param[in,out] contents  Current contents of the written bytes, updated to
+ *                           the data
+ *  \param[out]    data      Buffer to write the data to
+ *  \param[in]     length    Number of bytes written
+ */
+static void _eeprom_host_bench_fault_data(
+		uint8_t *const contents,
+		uint8_t *const data,
+		const uint16_t length)
+{
+	if ((rand() % 2) == 0) {
+		contents[rand() % length] ^= 1 << (rand() % 8);
+	} else {
+		for (uint16_t c = 0; c < length; c++) {
+			contents[c] = rand();
+		}
+	}
+
+	memcpy(data, contents, length);
+}
+
+/** \internal
+ *  \brief Adds the outcome of a power cut to the totals of its step type, and
+ *         lists the first cuts that fail the benchmark.
+ *
+ *  \param[in] cut  Outcome of the power cut
+ */
+static void _eeprom_host_bench_fault_report(
+		const struct eeprom_host_fault_cut *const cut)
+{
+	const struct eeprom_host_fault_step *step =
+			&_eeprom_host_bench_faults_results.steps[cut->step];
+	struct eeprom_host_fault_results *results =
+			&_eeprom_host_bench_faults_results.types[step->type];
+
+	results->cut_points++;
+
+	if (cut->mount_ns > results->max_mount_ns) {
+		results->max_mount_ns = cut->mount_ns;
+	}
+
+	if (cut->recovered == true) {
+		results->recovered++;
+		return;
+	}
+
+	if (cut->mount_status != STATUS_OK) {
+		results->mount_failures++;
+
+		if (EEPROM_PAGE_CRC == false) {
+			return;
+		}
+	} else {
+		results->data_errors++;
+	}
+
+	if (_eeprom_host_bench_faults_results.listed++ <
+			EEPROM_HOST_BENCH_FAULT_LISTED) {
+		fprintf(stderr, "Not recovered: step %lu, operation %u, %u bytes "
+				"done, mount status 0x%02x\n", (unsigned long)cut->step,
+				cut->operation, cut->torn_bytes, cut->mount_status);
+	}
+}
+
+/** \internal
+ *  \brief Cuts the power at each program and erase operation of a random
+ *         workload, through every writing API of the emulator, and checks that
+ *         the memory recovers.
+ *
+ *  Transaction steps are only made when the build enables transactions. The
+ *  program exits with a failure when a mount succeeds with wrong data. With
+ *  \c EEPROM_PAGE_CRC enabled, operations are also cut partway through, and a
+ *  failed mount is a failure too; without it, a reset during a row move may
+ *  leave a memory that no longer mounts, which is only reported.
+ */
+static void _eeprom_host_bench_faults(void)
+{
+	static const char *const types[EEPROM_HOST_BENCH_FAULT_TYPES] = {
+		[EEPROM_HOST_FAULT_STEP_WRITE]        = "write",
+		[EEPROM_HOST_FAULT_STEP_FORMAT]       = "format",
+		[EEPROM_HOST_FAULT_STEP_WRITE_ASYNC]  = "async write",
+		[EEPROM_HOST_FAULT_STEP_WRITE_BUFFER] = "buffer write",
+		[EEPROM_HOST_FAULT_STEP_TRANSACTION]  = "transaction",
+		[EEPROM_HOST_FAULT_STEP_COMPACT]      = "compaction",
+	};
+	static struct eeprom_host_fault_step steps[EEPROM_HOST_BENCH_FAULT_STEPS];
+	struct eeprom_emulator_parameters parameters;
+	struct eeprom_host_fault_config config;
+	struct eeprom_host_fault_results results;
+	enum status_code status;
+	uint16_t size;
+	uint8_t *contents;
+	uint8_t *data;
+	uint8_t max_transaction_pages = EEPROM_TRANSACTION_PAGES;
+
+	if (max_transaction_pages > EEPROM_HOST_BENCH_FAULT_TRANSACTION_PAGES) {
+		max_transaction_pages = EEPROM_HOST_BENCH_FAULT_TRANSACTION_PAGES;
+	}
+
+	_eeprom_host_bench_mount(EEPROM_HOST_BENCH_PAGES);
+	eeprom_emulator_get_parameters(&parameters);
+	size = parameters.eeprom_number_of_pages * EEPROM_PAGE_SIZE;
+
+	contents = malloc(size);
+	data     = malloc((size_t)EEPROM_HOST_BENCH_FAULT_STEPS *
+			EEPROM_HOST_BENCH_FAULT_TRANSACTION_PAGES * EEPROM_PAGE_SIZE);
+	if ((contents == NULL) || (data == NULL)) {
+		fprintf(stderr, "Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	memset(contents, 0xFF, size);
+	memset(&_eeprom_host_bench_faults_results, 0,
+			sizeof(_eeprom_host_bench_faults_results));
+	srand(1);
+
+	for (uint32_t c = 0; c < EEPROM_HOST_BENCH_FAULT_STEPS; c++) {
+		struct eeprom_host_fault_step *step = &steps[c];
+		uint16_t pages = parameters.eeprom_number_of_pages;
+		uint8_t kind = rand() % 50;
+
+		step->data = &data[(size_t)c *
+				EEPROM_HOST_BENCH_FAULT_TRANSACTION_PAGES * EEPROM_PAGE_SIZE];
+
+		/* Most writes go to a few hot pages, as for application settings */
+		step->logical_page = ((rand() % 4) != 0) ? (rand() % 4) :
+				(rand() % pages);
+
+		if (kind == 0) {
+			step->type = EEPROM_HOST_FAULT_STEP_FORMAT;
+			memset(contents, 0xFF, size);
+		} else if (kind < 10) {
+			step->type   = EEPROM_HOST_FAULT_STEP_WRITE_BUFFER;
+			step->length = 1 + (rand() % (2 * EEPROM_PAGE_SIZE));
+			step->offset = rand() % (size - step->length + 1);
+			_eeprom_host_bench_fault_data(&contents[step->offset],
+					(uint8_t *)step->data, step->length);
+		} else if ((kind < 18) && (max_transaction_pages > 0)) {
+			step->type   = EEPROM_HOST_FAULT_STEP_TRANSACTION;
+			step->length = 1 + (rand() % max_transaction_pages);
+
+			if (step->logical_page + step->length > pages) {
+				step->logical_page = pages - step->length;
+			}
+
+			for (uint16_t page = 0; page < step->length; page++) {
+				_eeprom_host_bench_fault_data(
+						&contents[(step->logical_page + page) * EEPROM_PAGE_SIZE],
+						(uint8_t *)&step->data[page * EEPROM_PAGE_SIZE],
+						EEPROM_PAGE_SIZE);
+			}
+		} else {
+			if (kind < 26) {
+				step->type = EEPROM_HOST_FAULT_STEP_WRITE_ASYNC;
+			} else if (kind < 32) {
+				step->type = EEPROM_HOST_FAULT_STEP_COMPACT;
+			} else {
+				step->type = EEPROM_HOST_FAULT_STEP_WRITE;
+			}
+
+			_eeprom_host_bench_fault_data(
+					&contents[step->logical_page * EEPROM_PAGE_SIZE],
+					(uint8_t *)step->data, EEPROM_PAGE_SIZE);
+		}
+	}
+
+	_eeprom_host_bench_faults_results.steps = steps;
+
+	eeprom_host_fault_get_config_defaults(&config);
+	config.eeprom_pages = EEPROM_HOST_BENCH_PAGES;
+	config.steps        = steps;
+	config.step_count   = EEPROM_HOST_BENCH_FAULT_STEPS;
+	config.torn_points  = EEPROM_HOST_BENCH_FAULT_TORN_POINTS;
+	config.report       = _eeprom_host_bench_fault_report;
+#if defined(_SC_NPROCESSORS_ONLN)
+	config.jobs         = (uint8_t)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	status = eeprom_host_fault_run(&config, &results);
+
+	free(contents);
+	free(data);
+
+	if (status != STATUS_OK) {
+		fprintf(stderr, "Power cut run failed: 0x%02x\n", status);
+		exit(EXIT_FAILURE);
+	}
+
+	printf("%-13s %10s %10s %10s %10s %10s\n", "step", "cut points",
+			"recovered", "no mount", "bad data", "mount (ms)");
+
+	for (uint8_t c = 0; c < EEPROM_HOST_BENCH_FAULT_TYPES; c++) {
+		const struct eeprom_host_fault_results *type =
+				&_eeprom_host_bench_faults_results.types[c];
+
+		if (type->cut_points == 0) {
+			continue;
+		}
+
+		printf("%-13s %10llu %10llu %10llu %10llu %10.2f\n", types[c],
+				(unsigned long long)type->cut_points,
+				(unsigned long long)type->recovered,
+				(unsigned long long)type->mount_failures,
+				(unsigned long long)type->data_errors,
+				(double)type->max_mount_ns / 1000000);
+	}
+
+	if ((results.data_errors > 0) || ((EEPROM_PAGE_CRC == true) &&
+			(results.recovered != results.cut_points))) {
+		fprintf(stderr, "%llu of %llu power cuts not recovered\n",
+				(unsigned long long)(results.cut_points - results.recovered),
+				(unsigned long long)results.cut_points);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * \internal
+ * \brief Benchmarks of the program.
+ */
+static const struct _eeprom_host_bench _eeprom_host_benches[] = {
+	{"writes", "NVM operations per logical write",
+			_eeprom_host_bench_writes},
+	{"alternating", "Page commits per write of interleaved records",
+			_eeprom_host_bench_alternating},
+	{"cpu", "Host CPU time of initialization, page reads and writes",
+			_eeprom_host_bench_cpu},
+	{"buffer", "Host time and NVM operations of buffer transfers",
+			_eeprom_host_bench_buffer},
+	{"burst", "Latency of committed writes in bursts",
+			_eeprom_host_bench_burst},
+	{"lifetime", "Writes until the most worn row reaches 100k cycles",
+			_eeprom_host_bench_lifetime},
+	{"log", "NVM operations per record appended to the circular log",
+			_eeprom_host_bench_log},
+	{"names", "Size of encoded device names and names stored",
+			_eeprom_host_bench_names},
+	{"alerts", "Alert level writes per minute through the commit policy",
+			_eeprom_host_bench_alerts},
+	{"faults", "Recovery from power cuts through every writing API",
+			_eeprom_host_bench_faults},
+	{"endurance", "Row wear and time to 10k and 100k cycles under alerts",
+			_eeprom_host_bench_endurance},
+};
+
+/** Number of benchmarks of the program. */
+#define EEPROM_HOST_BENCH_COUNT \
+		(sizeof(_eeprom_host_benches) / sizeof(_eeprom_host_benches[0]))
+
+/** \internal
+ *  \brief Runs a benchmark.
+ *
+ *  \param[in] bench  Benchmark to run
+ */
+static void _eeprom_host_bench_run(
+		const struct _eeprom_host_bench *const bench)
+{
+	printf("%s: %s\n", bench->name, bench->description);
+	bench->run();
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	int first = 1;
+
+	/* Options come before the benchmark names */
+	while ((first + 1 < argc) && (strcmp(argv[first], "--trace") == 0)) {
+		_eeprom_host_bench_trace_path = argv[first + 1];
+		first += 2;
+	}
+
+	if (first == argc) {
+		for (uint8_t c = 0; c < EEPROM_HOST_BENCH_COUNT; c++) {
+			_eeprom_host_bench_run(&_eeprom_host_benches[c]);
+		}
+
+		return EXIT_SUCCESS;
+	}
+
+	for (int arg = first; arg < argc; arg++) {
+		uint8_t c;
+
+		for (c = 0; c < EEPROM_HOST_BENCH_COUNT; c++) {
+			if (strcmp(argv[arg], _eeprom_host_benches[c].name) == 0) {
+				break;
+			}
+		}
+
+		if (c == EEPROM_HOST_BENCH_COUNT) {
+			fprintf(stderr, "Unknown benchmark: %s\n", argv[arg]);
+			return EXIT_FAILURE;
+		}
+
+		_eeprom_host_bench_run(&_eeprom_host_benches[c]);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,514 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator endurance projection
+ *
+ * Host simulator replaying write loads to project the wear of the emulated
+ * EEPROM; see eeprom_host_endurance.h.
+ */
+#include "eeprom_host_endurance.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Maximum number of logical pages of the modeled EEPROM section. */
+#define EEPROM_HOST_ENDURANCE_MAX_LOGICAL_PAGES  (EEPROM_HOST_NVM_MAX_PAGES / 2)
+
+/** Maximum number of synthetic write sources. */
+#define EEPROM_HOST_ENDURANCE_MAX_SOURCES        UINT8_MAX
+
+/** Maximum number of compaction steps made after a write. */
+#define EEPROM_HOST_ENDURANCE_COMPACTION_STEPS   64
+
+/**
+ * \internal
+ * \brief Internal endurance projection instance struct.
+ */
+struct _eeprom_host_endurance {
+	/** Configuration of the projection in progress. */
+	const struct eeprom_host_endurance_config *config;
+	/** Wear caused by the writes to each logical page. */
+	struct eeprom_host_endurance_page pages[EEPROM_HOST_ENDURANCE_MAX_LOGICAL_PAGES];
+	/** Device time of the next write of each synthetic source. */
+	uint64_t source_next_ms[EEPROM_HOST_ENDURANCE_MAX_SOURCES];
+	/** Page contents of a counter write. */
+	uint8_t data[EEPROM_PAGE_SIZE];
+};
+
+/**
+ * \internal
+ * \brief Internal endurance projection instance.
+ */
+static struct _eeprom_host_endurance _host_endurance;
+
+/**
+ * \internal
+ * \brief Alert level page contents written by the events of alert traces,
+ *        for each alert level.
+ */
+static uint8_t _host_endurance_alert_pages[EEPROM_HOST_ENDURANCE_ALERT_LEVELS]
+		[EEPROM_PAGE_SIZE];
+
+/** \internal
+ *  \brief Lets the NVM controller complete its operation in progress.
+ */
+static void _eeprom_host_endurance_idle(void)
+{
+	eeprom_host_nvm_advance(EEPROM_HOST_NVM_ROW_ERASE_NS);
+}
+
+/** \internal
+ *  \brief Writes a logical page and commits it to the physical memory.
+ *
+ *  \param[in] logical_page  Logical page to write
+ *  \param[in] data          Data to write, or \c NULL to change the first
+ *                           bytes of the page, as a counter of its writes
+ *
+ *  \return Status of the write.
+ */
+static enum status_code _eeprom_host_endurance_write(
+		const uint16_t logical_page,
+		const uint8_t *data)
+{
+	struct eeprom_host_endurance_page *const page =
+			&_host_endurance.pages[logical_page];
+	struct eeprom_host_nvm_statistics statistics;
+	enum status_code status;
+	uint32_t row_erases;
+
+	if (data == NULL) {
+		uint32_t count = (uint32_t)page->writes + 1;
+
+		status = eeprom_emulator_read_page(logical_page, _host_endurance.data);
+		if (status != STATUS_OK) {
+			return status;
+		}
+
+		memcpy(_host_endurance.data, &count, sizeof(count));
+		data = _host_endurance.data;
+	}
+
+	eeprom_host_nvm_get_statistics(&statistics);
+	row_erases = statistics.row_erases;
+
+	status = eeprom_emulator_write_page(logical_page, data);
+	if (status != STATUS_OK) {
+		return status;
+	}
+
+	status = eeprom_emulator_commit_page_buffer();
+	if (status != STATUS_OK) {
+		return status;
+	}
+
+	_eeprom_host_endurance_idle();
+
+	if (_host_endurance.config->idle_compaction == true) {
+		for (uint8_t c = 0; c < EEPROM_HOST_ENDURANCE_COMPACTION_STEPS; c++) {
+			if (eeprom_emulator_compact() != STATUS_BUSY) {
+				break;
+			}
+
+			_eeprom_host_endurance_idle();
+		}
+	}
+
+	eeprom_host_nvm_get_statistics(&statistics);
+
+	page->logical_page = logical_page;
+	page->writes++;
+	page->row_erases  += statistics.row_erases - row_erases;
+
+	return STATUS_OK;
+}
+
+/** \internal
+ *  \brief Finds the most erased row of the modeled EEPROM section.
+ *
+ *  \param[in,out] results  Results whose row erase counts and most erased row
+ *                          are updated
+ *
+ *  \return Number of erases of the most erased row.
+ */
+static uint32_t _eeprom_host_endurance_update_rows(
+		struct eeprom_host_endurance_results *const results)
+{
+	for (uint16_t c = 0; c < results->rows; c++) {
+		results->row_erases[c] = eeprom_host_nvm_get_row_erase_count(c);
+
+		if (results->row_erases[c] > results->row_erases[results->hottest_row]) {
+			results->hottest_row = c;
+		}
+	}
+
+	return results->row_erases[results->hottest_row];
+}
+
+/** \internal
+ *  \brief Selects the logical pages whose writes caused the most row erases.
+ *
+ *  \param[in,out] results  Results whose hottest logical pages are set
+ */
+static void _eeprom_host_endurance_select_hot_pages(
+		struct eeprom_host_endurance_results *const results)
+{
+	bool selected[EEPROM_HOST_ENDURANCE_MAX_LOGICAL_PAGES];
+
+	memset(selected, 0, sizeof(selected));
+
+	for (uint8_t c = 0; c < EEPROM_HOST_ENDURANCE_HOT_PAGES; c++) {
+		const struct eeprom_host_endurance_page *hottest = NULL;
+
+		for (uint16_t p = 0; p < EEPROM_HOST_ENDURANCE_MAX_LOGICAL_PAGES; p++) {
+			const struct eeprom_host_endurance_page *const page =
+					&_host_endurance.pages[p];
+
+			if ((selected[p] == true) || (page->writes == 0)) {
+				continue;
+			}
+
+			if ((hottest == NULL) ||
+					(page->row_erases > hottest->row_erases) ||
+					((page->row_erases == hottest->row_erases) &&
+						(page->writes > hottest->writes))) {
+				hottest = page;
+			}
+		}
+
+		if (hottest == NULL) {
+			break;
+		}
+
+		selected[hottest->logical_page] = true;
+		results->hot_pages[results->hot_page_count++] = *hottest;
+	}
+}
+
+/** \internal
+ *  \brief Checks the write load of a configuration.
+ *
+ *  \param[in] config         Configuration to check
+ *  \param[in] logical_pages  Number of logical pages of the emulated EEPROM
+ *
+ *  \return Status of the check.
+ *
+ *  \retval STATUS_OK               The write load is valid
+ *  \retval STATUS_ERR_INVALID_ARG  Events are out of order, or a period is
+ *                                  invalid
+ *  \retval STATUS_ERR_BAD_ADDRESS  A logical page is out of range
+ */
+static enum status_code _eeprom_host_endurance_check_load(
+		const struct eeprom_host_endurance_config *const config,
+		const uint16_t logical_pages)
+{
+	for (uint32_t c = 0; c < config->event_count; c++) {
+		const struct eeprom_host_endurance_event *const event =
+				&config->events[c];
+
+		if (event->logical_page >= logical_pages) {
+			return STATUS_ERR_BAD_ADDRESS;
+		}
+
+		if ((c > 0) && (event->time_ms < config->events[c - 1].time_ms)) {
+			return STATUS_ERR_INVALID_ARG;
+		}
+	}
+
+	/* A repeated trace must end before its next repetition starts */
+	if ((config->trace_period_ms > 0) && (config->event_count > 0) &&
+			(config->trace_period_ms <=
+				config->events[config->event_count - 1].time_ms)) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	for (uint8_t c = 0; c < config->source_count; c++) {
+		if (config->sources[c].logical_page >= logical_pages) {
+			return STATUS_ERR_BAD_ADDRESS;
+		}
+
+		if (config->sources[c].period_ms == 0) {
+			return STATUS_ERR_INVALID_ARG;
+		}
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Initializes an endurance projection configuration structure to
+ *        defaults.
+ *
+ * The default configuration replays no write load on the 64-page EEPROM
+ * section of the host NVM model for up to twenty years, with idle compaction,
+ * and projects the times to 10000 and 100000 erase cycles.
+ *
+ * \param[out] config  Configuration structure to initialize to default values
+ */
+void eeprom_host_endurance_get_config_defaults(
+		struct eeprom_host_endurance_config *const config)
+{
+	config->eeprom_pages     = 64;
+	config->events           = NULL;
+	config->event_count      = 0;
+	config->trace_period_ms  = 0;
+	config->sources          = NULL;
+	config->source_count     = 0;
+	config->duration_ms      = 20 * EEPROM_HOST_ENDURANCE_YEAR_MS;
+	config->target_cycles[0] = 10000;
+	config->target_cycles[1] = 100000;
+	config->idle_compaction  = true;
+}
+
+/**
+ * \brief Projects the wear of the emulated EEPROM under a write load.
+ *
+ * Replays the write load of the configuration on a freshly formatted emulated
+ * EEPROM, as described in eeprom_host_endurance.h. The host NVM model is left
+ * in the state reached at the end of the simulation.
+ *
+ * \param[in]  config   Configuration of the projection
+ * \param[out] results  Outcome of the projection
+ *
+ * \return Status of the projection.
+ *
+ * \retval STATUS_OK               The write load was replayed
+ * \retval STATUS_ERR_INVALID_ARG  The configuration is invalid
+ * \retval STATUS_ERR_BAD_ADDRESS  A logical page of the write load is out of
+ *                                 range
+ * \retval STATUS_ERR_NO_MEMORY    The EEPROM section is too small or too large
+ */
+enum status_code eeprom_host_endurance_run(
+		const struct eeprom_host_endurance_config *const config,
+		struct eeprom_host_endurance_results *const results)
+{
+	struct eeprom_emulator_parameters parameters;
+	enum status_code status;
+	uint64_t trace_start_ms = 0;
+	uint32_t event = 0;
+	uint32_t max_erases = 0;
+
+	memset(results, 0, sizeof(*results));
+	memset(&_host_endurance, 0, sizeof(_host_endurance));
+
+	if ((config->eeprom_pages > EEPROM_HOST_NVM_MAX_PAGES) ||
+			((config->events == NULL) && (config->event_count > 0)) ||
+			((config->sources == NULL) && (config->source_count > 0))) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	_host_endurance.config = config;
+
+	/* Start from a freshly formatted memory */
+	eeprom_host_nvm_init(config->eeprom_pages);
+	eeprom_emulator_init();
+	eeprom_emulator_erase_memory();
+
+	status = eeprom_emulator_init();
+	if (status != STATUS_OK) {
+		return status;
+	}
+
+	eeprom_emulator_get_parameters(&parameters);
+
+	status = _eeprom_host_endurance_check_load(config,
+			parameters.eeprom_number_of_pages);
+	if (status != STATUS_OK) {
+		return status;
+	}
+
+	results->rows = config->eeprom_pages / NVMCTRL_ROW_PAGES;
+
+	for (uint8_t c = 0; c < config->source_count; c++) {
+		_host_endurance.source_next_ms[c] = config->sources[c].period_ms;
+	}
+
+	while (max_erases < config->target_cycles[EEPROM_HOST_ENDURANCE_TARGETS - 1]) {
+		const uint8_t *data;
+		uint16_t logical_page;
+		uint64_t next_ms = UINT64_MAX;
+		uint8_t source = EEPROM_HOST_ENDURANCE_MAX_SOURCES;
+		uint32_t erases_before;
+
+		/* Pick the next write, from the trace or a synthetic source */
+		if (event < config->event_count) {
+			next_ms = trace_start_ms + config->events[event].time_ms;
+		}
+
+		for (uint8_t c = 0; c < config->source_count; c++) {
+			if (_host_endurance.source_next_ms[c] < next_ms) {
+				next_ms = _host_endurance.source_next_ms[c];
+				source  = c;
+			}
+		}
+
+		if (next_ms == UINT64_MAX) {
+			break;
+		}
+
+		if (next_ms > config->duration_ms) {
+			results->simulated_ms = config->duration_ms;
+			break;
+		}
+
+		if (source == EEPROM_HOST_ENDURANCE_MAX_SOURCES) {
+			logical_page = config->events[event].logical_page;
+			data         = config->events[event].data;
+
+			if ((++event == config->event_count) &&
+					(config->trace_period_ms > 0)) {
+				event = 0;
+				trace_start_ms += config->trace_period_ms;
+			}
+		} else {
+			logical_page = config->sources[source].logical_page;
+			data         = NULL;
+
+			_host_endurance.source_next_ms[source] +=
+					config->sources[source].period_ms;
+		}
+
+		erases_before = _host_endurance.pages[logical_page].row_erases;
+
+		status = _eeprom_host_endurance_write(logical_page, data);
+		if (status != STATUS_OK) {
+			return status;
+		}
+
+		results->simulated_ms = next_ms;
+		results->writes++;
+
+		/* Record the targets reached by the rows erased by the write */
+		if (_host_endurance.pages[logical_page].row_erases != erases_before) {
+			max_erases = _eeprom_host_endurance_update_rows(results);
+
+			for (uint8_t c = 0; c < EEPROM_HOST_ENDURANCE_TARGETS; c++) {
+				if ((results->target_reached[c] == false) &&
+						(max_erases >= config->target_cycles[c])) {
+					results->target_ms[c]      = next_ms;
+					results->target_reached[c] = true;
+				}
+			}
+		}
+	}
+
+	max_erases = _eeprom_host_endurance_update_rows(results);
+
+	/* Project the targets not reached from the average erase rate */
+	for (uint8_t c = 0; c < EEPROM_HOST_ENDURANCE_TARGETS; c++) {
+		if (results->target_reached[c] == true) {
+			continue;
+		}
+
+		if (max_erases == 0) {
+			results->target_ms[c] = UINT64_MAX;
+		} else {
+			results->target_ms[c] = (uint64_t)((double)config->target_cycles[c] *
+					results->simulated_ms / max_erases);
+		}
+	}
+
+	_eeprom_host_endurance_select_hot_pages(results);
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Loads an alert trace from a text file.
+ *
+ * Reads the alerts of a trace file, one per line giving the device time of
+ * the alert in milliseconds and the alert level, separated by blanks. Blank
+ * lines and lines starting with \c # are skipped. Each alert is turned into a
+ * write of logical page zero holding the alert level in its first byte, the
+ * other bytes being left erased, as \c app_immediate_alert() writes it in the
+ * Find Me application.
+ *
+ * \param[in]  path   Path of the trace file
+ * \param[out] trace  Trace to fill, to be released with
+ *                    \ref eeprom_host_endurance_free_trace()
+ *
+ * \return Status of the load.
+ *
+ * \retval STATUS_OK             The trace was loaded
+ * \retval STATUS_ERR_NOT_FOUND  The file could not be opened
+ * \retval STATUS_ERR_BAD_DATA   A line is malformed, an alert level is out of
+ *                               range, or alerts are out of time order
+ * \retval STATUS_ERR_NO_MEMORY  The trace does not fit in memory
+ */
+enum status_code eeprom_host_endurance_load_alerts(
+		const char *const path,
+		struct eeprom_host_endurance_trace *const trace)
+{
+	struct eeprom_host_endurance_event *events;
+	uint32_t capacity = 0;
+	char line[128];
+	FILE *file;
+
+	trace->events      = NULL;
+	trace->event_count = 0;
+
+	for (uint8_t c = 0; c < EEPROM_HOST_ENDURANCE_ALERT_LEVELS; c++) {
+		memset(_host_endurance_alert_pages[c], 0xFF, EEPROM_PAGE_SIZE);
+		_host_endurance_alert_pages[c][0] = c;
+	}
+
+	file = fopen(path, "r");
+	if (file == NULL) {
+		return STATUS_ERR_NOT_FOUND;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		const char *text = line + strspn(line, " \t\r\n");
+		unsigned long long time_ms;
+		unsigned int level;
+		char extra;
+
+		/* Skip blank and comment lines */
+		if ((*text == '\0') || (*text == '#')) {
+			continue;
+		}
+
+		if ((sscanf(text, "%llu %u %c", &time_ms, &level, &extra) != 2) || (level >= EEPROM_HOST_ENDURANCE_ALERT_LEVELS) ||
+				((trace->event_count > 0) &&
+					(time_ms < trace->events[trace->event_count - 1].time_ms))) {
+			eeprom_host_endurance_free_trace(trace);
+			fclose(file);
+			return STATUS_ERR_BAD_DATA;
+		}
+
+		if (trace->event_count == capacity) {
+			capacity = (capacity > 0) ? (capacity * 2) : 1024;
+			events   = realloc(trace->events, capacity * sizeof(*events));
+
+			if (events == NULL) {
+				eeprom_host_endurance_free_trace(trace);
+				fclose(file);
+				return STATUS_ERR_NO_MEMORY;
+			}
+
+			trace->events = events;
+		}
+
+		events = &trace->events[trace->event_count++];
+		events->time_ms      = time_ms;
+		events->logical_page = 0;
+		events->data         = _host_endurance_alert_pages[level];
+	}
+
+	fclose(file);
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Releases a trace loaded from a file.
+ *
+ * \param[in,out] trace  Trace to release, left empty
+ */
+void eeprom_host_endurance_free_trace(
+		struct eeprom_host_endurance_trace *const trace)
+{
+	free(trace->events);
+
+	trace->events      = NULL;
+	trace->event_count = 0;
+}
@@ -0,0 +1,220 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator endurance projection
+ *
+ * Host simulator projecting the wear of the physical rows of the emulated
+ * EEPROM (eeprom.c) under a given write load. The load is replayed through the
+ * emulator itself on the host NVM backend (eeprom_host_nvm.c), whose row
+ * erase counters give the wear:
+ *
+ * \code
+	gcc -DEEPROM_EMULATOR_HOST_NVM -I. eeprom.c eeprom_host_nvm.c eeprom_host_endurance.c my_test.c
+ * \endcode
+ *
+ * \section eeprom_host_endurance_load Write Load
+ * The load is made of a timestamped trace of page writes, such as the alerts
+ * recorded from \c app_immediate_alert() in the Find Me application, each
+ * writing the alert level to the first byte of logical page zero, and of
+ * synthetic sources writing a logical page at a fixed period. The trace is
+ * replayed once, or repeated with a given period. Alert traces recorded on a
+ * device are loaded from a text file by
+ * \ref eeprom_host_endurance_load_alerts(), one alert per line giving its
+ * device time in milliseconds and the alert level:
+ *
+ * \code
+	# time_ms level
+	64012 2
+	65230 0
+ * \endcode
+ *
+ * Each write is committed to the physical memory before the next one, as the
+ * Find Me application does through \ref eeprom_emulator_poll(); with
+ * \ref eeprom_host_endurance_config.idle_compaction set, the rows are then
+ * compacted with \ref eeprom_emulator_compact(), as in its main loop.
+ *
+ * Writes only take NVM time, so that years of device time are simulated in
+ * seconds; the time between writes is skipped.
+ *
+ * \section eeprom_host_endurance_projection Projection
+ * The simulation stops when the most erased row reaches the largest target
+ * number of erase cycles, when the load ends, or after the simulated duration
+ * of the configuration. The device time at which each target is reached is
+ * reported as simulated if it was, and otherwise projected from the average
+ * erase rate of the most erased row.
+ *
+ * The logical pages whose writes caused the most row erases are reported as
+ * the hottest ones, along with their number of writes.
+ */
+#ifndef EEPROM_HOST_ENDURANCE_H_INCLUDED
+#define EEPROM_HOST_ENDURANCE_H_INCLUDED
+
+#include "eeprom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \name Endurance Projection Configuration
+ * @{
+ */
+
+/** Number of target erase cycle counts projected. */
+#define EEPROM_HOST_ENDURANCE_TARGETS     2
+
+/** Number of hottest logical pages reported. */
+#define EEPROM_HOST_ENDURANCE_HOT_PAGES   8
+
+/** Number of milliseconds in a (365 day) year of device time. */
+#define EEPROM_HOST_ENDURANCE_YEAR_MS     (365ULL * 24 * 60 * 60 * 1000)
+
+/** Number of alert levels of an alert trace, from no alert to a high alert. */
+#define EEPROM_HOST_ENDURANCE_ALERT_LEVELS  3
+
+/** @} */
+
+/**
+ * \brief Write trace event structure.
+ *
+ * Single page write of a trace.
+ */
+struct eeprom_host_endurance_event {
+	/** Device time of the write from the start of the trace, in
+	 *  milliseconds. Events must be in time order. */
+	uint64_t time_ms;
+	/** Logical page written. */
+	uint16_t logical_page;
+	/** Data written, of \ref EEPROM_PAGE_SIZE bytes, or \c NULL to change the
+	 *  first bytes of the page, as a counter of its writes. */
+	const uint8_t *data;
+};
+
+/**
+ * \brief Write trace structure.
+ *
+ * Trace loaded from a file by \ref eeprom_host_endurance_load_alerts(), and
+ * released by \ref eeprom_host_endurance_free_trace().
+ */
+struct eeprom_host_endurance_trace {
+	/** Events of the trace, in time order. */
+	struct eeprom_host_endurance_event *events;
+	/** Number of events of the trace. */
+	uint32_t event_count;
+};
+
+/**
+ * \brief Synthetic write source structure.
+ *
+ * Logical page written at a fixed period, each write changing the first
+ * bytes of the page, as a counter of its writes.
+ */
+struct eeprom_host_endurance_source {
+	/** Logical page written. */
+	uint16_t logical_page;
+	/** Time between two writes, in milliseconds. */
+	uint64_t period_ms;
+};
+
+/**
+ * \brief Endurance projection configuration structure.
+ *
+ * Configuration of an endurance projection, set up by
+ * \ref eeprom_host_endurance_get_config_defaults().
+ */
+struct eeprom_host_endurance_config {
+	/** Number of pages of the modeled EEPROM section. */
+	uint16_t eeprom_pages;
+	/** Events of the trace, in time order. */
+	const struct eeprom_host_endurance_event *events;
+	/** Number of events of the trace. */
+	uint32_t event_count;
+	/** Period with which the trace is repeated, in milliseconds, or zero to
+	 *  replay it once. */
+	uint64_t trace_period_ms;
+	/** Synthetic write sources. */
+	const struct eeprom_host_endurance_source *sources;
+	/** Number of synthetic write sources. */
+	uint8_t source_count;
+	/** Longest device time simulated, in milliseconds. */
+	uint64_t duration_ms;
+	/** Target numbers of erase cycles of a row, in increasing order. */
+	uint32_t target_cycles[EEPROM_HOST_ENDURANCE_TARGETS];
+	/** Compact the rows after each write. */
+	bool idle_compaction;
+};
+
+/**
+ * \brief Logical page wear structure.
+ *
+ * Wear caused by the writes to a logical page.
+ */
+struct eeprom_host_endurance_page {
+	/** Logical page. */
+	uint16_t logical_page;
+	/** Number of writes to the page. */
+	uint64_t writes;
+	/** Number of row erases made while writing the page. */
+	uint64_t row_erases;
+};
+
+/**
+ * \brief Endurance projection results structure.
+ *
+ * Outcome of an endurance projection.
+ */
+struct eeprom_host_endurance_results {
+	/** Device time simulated, in milliseconds. */
+	uint64_t simulated_ms;
+	/** Number of page writes simulated. */
+	uint64_t writes;
+	/** Number of rows of the modeled EEPROM section. */
+	uint16_t rows;
+	/** Number of erases of each row. */
+	uint32_t row_erases[EEPROM_HOST_NVM_MAX_PAGES / NVMCTRL_ROW_PAGES];
+	/** Most erased row. */
+	uint16_t hottest_row;
+	/** Device time at which the most erased row reaches each target number
+	 *  of erase cycles, in milliseconds, or \c UINT64_MAX if it never
+	 *  does. */
+	uint64_t target_ms[EEPROM_HOST_ENDURANCE_TARGETS];
+	/** Whether each target was reached within the simulation, rather than
+	 *  projected. */
+	bool target_reached[EEPROM_HOST_ENDURANCE_TARGETS];
+	/** Number of hottest logical pages reported. */
+	uint8_t hot_page_count;
+	/** Logical pages whose writes caused the most row erases, hottest
+	 *  first. */
+	struct eeprom_host_endurance_page hot_pages[EEPROM_HOST_ENDURANCE_HOT_PAGES];
+};
+
+/** \name Configuration and Execution
+ * @{
+ */
+
+void eeprom_host_endurance_get_config_defaults(
+		struct eeprom_host_endurance_config *const config);
+
+enum status_code eeprom_host_endurance_run(
+		const struct eeprom_host_endurance_config *const config,
+		struct eeprom_host_endurance_results *const results);
+
+/** @} */
+
+/** \name Trace Files
+ * @{
+ */
+
+enum status_code eeprom_host_endurance_load_alerts(
+		const char *const path,
+		struct eeprom_host_endurance_trace *const trace);
+
+void eeprom_host_endurance_free_trace(
+		struct eeprom_host_endurance_trace *const trace);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_HOST_ENDURANCE_H_INCLUDED */
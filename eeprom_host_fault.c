@@ -0,0 +1,667 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator power-cut fault injection
+ *
+ * Host harness replaying workloads with power cuts; see eeprom_host_fault.h.
+ */
+#include "eeprom_host_fault.h"
+#include <setjmp.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <poll.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+/** Set when the cut points can be spread over worker processes. */
+#  define EEPROM_HOST_FAULT_WORKERS
+#endif
+
+/** Number of cut point results sent at once by a worker process, so that a
+ *  batch fits in a single atomic pipe write. */
+#define EEPROM_HOST_FAULT_BATCH_SIZE \
+		(512 / sizeof(struct eeprom_host_fault_cut))
+
+/** Maximum number of logical pages of the modeled EEPROM section. */
+#define EEPROM_HOST_FAULT_MAX_LOGICAL_PAGES  (EEPROM_HOST_NVM_MAX_PAGES / 2)
+
+/**
+ * \internal
+ * \brief Internal fault injection instance struct.
+ */
+struct _eeprom_host_fault {
+	/** Configuration of the run in progress. */
+	const struct eeprom_host_fault_config *config;
+	/** Totals of the run, when cut points are checked in this process. */
+	struct eeprom_host_fault_results *results;
+	/** Pipe to the calling process, when run by a worker process. */
+	int pipe;
+	/** Results not yet sent to the calling process. */
+	struct eeprom_host_fault_cut batch[EEPROM_HOST_FAULT_BATCH_SIZE];
+	/** Number of results in the batch. */
+	uint8_t batch_count;
+
+	/** Context restored when the power is cut. */
+	jmp_buf reset;
+
+	/** Memory contents before the current step. */
+	uint8_t memory_before[EEPROM_HOST_NVM_MAX_PAGES * NVMCTRL_PAGE_SIZE];
+	/** Memory contents after the current step. */
+	uint8_t memory_after[EEPROM_HOST_NVM_MAX_PAGES * NVMCTRL_PAGE_SIZE];
+	/** Logical page contents before the current step. */
+	uint8_t pages_before[EEPROM_HOST_FAULT_MAX_LOGICAL_PAGES][EEPROM_PAGE_SIZE];
+	/** Logical page contents after the current step. */
+	uint8_t pages_after[EEPROM_HOST_FAULT_MAX_LOGICAL_PAGES][EEPROM_PAGE_SIZE];
+	/** Number of logical pages of the emulated EEPROM. */
+	uint16_t logical_pages;
+};
+
+/**
+ * \internal
+ * \brief Internal fault injection instance.
+ */
+static struct _eeprom_host_fault _host_fault;
+
+/** \internal
+ *  \brief Power cut handler, resuming execution at the modeled reset.
+ *
+ *  \param[in] command  Command interrupted by the power cut
+ */
+static void _eeprom_host_fault_power_cut(
+		const enum nvm_command command)
+{
+	(void)command;
+
+	longjmp(_host_fault.reset, 1);
+}
+
+/** \internal
+ *  \brief Calls a background function of the emulator until it is done,
+ *         letting the modeled NVM operations complete in between.
+ *
+ *  \param[in] function  Function to call, \ref eeprom_emulator_poll() or
+ *                       \ref eeprom_emulator_compact()
+ *
+ *  \return Status of the last call.
+ */
+static enum status_code _eeprom_host_fault_poll(
+		enum status_code (*const function)(void))
+{
+	enum status_code status;
+
+	while ((status = function()) == STATUS_BUSY) {
+		eeprom_host_nvm_advance(1000000);
+	}
+
+	return status;
+}
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+/** \internal
+ *  \brief Writes the logical pages of a transaction step.
+ *
+ *  \param[in] step  Transaction step to run
+ *
+ *  \return Status of the transaction.
+ */
+static enum status_code _eeprom_host_fault_run_transaction(
+		const struct eeprom_host_fault_step *const step)
+{
+	enum status_code status = eeprom_emulator_begin_transaction();
+
+	if (status != STATUS_OK) {
+		return status;
+	}
+
+	for (uint16_t c = 0; c < step->length; c++) {
+		status = eeprom_emulator_write_page(step->logical_page + c,
+				&step->data[c * EEPROM_PAGE_SIZE]);
+
+		if (status != STATUS_OK) {
+			eeprom_emulator_abort_transaction();
+			return status;
+		}
+	}
+
+	return eeprom_emulator_commit_transaction();
+}
+#endif
+
+/** \internal
+ *  \brief Runs a workload step, from the mount of the memory on.
+ *
+ *  \param[in] step  Workload step to run
+ *
+ *  \return Status of the step.
+ */
+static enum status_code _eeprom_host_fault_run_step(
+		const struct eeprom_host_fault_step *const step)
+{
+	enum status_code status = eeprom_emulator_init();
+
+	if (step->type == EEPROM_HOST_FAULT_STEP_FORMAT) {
+		eeprom_emulator_erase_memory();
+		return eeprom_emulator_init();
+	}
+
+	if (status != STATUS_OK) {
+		return status;
+	}
+
+	switch (step->type) {
+	case EEPROM_HOST_FAULT_STEP_WRITE_ASYNC:
+		status = eeprom_emulator_write_page_async(step->logical_page,
+				step->data);
+		if (status != STATUS_OK) {
+			return status;
+		}
+
+		return _eeprom_host_fault_poll(eeprom_emulator_poll);
+
+	case EEPROM_HOST_FAULT_STEP_WRITE_BUFFER:
+		status = eeprom_emulator_write_buffer(step->offset, step->data,
+				step->length);
+		break;
+
+#if (EEPROM_TRANSACTION_PAGES > 0)
+	case EEPROM_HOST_FAULT_STEP_TRANSACTION:
+		return _eeprom_host_fault_run_transaction(step);
+#endif
+
+	default:
+		status = eeprom_emulator_write_page(step->logical_page, step->data);
+		break;
+	}
+
+	if (status != STATUS_OK) {
+		return status;
+	}
+
+	status = eeprom_emulator_commit_page_buffer();
+
+	if ((status == STATUS_OK) &&
+			(step->type == EEPROM_HOST_FAULT_STEP_COMPACT)) {
+		status = _eeprom_host_fault_poll(eeprom_emulator_compact);
+	}
+
+	return status;
+}
+
+/** \internal
+ *  \brief Reads back all logical pages of the mounted memory.
+ *
+ *  \param[out] pages  Buffer to fill with the page contents
+ *
+ *  \return Status of the reads.
+ */
+static enum status_code _eeprom_host_fault_read_pages(
+		uint8_t pages[][EEPROM_PAGE_SIZE])
+{
+	for (uint16_t c = 0; c < _host_fault.logical_pages; c++) {
+		enum status_code status = eeprom_emulator_read_page(c, pages[c]);
+
+		if (status != STATUS_OK) {
+			return status;
+		}
+	}
+
+	return STATUS_OK;
+}
+
+/** \internal
+ *  \brief Checks that the mounted memory holds the contents from either
+ *         before or after the current step.
+ *
+ *  \param[in] step  Workload step interrupted
+ *
+ *  \return Whether every logical page holds the expected contents.
+ */
+static bool _eeprom_host_fault_check_pages(
+		const struct eeprom_host_fault_step *const step)
+{
+	struct eeprom_emulator_parameters parameters;
+	uint8_t data[EEPROM_PAGE_SIZE];
+	bool pages_before = false;
+	bool pages_after  = false;
+
+	eeprom_emulator_get_parameters(&parameters);
+	if (parameters.eeprom_number_of_pages != _host_fault.logical_pages) {
+		return false;
+	}
+
+	for (uint16_t c = 0; c < _host_fault.logical_pages; c++) {
+		if (eeprom_emulator_read_page(c, data) != STATUS_OK) {
+			return false;
+		}
+
+		bool before = !memcmp(data, _host_fault.pages_before[c],
+				EEPROM_PAGE_SIZE);
+		bool after  = !memcmp(data, _host_fault.pages_after[c],
+				EEPROM_PAGE_SIZE);
+
+		if ((before == false) && (after == false)) {
+			return false;
+		}
+
+		/* Pages changed by the step only tell which state was recovered */
+		if (before != after) {
+			pages_before |= before;
+			pages_after  |= after;
+		}
+	}
+
+	/* A transaction is either fully applied or not at all */
+	if (step->type == EEPROM_HOST_FAULT_STEP_TRANSACTION) {
+		return !(pages_before && pages_after);
+	}
+
+	return true;
+}
+
+/** \internal
+ *  \brief Adds the result of a cut point to the totals of the run.
+ *
+ *  \param[in,out] results  Totals to update
+ *  \param[in]     cut      Result of the cut point
+ */
+static void _eeprom_host_fault_add_result(
+		struct eeprom_host_fault_results *const results,
+		const struct eeprom_host_fault_cut *const cut)
+{
+	results->cut_points++;
+	results->total_mount_ns += cut->mount_ns;
+
+	if (cut->mount_ns > results->max_mount_ns) {
+		results->max_mount_ns = cut->mount_ns;
+	}
+
+	if (cut->recovered == true) {
+		results->recovered++;
+	} else if (cut->mount_status != STATUS_OK) {
+		results->mount_failures++;
+	} else {
+		results->data_errors++;
+	}
+}
+
+/** \internal
+ *  \brief Sends the pending results of a worker process to the calling
+ *         process.
+ *
+ *  \return Whether the results were sent.
+ */
+static bool _eeprom_host_fault_flush(void)
+{
+#if defined(EEPROM_HOST_FAULT_WORKERS)
+	const uint8_t *data = (const uint8_t *)_host_fault.batch;
+	size_t length = _host_fault.batch_count * sizeof(_host_fault.batch[0]);
+
+	_host_fault.batch_count = 0;
+
+	while (length > 0) {
+		ssize_t written = write(_host_fault.pipe, data, length);
+
+		if (written <= 0) {
+			return false;
+		}
+
+		data   += written;
+		length -= (size_t)written;
+	}
+#endif
+
+	return true;
+}
+
+/** \internal
+ *  \brief Records the result of a cut point.
+ *
+ *  \param[in] cut  Result of the cut point
+ *
+ *  \return Whether the result was recorded.
+ */
+static bool _eeprom_host_fault_record(
+		const struct eeprom_host_fault_cut *const cut)
+{
+	if (_host_fault.results == NULL) {
+		_host_fault.batch[_host_fault.batch_count++] = *cut;
+
+		if (_host_fault.batch_count == EEPROM_HOST_FAULT_BATCH_SIZE) {
+			return _eeprom_host_fault_flush();
+		}
+
+		return true;
+	}
+
+	_eeprom_host_fault_add_result(_host_fault.results, cut);
+
+	if (_host_fault.config->report != NULL) {
+		_host_fault.config->report(cut);
+	}
+
+	return true;
+}
+
+/** \internal
+ *  \brief Cuts the power during an operation of a step, then checks that the
+ *         memory recovers.
+ *
+ *  \param[in]  step  Workload step interrupted
+ *  \param[out] cut   Cut point to check, whose step, operation and torn bytes
+ *                    are set; the remaining fields are filled in
+ */
+static void _eeprom_host_fault_check_cut(
+		const struct eeprom_host_fault_step *const step,
+		struct eeprom_host_fault_cut *const cut)
+{
+	struct eeprom_host_nvm_statistics statistics;
+	uint64_t mount_start;
+
+	eeprom_host_nvm_set_memory(_host_fault.memory_before);
+	eeprom_host_nvm_set_power_cut(cut->operation, cut->torn_bytes,
+			_eeprom_host_fault_power_cut);
+
+	if (setjmp(_host_fault.reset) == 0) {
+		_eeprom_host_fault_run_step(step);
+	}
+
+	eeprom_host_nvm_clear_power_cut();
+
+	eeprom_host_nvm_get_statistics(&statistics);
+	mount_start = statistics.elapsed_ns;
+
+	cut->mount_status = eeprom_emulator_init();
+
+	eeprom_host_nvm_get_statistics(&statistics);
+	cut->mount_ns = statistics.elapsed_ns - mount_start;
+
+	if (cut->mount_status == STATUS_OK) {
+		cut->recovered = _eeprom_host_fault_check_pages(step);
+	} else {
+		cut->recovered = (step->type == EEPROM_HOST_FAULT_STEP_FORMAT);
+	}
+}
+
+/** \internal
+ *  \brief Replays the workload, checking a share of its cut points.
+ *
+ *  Cut points are numbered in workload order, and each worker checks those
+ *  whose number modulo the number of workers matches its own index.
+ *
+ *  \param[in] worker  Index of the worker
+ *  \param[in] jobs    Number of workers
+ *
+ *  \return Status of the replay.
+ *
+ *  \retval STATUS_OK            The workload was replayed
+ *  \retval STATUS_ERR_BAD_DATA  A workload step failed without a power cut
+ *  \retval STATUS_ERR_IO        A result could not be recorded
+ */
+static enum status_code _eeprom_host_fault_replay(
+		const uint8_t worker,
+		const uint8_t jobs)
+{
+	const struct eeprom_host_fault_config *const config = _host_fault.config;
+	struct eeprom_emulator_parameters parameters;
+	struct eeprom_host_nvm_statistics statistics;
+	uint64_t cut_point = 0;
+
+	/* Start from a formatted memory */
+	eeprom_host_nvm_init(config->eeprom_pages);
+	eeprom_emulator_init();
+	eeprom_emulator_erase_memory();
+	if (eeprom_emulator_init() != STATUS_OK) {
+		return STATUS_ERR_BAD_DATA;
+	}
+
+	eeprom_emulator_get_parameters(&parameters);
+	_host_fault.logical_pages = parameters.eeprom_number_of_pages;
+
+	if (_eeprom_host_fault_read_pages(_host_fault.pages_before) != STATUS_OK) {
+		return STATUS_ERR_BAD_DATA;
+	}
+
+	eeprom_host_nvm_get_memory(_host_fault.memory_before);
+
+	for (uint32_t i = 0; i < config->step_count; i++) {
+		const struct eeprom_host_fault_step *const step = &config->steps[i];
+		uint32_t operations;
+
+		/* Run the step without power cut, to count its operations and get
+		 * the expected memory contents */
+		eeprom_host_nvm_clear_statistics();
+
+		if (_eeprom_host_fault_run_step(step) != STATUS_OK) {
+			return STATUS_ERR_BAD_DATA;
+		}
+
+		eeprom_host_nvm_get_statistics(&statistics);
+		operations = statistics.page_writes + statistics.row_erases;
+
+		if (_eeprom_host_fault_read_pages(_host_fault.pages_after) != STATUS_OK) {
+			return STATUS_ERR_BAD_DATA;
+		}
+
+		eeprom_host_nvm_get_memory(_host_fault.memory_after);
+
+		for (uint32_t j = 0; j < operations; j++) {
+			for (uint8_t t = 0; t <= config->torn_points; t++) {
+				struct eeprom_host_fault_cut cut;
+
+				if ((cut_point++ % jobs) != worker) {
+					continue;
+				}
+
+				memset(&cut, 0, sizeof(cut));
+				cut.step       = i;
+				cut.operation  = (uint16_t)j;
+				cut.torn_bytes = (uint8_t)((t * NVMCTRL_PAGE_SIZE) /
+						(config->torn_points + 1));
+
+				_eeprom_host_fault_check_cut(step, &cut);
+
+				if (_eeprom_host_fault_record(&cut) == false) {
+					return STATUS_ERR_IO;
+				}
+			}
+		}
+
+		/* The memory after the step is the starting point of the next one */
+		memcpy(_host_fault.memory_before, _host_fault.memory_after,
+				sizeof(_host_fault.memory_before));
+		memcpy(_host_fault.pages_before, _host_fault.pages_after,
+				sizeof(_host_fault.pages_before));
+		eeprom_host_nvm_set_memory(_host_fault.memory_before);
+	}
+
+	return STATUS_OK;
+}
+
+#if defined(EEPROM_HOST_FAULT_WORKERS)
+/** \internal
+ *  \brief Runs the workload over worker processes.
+ *
+ *  \param[in,out] results  Totals to update
+ *  \param[in]     jobs     Number of worker processes
+ *
+ *  \return Status of the run.
+ *
+ *  \retval STATUS_OK            The workload was replayed
+ *  \retval STATUS_ERR_BAD_DATA  A workload step failed without a power cut
+ *  \retval STATUS_ERR_IO        A worker process could not be run
+ */
+static enum status_code _eeprom_host_fault_run_workers(
+		struct eeprom_host_fault_results *const results,
+		const uint8_t jobs)
+{
+	struct pollfd pipes[UINT8_MAX];
+	pid_t workers[UINT8_MAX];
+	uint8_t started = 0;
+	uint8_t open_pipes;
+	enum status_code status = STATUS_OK;
+
+	for (started = 0; started < jobs; started++) {
+		int fds[2];
+
+		if (pipe(fds) != 0) {
+			status = STATUS_ERR_IO;
+			break;
+		}
+
+		workers[started] = fork();
+
+		if (workers[started] == 0) {
+			close(fds[0]);
+			for (uint8_t c = 0; c < started; c++) {
+				close(pipes[c].fd);
+			}
+
+			_host_fault.results     = NULL;
+			_host_fault.pipe        = fds[1];
+			_host_fault.batch_count = 0;
+
+			status = _eeprom_host_fault_replay(started, jobs);
+			if ((status == STATUS_OK) && (_eeprom_host_fault_flush() == false)) {
+				status = STATUS_ERR_IO;
+			}
+
+			_exit((int)status);
+		}
+
+		close(fds[1]);
+
+		if (workers[started] < 0) {
+			close(fds[0]);
+			status = STATUS_ERR_IO;
+			break;
+		}
+
+		pipes[started].fd     = fds[0];
+		pipes[started].events = POLLIN;
+	}
+
+	/* Gather the results until every worker has closed its pipe */
+	open_pipes = started;
+
+	while (open_pipes > 0) {
+		if (poll(pipes, started, -1) < 0) {
+			continue;
+		}
+
+		for (uint8_t c = 0; c < started; c++) {
+			ssize_t length;
+
+			if ((pipes[c].fd < 0) || (pipes[c].revents == 0)) {
+				continue;
+			}
+
+			/* Batches are sent in single writes smaller than the pipe
+			 * buffer, so that only whole results are received */
+			length = read(pipes[c].fd, _host_fault.batch,
+					sizeof(_host_fault.batch));
+
+			if (length <= 0) {
+				close(pipes[c].fd);
+				pipes[c].fd = -1;
+				open_pipes--;
+				continue;
+			}
+
+			for (size_t r = 0; r < (size_t)length / sizeof(_host_fault.batch[0]);
+					r++) {
+				_eeprom_host_fault_add_result(results, &_host_fault.batch[r]);
+
+				if (_host_fault.config->report != NULL) {
+					_host_fault.config->report(&_host_fault.batch[r]);
+				}
+			}
+		}
+	}
+
+	for (uint8_t c = 0; c < started; c++) {
+		int exit_status;
+
+		if ((waitpid(workers[c], &exit_status, 0) < 0) ||
+				!WIFEXITED(exit_status)) {
+			status = STATUS_ERR_IO;
+		} else if ((WEXITSTATUS(exit_status) != STATUS_OK) &&
+				(status == STATUS_OK)) {
+			status = (enum status_code)WEXITSTATUS(exit_status);
+		}
+	}
+
+	return status;
+}
+#endif
+
+/**
+ * \brief Initializes a fault injection configuration structure to defaults.
+ *
+ * The default configuration checks no workload, on the 64-page EEPROM section
+ * of the host NVM model, with three partial operation points per cut point
+ * and a single process.
+ *
+ * \param[out] config  Configuration structure to initialize to default values
+ */
+void eeprom_host_fault_get_config_defaults(
+		struct eeprom_host_fault_config *const config)
+{
+	config->eeprom_pages = 64;
+	config->steps        = NULL;
+	config->step_count   = 0;
+	config->torn_points  = 3;
+	config->jobs         = 1;
+	config->report       = NULL;
+}
+
+/**
+ * \brief Checks the recovery of the emulated EEPROM from power cuts.
+ *
+ * Replays the workload of the configuration, cutting the power at each cut
+ * point in turn and checking that the memory recovers, as described in
+ * eeprom_host_fault.h. The host NVM model is left in an unspecified state.
+ *
+ * \param[in]  config   Configuration of the run
+ * \param[out] results  Totals of the run
+ *
+ * \return Status of the run.
+ *
+ * \retval STATUS_OK              The workload was replayed; see the results
+ *                                for the recovery of its cut points
+ * \retval STATUS_ERR_INVALID_ARG The configuration is invalid, or holds
+ *                                transaction steps larger than
+ *                                \c EEPROM_TRANSACTION_PAGES
+ * \retval STATUS_ERR_BAD_DATA    A workload step failed without a power cut
+ * \retval STATUS_ERR_IO          A worker process could not be run, in which
+ *                                case the results are incomplete
+ */
+enum status_code eeprom_host_fault_run(
+		const struct eeprom_host_fault_config *const config,
+		struct eeprom_host_fault_results *const results)
+{
+	memset(results, 0, sizeof(*results));
+
+	if ((config->eeprom_pages > EEPROM_HOST_NVM_MAX_PAGES) ||
+			(config->torn_points > EEPROM_HOST_FAULT_MAX_TORN_POINTS) ||
+			((config->steps == NULL) && (config->step_count > 0))) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	for (uint32_t c = 0; c < config->step_count; c++) {
+		if ((config->steps[c].type == EEPROM_HOST_FAULT_STEP_TRANSACTION) &&
+				(config->steps[c].length > EEPROM_TRANSACTION_PAGES)) {
+			return STATUS_ERR_INVALID_ARG;
+		}
+	}
+
+	_host_fault.config  = config;
+	_host_fault.results = results;
+
+#if defined(EEPROM_HOST_FAULT_WORKERS)
+	if (config->jobs > 1) {
+		return _eeprom_host_fault_run_workers(results, config->jobs);
+	}
+#endif
+
+	return _eeprom_host_fault_replay(0, 1);
+}
@@ -0,0 +1,183 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator power-cut fault injection
+ *
+ * Host harness checking that the EEPROM emulator (eeprom.c) recovers from a
+ * power loss at any point of a recorded workload. It runs on the host NVM
+ * backend (eeprom_host_nvm.c), whose power cut injection it drives:
+ *
+ * \code
+	gcc -DEEPROM_EMULATOR_HOST_NVM -I. eeprom.c eeprom_host_nvm.c eeprom_host_fault.c my_test.c
+ * \endcode
+ *
+ * The host Makefile runs the workload of the \c faults benchmark of
+ * eeprom_host_bench.c this way, with <tt>make faults</tt>.
+ *
+ * \section eeprom_host_fault_workload Workload
+ * A workload is a sequence of steps, each of which writes through one of the
+ * emulator APIs and commits what it wrote, or formats the emulated EEPROM; see
+ * \ref eeprom_host_fault_step_type. Each step starts by mounting the memory
+ * with \ref eeprom_emulator_init(), as after a reset of the device, and the
+ * workload starts from a formatted memory.
+ *
+ * \section eeprom_host_fault_cuts Cut Points
+ * The power is cut once for each page program and row erase issued by each
+ * step, including its mount, just before the operation takes place. With
+ * \ref eeprom_host_fault_config.torn_points set, the power is also cut partway
+ * through each operation, at evenly spaced byte offsets of the page program,
+ * or of each page of the row erase.
+ *
+ * After each cut, the memory is mounted again, and the time taken by the
+ * mount is measured on the modeled NVM timings. The cut is recovered when the
+ * mount succeeds and every logical page holds its contents from either before
+ * or after the step; the pages of a transaction must all hold the same one. A
+ * format step may also leave a memory that fails to mount, which the
+ * application then formats again.
+ *
+ * \section eeprom_host_fault_jobs Parallel Runs
+ * On POSIX hosts, the cut points are spread over
+ * \ref eeprom_host_fault_config.jobs worker processes, each of which replays
+ * the whole workload and checks its share of the cut points. Each worker
+ * sends its results back through a pipe, so that the report callback and the
+ * totals are handled by the calling process only, with the cut points
+ * reported in no particular order.
+ */
+#ifndef EEPROM_HOST_FAULT_H_INCLUDED
+#define EEPROM_HOST_FAULT_H_INCLUDED
+
+#include "eeprom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of partial operation points of each cut point. */
+#define EEPROM_HOST_FAULT_MAX_TORN_POINTS  (NVMCTRL_PAGE_SIZE - 1)
+
+/**
+ * \brief Workload step type enum.
+ *
+ * Kind of a step of a workload.
+ */
+enum eeprom_host_fault_step_type {
+	/** Write a logical page, then commit the page buffer. */
+	EEPROM_HOST_FAULT_STEP_WRITE,
+	/** Format the emulated EEPROM memory. */
+	EEPROM_HOST_FAULT_STEP_FORMAT,
+	/** Write a logical page with \ref eeprom_emulator_write_page_async(),
+	 *  then commit it with \ref eeprom_emulator_poll() calls. */
+	EEPROM_HOST_FAULT_STEP_WRITE_ASYNC,
+	/** Write bytes at an offset with \ref eeprom_emulator_write_buffer(),
+	 *  then commit the page buffer. */
+	EEPROM_HOST_FAULT_STEP_WRITE_BUFFER,
+	/** Write consecutive logical pages within a single transaction. */
+	EEPROM_HOST_FAULT_STEP_TRANSACTION,
+	/** Write a logical page and commit the page buffer, then compact the
+	 *  memory with \ref eeprom_emulator_compact() calls. */
+	EEPROM_HOST_FAULT_STEP_COMPACT,
+};
+
+/**
+ * \brief Workload step structure.
+ *
+ * Single step of a workload.
+ */
+struct eeprom_host_fault_step {
+	/** Kind of step. */
+	enum eeprom_host_fault_step_type type;
+	/** Logical page written by the step, or first logical page written by a
+	 *  transaction step. */
+	uint16_t logical_page;
+	/** Byte offset written by a buffer write step. */
+	uint16_t offset;
+	/** Number of bytes written by a buffer write step, or number of logical
+	 *  pages written by a transaction step. */
+	uint16_t length;
+	/** Data written by the step, of \ref EEPROM_PAGE_SIZE bytes per logical
+	 *  page written, or of the length of a buffer write step. */
+	const uint8_t *data;
+};
+
+/**
+ * \brief Cut point result structure.
+ *
+ * Outcome of a single power cut, passed to the report callback.
+ */
+struct eeprom_host_fault_cut {
+	/** Index of the workload step interrupted. */
+	uint32_t step;
+	/** Index of the program or erase operation interrupted within the step,
+	 *  counting the operations of its mount. */
+	uint16_t operation;
+	/** Number of bytes of the operation that took effect. */
+	uint8_t torn_bytes;
+	/** Whether the emulated EEPROM recovered the expected data. */
+	bool recovered;
+	/** Status returned by the mount following the cut. */
+	enum status_code mount_status;
+	/** Modeled time taken by the mount following the cut, in nanoseconds. */
+	uint64_t mount_ns;
+};
+
+/**
+ * \brief Fault injection configuration structure.
+ *
+ * Configuration of a fault injection run, set up by
+ * \ref eeprom_host_fault_get_config_defaults().
+ */
+struct eeprom_host_fault_config {
+	/** Number of pages of the modeled EEPROM section. */
+	uint16_t eeprom_pages;
+	/** Steps of the workload. */
+	const struct eeprom_host_fault_step *steps;
+	/** Number of steps of the workload. */
+	uint32_t step_count;
+	/** Number of partial operation points of each cut point, up to
+	 *  \ref EEPROM_HOST_FAULT_MAX_TORN_POINTS. */
+	uint8_t torn_points;
+	/** Number of worker processes. */
+	uint8_t jobs;
+	/** Callback called for each cut point, or \c NULL. */
+	void (*report)(const struct eeprom_host_fault_cut *const cut);
+};
+
+/**
+ * \brief Fault injection results structure.
+ *
+ * Totals of a fault injection run.
+ */
+struct eeprom_host_fault_results {
+	/** Number of cut points checked. */
+	uint64_t cut_points;
+	/** Number of cut points recovered. */
+	uint64_t recovered;
+	/** Number of cut points not recovered, as the mount failed. */
+	uint64_t mount_failures;
+	/** Number of cut points not recovered, as the mount succeeded with
+	 *  wrong data. */
+	uint64_t data_errors;
+	/** Sum of the modeled mount times, in nanoseconds. */
+	uint64_t total_mount_ns;
+	/** Longest modeled mount time, in nanoseconds. */
+	uint64_t max_mount_ns;
+};
+
+/** \name Configuration and Execution
+ * @{
+ */
+
+void eeprom_host_fault_get_config_defaults(
+		struct eeprom_host_fault_config *const config);
+
+enum status_code eeprom_host_fault_run(
+		const struct eeprom_host_fault_config *const config,
+		struct eeprom_host_fault_results *const results);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_HOST_FAULT_H_INCLUDED */
@@ -0,0 +1,499 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator host NVM backend
+ *
+ * RAM-backed model of the SAM NVM controller; see eeprom_host_nvm.h.
+ */
+#include "eeprom_host_nvm.h"
+#include <string.h>
+
+/**
+ * \internal
+ * \brief Internal host NVM model instance struct.
+ */
+struct _eeprom_host_nvm {
+	/** Modeled EEPROM section of the FLASH, located at its end. */
+	uint8_t memory[EEPROM_HOST_NVM_MAX_PAGES * NVMCTRL_PAGE_SIZE];
+	/** Number of pages of the EEPROM section, as set in the fuses. */
+	uint16_t eeprom_pages;
+
+	/** NVM controller page buffer. */
+	uint8_t page_buffer[NVMCTRL_PAGE_SIZE];
+
+	/** Modeled time left until the NVM operation in progress completes, in
+	 *  nanoseconds. */
+	uint32_t busy_ns;
+
+	/** Number of times each row has been erased since initialization. */
+	uint32_t row_erase_count[EEPROM_HOST_NVM_MAX_PAGES / NVMCTRL_ROW_PAGES];
+
+	/** Indicates if a power cut is pending. */
+	bool power_cut_armed;
+	/** Indicates if the power has been cut; program and erase commands are
+	 *  then ignored. */
+	bool power_off;
+	/** Number of program or erase operations left before the power cut. */
+	uint32_t power_cut_operations;
+	/** Number of bytes of the interrupted operation that take effect. */
+	uint8_t power_cut_torn_bytes;
+	/** Handler called when the power is cut. */
+	eeprom_host_nvm_power_cut_handler_t power_cut_handler;
+
+	/** Operation counters since the last statistics clear. */
+	struct eeprom_host_nvm_statistics statistics;
+};
+
+/**
+ * \internal
+ * \brief Internal host NVM model instance.
+ */
+static struct _eeprom_host_nvm _host_nvm;
+
+/** \internal
+ *  \brief Translates an NVM address into an offset in the modeled memory.
+ *
+ *  \param[in]  address  NVM byte address to translate
+ *  \param[in]  length   Number of bytes that will be accessed
+ *  \param[out] offset   Byte offset in the modeled EEPROM section
+ *
+ *  \return Whether the access lies entirely within the EEPROM section.
+ */
+static bool _eeprom_host_nvm_offset(
+		const uint32_t address,
+		const uint16_t length,
+		uint32_t *const offset)
+{
+	uint32_t size  = (uint32_t)_host_nvm.eeprom_pages * NVMCTRL_PAGE_SIZE;
+	uint32_t start = FLASH_SIZE - size;
+
+	if ((address < start) || ((address - start) + length > size)) {
+		return false;
+	}
+
+	*offset = address - start;
+	return true;
+}
+
+/** \internal
+ *  \brief Waits for the NVM operation in progress to complete.
+ *
+ *  Accesses to the FLASH stall until the NVM controller is ready; the stalled
+ *  time is accounted, and the operation is then considered complete.
+ */
+static void _eeprom_host_nvm_wait(void)
+{
+	_host_nvm.statistics.stall_ns += _host_nvm.busy_ns;
+	_host_nvm.busy_ns = 0;
+}
+
+/** \internal
+ *  \brief Checks if the power is cut at a program or erase operation.
+ *
+ *  \return Whether the operation is interrupted by the power cut.
+ */
+static bool _eeprom_host_nvm_power_fails(void)
+{
+	if (_host_nvm.power_cut_armed == false) {
+		return false;
+	}
+
+	if (_host_nvm.power_cut_operations > 0) {
+		_host_nvm.power_cut_operations--;
+		return false;
+	}
+
+	return true;
+}
+
+/** \internal
+ *  \brief Cuts the power after an interrupted operation took partial effect.
+ *
+ *  \param[in] command  Interrupted command
+ */
+static void _eeprom_host_nvm_power_cut(
+		const enum nvm_command command)
+{
+	_host_nvm.power_off       = true;
+	_host_nvm.power_cut_armed = false;
+	_host_nvm.busy_ns         = 0;
+
+	if (_host_nvm.power_cut_handler != NULL) {
+		_host_nvm.power_cut_handler(command);
+	}
+}
+
+/**
+ * \brief Resets the modeled FLASH to the erased state.
+ *
+ * Resets the modeled EEPROM section to all 0xFF bytes, as shipped from the
+ * factory, and clears all statistics and row erase counters.
+ *
+ * \param[in] eeprom_pages  Size of the EEPROM section set in the fuses, in
+ *                          pages (at most \ref EEPROM_HOST_NVM_MAX_PAGES)
+ */
+void eeprom_host_nvm_init(
+		const uint16_t eeprom_pages)
+{
+	memset(&_host_nvm, 0, sizeof(_host_nvm));
+	memset(_host_nvm.memory, 0xFF, sizeof(_host_nvm.memory));
+	memset(_host_nvm.page_buffer, 0xFF, sizeof(_host_nvm.page_buffer));
+
+	_host_nvm.eeprom_pages = (eeprom_pages > EEPROM_HOST_NVM_MAX_PAGES) ?
+			EEPROM_HOST_NVM_MAX_PAGES : eeprom_pages;
+}
+
+/**
+ * \brief Translates an NVM address into a pointer to the modeled memory.
+ *
+ * \param[in] address  NVM byte address inside the EEPROM section
+ *
+ * \return Pointer to the modeled memory, or \c NULL if the address lies outside
+ *         of the EEPROM section.
+ */
+const void *eeprom_host_nvm_pointer(
+		const uint32_t address)
+{
+	uint32_t offset;
+
+	if (_eeprom_host_nvm_offset(address, 0, &offset) == false) {
+		return NULL;
+	}
+
+	return &_host_nvm.memory[offset];
+}
+
+/**
+ * \brief Accounts a direct memory-mapped read of the modeled memory.
+ *
+ * \param[in] address  NVM byte address of the first byte read
+ * \param[in] length   Number of bytes read
+ */
+void eeprom_host_nvm_trace_read(
+		const uint32_t address,
+		const uint16_t length)
+{
+	(void)address;
+
+	_eeprom_host_nvm_wait();
+
+	_host_nvm.statistics.direct_reads++;
+	_host_nvm.statistics.elapsed_ns +=
+			(uint64_t)length * EEPROM_HOST_NVM_BYTE_ACCESS_NS;
+}
+
+/**
+ * \brief Advances the modeled time of the NVM controller.
+ *
+ * Models time spent by the application on other work, during which the NVM
+ * operation in progress, if any, proceeds without stalling the application.
+ *
+ * \param[in] ns  Modeled time elapsed, in nanoseconds
+ */
+void eeprom_host_nvm_advance(
+		const uint32_t ns)
+{
+	_host_nvm.busy_ns = (_host_nvm.busy_ns > ns) ? (_host_nvm.busy_ns - ns) : 0;
+}
+
+/**
+ * \brief Retrieves the operation counters of the modeled NVM controller.
+ *
+ * \param[out] statistics  Statistics structure to fill
+ */
+void eeprom_host_nvm_get_statistics(
+		struct eeprom_host_nvm_statistics *const statistics)
+{
+	*statistics = _host_nvm.statistics;
+}
+
+/**
+ * \brief Clears the operation counters of the modeled NVM controller.
+ *
+ * \note Row erase counters are not cleared, as they represent the wear of the
+ *       modeled memory.
+ */
+void eeprom_host_nvm_clear_statistics(void)
+{
+	memset(&_host_nvm.statistics, 0, sizeof(_host_nvm.statistics));
+}
+
+/**
+ * \brief Retrieves the number of times a row of the EEPROM section was erased.
+ *
+ * \param[in] row  Row index, relative to the start of the EEPROM section
+ *
+ * \return Number of erases of the row since \ref eeprom_host_nvm_init().
+ */
+uint32_t eeprom_host_nvm_get_row_erase_count(
+		const uint16_t row)
+{
+	if (row >= (_host_nvm.eeprom_pages / NVMCTRL_ROW_PAGES)) {
+		return 0;
+	}
+
+	return _host_nvm.row_erase_count[row];
+}
+
+/**
+ * \brief Schedules a power cut of the modeled device.
+ *
+ * The power is cut during a later page program or row erase operation,
+ * counted from zero for the next one. Only the first \p torn_bytes bytes of
+ * an interrupted page program are programmed, and only the first
+ * \p torn_bytes bytes of each page of an interrupted row erase are erased,
+ * so that zero models a power loss just before the operation. The handler is
+ * then called; if it returns, the modeled memory ignores any further program
+ * and erase commands until \ref eeprom_host_nvm_clear_power_cut() is called.
+ *
+ * \param[in] operation   Index of the operation interrupted by the power cut
+ * \param[in] torn_bytes  Number of bytes of the operation that take effect
+ * \param[in] handler     Handler called once the power is cut, or \c NULL
+ */
+void eeprom_host_nvm_set_power_cut(
+		const uint32_t operation,
+		const uint8_t torn_bytes,
+		const eeprom_host_nvm_power_cut_handler_t handler)
+{
+	_host_nvm.power_cut_armed      = true;
+	_host_nvm.power_off            = false;
+	_host_nvm.power_cut_operations = operation;
+	_host_nvm.power_cut_torn_bytes = (torn_bytes > NVMCTRL_PAGE_SIZE) ?
+			NVMCTRL_PAGE_SIZE : torn_bytes;
+	_host_nvm.power_cut_handler    = handler;
+}
+
+/**
+ * \brief Restores the power of the modeled device.
+ *
+ * Cancels any pending power cut, and restores the power after one.
+ */
+void eeprom_host_nvm_clear_power_cut(void)
+{
+	_host_nvm.power_cut_armed = false;
+	_host_nvm.power_off       = false;
+	memset(_host_nvm.page_buffer, 0xFF, NVMCTRL_PAGE_SIZE);
+}
+
+/**
+ * \brief Copies the contents of the modeled EEPROM section.
+ *
+ * \param[out] data  Buffer to fill, of the EEPROM section size set by
+ *                   \ref eeprom_host_nvm_init()
+ */
+void eeprom_host_nvm_get_memory(
+		uint8_t *const data)
+{
+	memcpy(data, _host_nvm.memory,
+			(size_t)_host_nvm.eeprom_pages * NVMCTRL_PAGE_SIZE);
+}
+
+/**
+ * \brief Replaces the contents of the modeled EEPROM section.
+ *
+ * Models a device whose memory was saved by
+ * \ref eeprom_host_nvm_get_memory(), with no NVM operation in progress. The
+ * statistics and row erase counters are left unchanged.
+ *
+ * \param[in] data  New contents of the EEPROM section
+ */
+void eeprom_host_nvm_set_memory(
+		const uint8_t *const data)
+{
+	memcpy(_host_nvm.memory, data,
+			(size_t)_host_nvm.eeprom_pages * NVMCTRL_PAGE_SIZE);
+	memset(_host_nvm.page_buffer, 0xFF, NVMCTRL_PAGE_SIZE);
+	_host_nvm.busy_ns = 0;
+}
+
+bool nvm_is_ready(void)
+{
+	return (_host_nvm.busy_ns == 0);
+}
+
+enum status_code nvm_set_config(
+		const struct nvm_config *const config)
+{
+	(void)config;
+
+	return STATUS_OK;
+}
+
+void nvm_get_parameters(
+		struct nvm_parameters *const parameters)
+{
+	parameters->page_size                  = NVMCTRL_PAGE_SIZE;
+	parameters->nvm_number_of_pages        = FLASH_SIZE / NVMCTRL_PAGE_SIZE;
+	parameters->eeprom_number_of_pages     = _host_nvm.eeprom_pages;
+	parameters->bootloader_number_of_pages = 0;
+}
+
+enum status_code nvm_write_buffer(
+		const uint32_t destination_address,
+		const uint8_t *buffer,
+		uint16_t length)
+{
+	uint32_t offset;
+
+	/* Writes must start on a page boundary and fit in the page buffer */
+	if (destination_address & (NVMCTRL_PAGE_SIZE - 1)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	if (length > NVMCTRL_PAGE_SIZE) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	if (_eeprom_host_nvm_offset(destination_address, length, &offset) == false) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	_eeprom_host_nvm_wait();
+
+	/* The driver clears the page buffer before loading the new data */
+	memset(_host_nvm.page_buffer, 0xFF, NVMCTRL_PAGE_SIZE);
+	memcpy(_host_nvm.page_buffer, buffer, length);
+
+	_host_nvm.statistics.page_fills++;
+	_host_nvm.statistics.elapsed_ns +=
+			(uint64_t)length * EEPROM_HOST_NVM_BYTE_ACCESS_NS;
+
+	return STATUS_OK;
+}
+
+enum status_code nvm_read_buffer(
+		const uint32_t source_address,
+		uint8_t *const buffer,
+		uint16_t length)
+{
+	uint32_t offset;
+
+	if (length > NVMCTRL_PAGE_SIZE) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	if (_eeprom_host_nvm_offset(source_address, length, &offset) == false) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	_eeprom_host_nvm_wait();
+
+	memcpy(buffer, &_host_nvm.memory[offset], length);
+
+	_host_nvm.statistics.page_reads++;
+	_host_nvm.statistics.elapsed_ns +=
+			(uint64_t)length * EEPROM_HOST_NVM_BYTE_ACCESS_NS;
+
+	return STATUS_OK;
+}
+
+enum status_code nvm_erase_row(
+		const uint32_t row_address)
+{
+	uint32_t offset;
+	uint32_t row_size = NVMCTRL_PAGE_SIZE * NVMCTRL_ROW_PAGES;
+
+	/* Erases must start on a row boundary */
+	if (row_address & (row_size - 1)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	if (_eeprom_host_nvm_offset(row_address, row_size, &offset) == false) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+
+	_eeprom_host_nvm_wait();
+
+	/* Commands issued while the power is off are lost */
+	if (_host_nvm.power_off == true) {
+		return STATUS_OK;
+	}
+
+	if (_eeprom_host_nvm_power_fails() == true) {
+		/* An interrupted erase leaves the end of each page programmed */
+		for (uint8_t c = 0; c < NVMCTRL_ROW_PAGES; c++) {
+			memset(&_host_nvm.memory[offset + (c * NVMCTRL_PAGE_SIZE)], 0xFF,
+					_host_nvm.power_cut_torn_bytes);
+		}
+
+		_eeprom_host_nvm_power_cut(NVM_COMMAND_ERASE_ROW);
+		return STATUS_OK;
+	}
+
+	memset(&_host_nvm.memory[offset], 0xFF, row_size);
+
+	_host_nvm.row_erase_count[offset / row_size]++;
+	_host_nvm.statistics.row_erases++;
+	_host_nvm.statistics.elapsed_ns += EEPROM_HOST_NVM_ROW_ERASE_NS;
+	_host_nvm.busy_ns = EEPROM_HOST_NVM_ROW_ERASE_NS;
+
+	return STATUS_OK;
+}
+
+enum status_code nvm_execute_command(
+		const enum nvm_command command,
+		const uint32_t address,
+		const uint32_t parameter)
+{
+	uint32_t offset;
+
+	(void)parameter;
+
+	switch (command) {
+		case NVM_COMMAND_ERASE_ROW:
+			return nvm_erase_row(address);
+
+		case NVM_COMMAND_PAGE_BUFFER_CLEAR:
+			memset(_host_nvm.page_buffer, 0xFF, NVMCTRL_PAGE_SIZE);
+			return STATUS_OK;
+
+		case NVM_COMMAND_WRITE_PAGE:
+			if (_eeprom_host_nvm_offset(address, 1, &offset) == false) {
+				return STATUS_ERR_BAD_ADDRESS;
+			}
+
+			offset &= ~(uint32_t)(NVMCTRL_PAGE_SIZE - 1);
+
+			_eeprom_host_nvm_wait();
+
+			if (_host_nvm.power_off == true) {
+				memset(_host_nvm.page_buffer, 0xFF, NVMCTRL_PAGE_SIZE);
+				return STATUS_OK;
+			}
+
+			if (_eeprom_host_nvm_power_fails() == true) {
+				/* An interrupted program only reaches the start of the page */
+				for (uint8_t c = 0; c < _host_nvm.power_cut_torn_bytes; c++) {
+					_host_nvm.memory[offset + c] &= _host_nvm.page_buffer[c];
+				}
+
+				memset(_host_nvm.page_buffer, 0xFF, NVMCTRL_PAGE_SIZE);
+				_eeprom_host_nvm_power_cut(NVM_COMMAND_WRITE_PAGE);
+				return STATUS_OK;
+			}
+
+			/* Programming can only clear bits; any attempt to set a cleared
+			 * bit is recorded, and has no effect on the memory contents */
+			for (uint8_t c = 0; c < NVMCTRL_PAGE_SIZE; c++) {
+				uint8_t current = _host_nvm.memory[offset + c];
+
+				if (_host_nvm.page_buffer[c] & ~current) {
+					_host_nvm.statistics.program_violations++;
+				}
+
+				_host_nvm.memory[offset + c] =
+						current & _host_nvm.page_buffer[c];
+			}
+
+			/* The page buffer is reset by the controller after a write */
+			memset(_host_nvm.page_buffer, 0xFF, NVMCTRL_PAGE_SIZE);
+
+			_host_nvm.statistics.page_writes++;
+			_host_nvm.statistics.elapsed_ns += EEPROM_HOST_NVM_PAGE_WRITE_NS;
+			_host_nvm.busy_ns = EEPROM_HOST_NVM_PAGE_WRITE_NS;
+			return STATUS_OK;
+
+		default:
+			return STATUS_ERR_INVALID_ARG;
+	}
+}
@@ -0,0 +1,296 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator host NVM backend
+ *
+ * RAM-backed model of the SAM NVM controller, used to build and exercise the
+ * EEPROM emulator (eeprom.c) on a development host instead of a SAM device.
+ *
+ * The backend is selected by defining \c EEPROM_EMULATOR_HOST_NVM when building
+ * eeprom.c; it replaces the ASF <tt>compiler.h</tt>, <tt>status_codes.h</tt> and
+ * NVM driver dependencies of the emulator with the minimal subset declared in
+ * this header, implemented against a RAM array in eeprom_host_nvm.c:
+ *
+ * \code
+	gcc -DEEPROM_EMULATOR_HOST_NVM -I. eeprom.c eeprom_host_nvm.c my_app.c
+ * \endcode
+ *
+ * The host Makefile builds the benchmarks of eeprom_host_bench.c this way.
+ *
+ * The model enforces FLASH semantics; programming a page can only clear bits
+ * (1 to 0), and the smallest erase granularity is one row. Every NVM operation
+ * is counted, and a modeled wall time based on the SAM D21 datasheet timings is
+ * accumulated, so that the cost of emulator changes can be measured before
+ * they are deployed to a device.
+ *
+ * As on the device, the controller stays busy after a page write or row erase
+ * command until the modeled operation time has passed, which the application
+ * models with \ref eeprom_host_nvm_advance(). Any FLASH access made meanwhile
+ * waits for the operation to complete, and the waiting time is accounted
+ * separately.
+ *
+ * Power losses may be injected with \ref eeprom_host_nvm_set_power_cut(), to
+ * check how the emulator recovers from a reset at any point of its program
+ * and erase operations; see eeprom_host_fault.h.
+ */
+#ifndef EEPROM_HOST_NVM_H_INCLUDED
+#define EEPROM_HOST_NVM_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \name Compiler Support
+ * @{
+ */
+
+#define COMPILER_PRAGMA(arg)            _Pragma(#arg)
+#define COMPILER_PACK_SET(alignment)    COMPILER_PRAGMA(pack(alignment))
+#define COMPILER_PACK_RESET()           COMPILER_PRAGMA(pack())
+#define barrier()                       __asm__ __volatile__ ("" ::: "memory")
+
+/** @} */
+
+/** \name Status Codes
+ * @{
+ */
+
+/** Subset of the ASF status codes used by the EEPROM emulator. */
+enum status_code {
+	STATUS_OK                      = 0x00,
+	STATUS_VALID_DATA              = 0x01,
+	STATUS_NO_CHANGE               = 0x02,
+	STATUS_ABORTED                 = 0x04,
+	STATUS_BUSY                    = 0x05,
+	STATUS_SUSPEND                 = 0x06,
+	STATUS_ERR_IO                  = 0x10,
+	STATUS_ERR_REQ_FLUSHED         = 0x11,
+	STATUS_ERR_TIMEOUT             = 0x12,
+	STATUS_ERR_BAD_DATA            = 0x13,
+	STATUS_ERR_NOT_FOUND           = 0x14,
+	STATUS_ERR_UNSUPPORTED_DEV     = 0x15,
+	STATUS_ERR_NO_MEMORY           = 0x16,
+	STATUS_ERR_INVALID_ARG         = 0x17,
+	STATUS_ERR_BAD_ADDRESS         = 0x18,
+	STATUS_ERR_BAD_FORMAT          = 0x1A,
+	STATUS_ERR_BAD_FRQ             = 0x1B,
+	STATUS_ERR_DENIED              = 0x1C,
+	STATUS_ERR_ALREADY_INITIALIZED = 0x1D,
+	STATUS_ERR_OVERFLOW            = 0x1E,
+	STATUS_ERR_NOT_INITIALIZED     = 0x1F,
+};
+
+/** @} */
+
+/** \name Modeled Device Geometry
+ * @{
+ */
+
+/** Size of a single physical FLASH page, in bytes. */
+#define NVMCTRL_PAGE_SIZE               64
+
+/** Number of physical FLASH pages in each erasable row. */
+#define NVMCTRL_ROW_PAGES               4
+
+/** Total size of the modeled FLASH, in bytes (SAM D21J18A). */
+#ifndef EEPROM_HOST_NVM_FLASH_SIZE
+#  define EEPROM_HOST_NVM_FLASH_SIZE    (256UL * 1024UL)
+#endif
+
+#define FLASH_SIZE                      EEPROM_HOST_NVM_FLASH_SIZE
+
+/** Largest EEPROM section selectable through the device fuses, in pages. It
+ *  may be raised to model the larger sections allowed by
+ *  \c EEPROM_WIDE_PAGE_INDEX. */
+#ifndef EEPROM_HOST_NVM_MAX_PAGES
+#  define EEPROM_HOST_NVM_MAX_PAGES     (64 * NVMCTRL_ROW_PAGES)
+#endif
+
+/** @} */
+
+/** \name Modeled Operation Timings
+ *
+ * Default values are the SAM D21 datasheet maximum page programming and row
+ * erase times; bus accesses are modeled at 48MHz with one wait state.
+ * @{
+ */
+
+#ifndef EEPROM_HOST_NVM_PAGE_WRITE_NS
+#  define EEPROM_HOST_NVM_PAGE_WRITE_NS 2500000UL
+#endif
+
+#ifndef EEPROM_HOST_NVM_ROW_ERASE_NS
+#  define EEPROM_HOST_NVM_ROW_ERASE_NS  6000000UL
+#endif
+
+#ifndef EEPROM_HOST_NVM_BYTE_ACCESS_NS
+#  define EEPROM_HOST_NVM_BYTE_ACCESS_NS 42UL
+#endif
+
+/** @} */
+
+/** \name NVM Driver Subset
+ * @{
+ */
+
+/** NVM controller commands supported by the model. */
+enum nvm_command {
+	/** Erase the addressed row. */
+	NVM_COMMAND_ERASE_ROW,
+	/** Program the page buffer into the addressed page. */
+	NVM_COMMAND_WRITE_PAGE,
+	/** Reset all bytes of the page buffer to 0xFF. */
+	NVM_COMMAND_PAGE_BUFFER_CLEAR,
+};
+
+/** NVM controller configuration structure. */
+struct nvm_config {
+	/** Manual write mode; page writes need an explicit write command. */
+	bool manual_page_write;
+};
+
+/** NVM memory parameter structure. */
+struct nvm_parameters {
+	/** Number of bytes per page. */
+	uint8_t  page_size;
+	/** Number of pages in the main array. */
+	uint16_t nvm_number_of_pages;
+	/** Size of the emulated EEPROM memory section configured in the fuses. */
+	uint32_t eeprom_number_of_pages;
+	/** Size of the bootloader memory section configured in the fuses. */
+	uint32_t bootloader_number_of_pages;
+};
+
+static inline void nvm_get_config_defaults(
+		struct nvm_config *const config)
+{
+	config->manual_page_write = true;
+}
+
+enum status_code nvm_set_config(
+		const struct nvm_config *const config);
+
+void nvm_get_parameters(
+		struct nvm_parameters *const parameters);
+
+enum status_code nvm_write_buffer(
+		const uint32_t destination_address,
+		const uint8_t *buffer,
+		uint16_t length);
+
+enum status_code nvm_read_buffer(
+		const uint32_t source_address,
+		uint8_t *const buffer,
+		uint16_t length);
+
+enum status_code nvm_erase_row(
+		const uint32_t row_address);
+
+enum status_code nvm_execute_command(
+		const enum nvm_command command,
+		const uint32_t address,
+		const uint32_t parameter);
+
+bool nvm_is_ready(void);
+
+/** @} */
+
+/** \name Emulator Hooks
+ * @{
+ */
+
+/** Translates an NVM address into a pointer to the modeled memory. */
+#define EEPROM_NVM_POINTER(address) \
+		eeprom_host_nvm_pointer(address)
+
+/** Accounts a direct memory-mapped read performed by the emulator. */
+#define EEPROM_NVM_TRACE_READ(address, length) \
+		eeprom_host_nvm_trace_read(address, length)
+
+/** @} */
+
+/** \name Model Control and Statistics
+ * @{
+ */
+
+/**
+ * \brief Host NVM model power cut handler.
+ *
+ * Called when the modeled power is cut, with the command interrupted by the
+ * power loss. The handler would usually not return, and instead jump back to
+ * the code simulating the reset of the device.
+ */
+typedef void (*eeprom_host_nvm_power_cut_handler_t)(
+		const enum nvm_command command);
+
+/**
+ * \brief Host NVM model statistics.
+ *
+ * Counters of the operations performed on the modeled NVM controller since the
+ * last call to \ref eeprom_host_nvm_clear_statistics().
+ */
+struct eeprom_host_nvm_statistics {
+	/** Number of page buffer fills. */
+	uint32_t page_fills;
+	/** Number of page buffer commits (page programming operations). */
+	uint32_t page_writes;
+	/** Number of row erases. */
+	uint32_t row_erases;
+	/** Number of whole page reads through the NVM driver. */
+	uint32_t page_reads;
+	/** Number of direct memory-mapped reads made by the emulator. */
+	uint32_t direct_reads;
+	/** Number of programmed bytes that tried to set a cleared bit. */
+	uint32_t program_violations;
+	/** Modeled time spent in the NVM controller, in nanoseconds. */
+	uint64_t elapsed_ns;
+	/** Modeled time spent waiting for the NVM controller to become ready, in
+	 *  nanoseconds. */
+	uint64_t stall_ns;
+};
+
+void eeprom_host_nvm_init(
+		const uint16_t eeprom_pages);
+
+const void *eeprom_host_nvm_pointer(
+		const uint32_t address);
+
+void eeprom_host_nvm_trace_read(
+		const uint32_t address,
+		const uint16_t length);
+
+void eeprom_host_nvm_advance(
+		const uint32_t ns);
+
+void eeprom_host_nvm_get_statistics(
+		struct eeprom_host_nvm_statistics *const statistics);
+
+void eeprom_host_nvm_clear_statistics(void);
+
+uint32_t eeprom_host_nvm_get_row_erase_count(
+		const uint16_t row);
+
+void eeprom_host_nvm_set_power_cut(
+		const uint32_t operation,
+		const uint8_t torn_bytes,
+		const eeprom_host_nvm_power_cut_handler_t handler);
+
+void eeprom_host_nvm_clear_power_cut(void);
+
+void eeprom_host_nvm_get_memory(
+		uint8_t *const data);
+
+void eeprom_host_nvm_set_memory(
+		const uint8_t *const data);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_HOST_NVM_H_INCLUDED */
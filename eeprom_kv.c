@@ -0,0 +1,1037 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator key-value record store
+ *
+ * Log-structured record store on the emulated EEPROM; see eeprom_kv.h.
+ */
+#include "eeprom_kv.h"
+#include <string.h>
+
+/**
+ * \internal
+ * \name Internal Key-Value Store Format
+ * @{
+ */
+
+/** Size of the header at the start of each area, in bytes. */
+#define EEPROM_KV_AREA_HEADER_SIZE   4
+
+/** First bytes of a valid area header. */
+#define EEPROM_KV_AREA_MAGIC_0       'K'
+#define EEPROM_KV_AREA_MAGIC_1       'V'
+
+/** Size of the header of each record, in bytes. */
+#define EEPROM_KV_RECORD_HEADER_SIZE 4
+
+/** Value of the bytes following the log in an area. */
+#define EEPROM_KV_ERASED             0xFF
+
+/** Value length marking a deleted key. */
+#define EEPROM_KV_TOMBSTONE          0xFF
+
+/** Index offset of an unused entry. */
+#define EEPROM_KV_INDEX_EMPTY        0xFFFF
+
+/** Maximum number of keys held by the index. */
+#define EEPROM_KV_MAX_RECORDS \
+		(EEPROM_KV_INDEX_ENTRIES - (EEPROM_KV_INDEX_ENTRIES / 4))
+
+/** Size of the buffer used to process record contents in chunks. */
+#define EEPROM_KV_CHUNK_SIZE         32
+
+/** @} */
+
+/**
+ * \internal
+ * \brief Header of a record in the log.
+ */
+struct _eeprom_kv_record_header {
+	/** Length of the key, or \ref EEPROM_KV_ERASED after the log. */
+	uint8_t key_length;
+	/** Length of the value, or \ref EEPROM_KV_TOMBSTONE. */
+	uint8_t value_length;
+	/** CRC-16 of the lengths, key and value, least significant byte first. */
+	uint8_t crc[2];
+};
+
+/**
+ * \internal
+ * \brief Entry of the SRAM index, locating the newest record of a key.
+ */
+struct _eeprom_kv_index_entry {
+	/** Offset of the record in emulated EEPROM memory space, or
+	 *  \ref EEPROM_KV_INDEX_EMPTY. */
+	uint16_t offset;
+	/** Upper bits of the hash of the key, to skip most mismatching records
+	 *  without reading them. */
+	uint8_t tag;
+};
+
+/**
+ * \internal
+ * \brief Internal key-value store instance struct.
+ */
+struct _eeprom_kv_module {
+	/** Initialization state of the store. */
+	bool initialized;
+	/** Offset of the first area in emulated EEPROM memory space. */
+	uint16_t region_offset;
+	/** Size of each area, including its header, in bytes. */
+	uint16_t area_size;
+	/** Index of the active area. */
+	uint8_t area;
+	/** Generation number of the active area. */
+	uint8_t generation;
+	/** Offset at which the next record is appended. */
+	uint16_t end;
+	/** Number of keys stored. */
+	uint16_t records;
+	/** Size of the newest records of the stored keys, in bytes. */
+	uint16_t used_bytes;
+	/** Index of the newest record of each key, with linear probing. */
+	struct _eeprom_kv_index_entry index[EEPROM_KV_INDEX_ENTRIES];
+};
+
+/**
+ * \internal
+ * \brief Internal key-value store instance.
+ */
+static struct _eeprom_kv_module _eeprom_kv;
+
+/** \internal
+ *  \brief Computes the hash of a key.
+ *
+ *  \param[in] key         Key to hash
+ *  \param[in] key_length  Length of the key, in bytes
+ *
+ *  \return 32-bit FNV-1a hash of the key length and key.
+ */
+static uint32_t _eeprom_kv_hash(
+		const uint8_t *const key,
+		const uint8_t key_length)
+{
+	uint32_t hash = (2166136261UL ^ key_length) * 16777619UL;
+
+	for (uint8_t c = 0; c < key_length; c++) {
+		hash = (hash ^ key[c]) * 16777619UL;
+	}
+
+	return hash;
+}
+
+/** \internal
+ *  \brief Gives the offset of the first byte after an area.
+ *
+ *  \param[in] area  Index of the area
+ */
+static inline uint16_t _eeprom_kv_area_end(
+		const uint8_t area)
+{
+	return _eeprom_kv.region_offset + ((area + 1) * _eeprom_kv.area_size);
+}
+
+/** \internal
+ *  \brief Gives the total size of a record, in bytes.
+ *
+ *  \param[in] header  Header of the record
+ */
+static inline uint16_t _eeprom_kv_record_size(
+		const struct _eeprom_kv_record_header *const header)
+{
+	uint16_t size = EEPROM_KV_RECORD_HEADER_SIZE + header->key_length;
+
+	if (header->value_length != EEPROM_KV_TOMBSTONE) {
+		size += header->value_length;
+	}
+
+	return size;
+}
+
+/** \internal
+ *  \brief Reads the header of a record and checks its CRC.
+ *
+ *  The header is valid if its lengths are in range, the record lies in the
+ *  active area, and the CRC matches its contents; the contents are read from
+ *  emulated EEPROM in chunks.
+ *
+ *  \param[in]  offset  Offset of the record in emulated EEPROM memory space
+ *  \param[out] header  Header of the record
+ *
+ *  \return Whether a valid record was found at the given offset.
+ */
+static bool _eeprom_kv_check_record(
+		const uint16_t offset,
+		struct _eeprom_kv_record_header *const header)
+{
+	uint8_t buffer[EEPROM_KV_CHUNK_SIZE];
+	uint16_t area_end = _eeprom_kv_area_end(_eeprom_kv.area);
+	uint16_t crc;
+
+	if (offset + EEPROM_KV_RECORD_HEADER_SIZE > area_end) {
+		return false;
+	}
+
+	if (eeprom_emulator_read_buffer(offset, (uint8_t *)header,
+			EEPROM_KV_RECORD_HEADER_SIZE) != STATUS_OK) {
+		return false;
+	}
+
+	if ((header->key_length == 0) ||
+			(header->key_length > EEPROM_KV_MAX_KEY_SIZE)) {
+		return false;
+	}
+
+	uint16_t size = _eeprom_kv_record_size(header);
+
+	if (offset + size > area_end) {
+		return false;
+	}
+
+	crc = eeprom_emulator_crc16(0xFFFF, (const uint8_t *)header, 2);
+
+	for (uint16_t c = EEPROM_KV_RECORD_HEADER_SIZE; c < size;
+			c += EEPROM_KV_CHUNK_SIZE) {
+		uint16_t length = size - c;
+
+		if (length > EEPROM_KV_CHUNK_SIZE) {
+			length = EEPROM_KV_CHUNK_SIZE;
+		}
+
+		if (eeprom_emulator_read_buffer(offset + c, buffer, length) !=
+				STATUS_OK) {
+			return false;
+		}
+
+		crc = eeprom_emulator_crc16(crc, buffer, length);
+	}
+
+	return (header->crc[0] == (uint8_t)crc) &&
+			(header->crc[1] == (uint8_t)(crc >> 8));
+}
+
+/** \internal
+ *  \brief Reads the key of an indexed record.
+ *
+ *  \param[in]  offset  Offset of the record in emulated EEPROM memory space
+ *  \param[out] key     Key of the record
+ *
+ *  \return Length of the key, in bytes.
+ */
+static uint8_t _eeprom_kv_read_key(
+		const uint16_t offset,
+		uint8_t *const key)
+{
+	struct _eeprom_kv_record_header header;
+
+	eeprom_emulator_read_buffer(offset, (uint8_t *)&header,
+			EEPROM_KV_RECORD_HEADER_SIZE);
+	eeprom_emulator_read_buffer(offset + EEPROM_KV_RECORD_HEADER_SIZE, key,
+			header.key_length);
+
+	return header.key_length;
+}
+
+/** \internal
+ *  \brief Looks up a key in the index.
+ *
+ *  Probes the index from the home entry of the key, reading the key of each
+ *  record whose tag matches until the key is found or an unused entry is
+ *  reached.
+ *
+ *  \param[in]  key         Key to look up
+ *  \param[in]  key_length  Length of the key, in bytes
+ *  \param[out] slot        Index entry of the key if found, otherwise the
+ *                          unused entry where it would be inserted
+ *
+ *  \return Whether the key was found.
+ */
+static bool _eeprom_kv_find(
+		const uint8_t *const key,
+		const uint8_t key_length,
+		uint16_t *const slot)
+{
+	uint8_t record[EEPROM_KV_RECORD_HEADER_SIZE + EEPROM_KV_MAX_KEY_SIZE];
+	uint32_t hash = _eeprom_kv_hash(key, key_length);
+	uint8_t tag   = (uint8_t)(hash >> 24);
+	uint16_t c    = hash & (EEPROM_KV_INDEX_ENTRIES - 1);
+
+	while (_eeprom_kv.index[c].offset != EEPROM_KV_INDEX_EMPTY) {
+		if (_eeprom_kv.index[c].tag == tag) {
+			if ((eeprom_emulator_read_buffer(_eeprom_kv.index[c].offset,
+					record, EEPROM_KV_RECORD_HEADER_SIZE + key_length) ==
+							STATUS_OK) &&
+					(record[0] == key_length) &&
+					(memcmp(&record[EEPROM_KV_RECORD_HEADER_SIZE], key,
+							key_length) == 0)) {
+				*slot = c;
+				return true;
+			}
+		}
+
+		c = (c + 1) & (EEPROM_KV_INDEX_ENTRIES - 1);
+	}
+
+	*slot = c;
+	return false;
+}
+
+/** \internal
+ *  \brief Removes an entry from the index.
+ *
+ *  Entries following the removed one in the same probe sequence are shifted
+ *  back, so that lookups need no deleted entry markers.
+ *
+ *  \param[in] slot  Index entry to remove
+ */
+static void _eeprom_kv_index_remove(
+		uint16_t slot)
+{
+	uint16_t c = slot;
+
+	for (;;) {
+		c = (c + 1) & (EEPROM_KV_INDEX_ENTRIES - 1);
+
+		if (_eeprom_kv.index[c].offset == EEPROM_KV_INDEX_EMPTY) {
+			break;
+		}
+
+		uint8_t key[EEPROM_KV_MAX_KEY_SIZE];
+		uint8_t key_length = _eeprom_kv_read_key(_eeprom_kv.index[c].offset,
+				key);
+		uint16_t home = _eeprom_kv_hash(key, key_length) &
+				(EEPROM_KV_INDEX_ENTRIES - 1);
+
+		/* Move the entry back unless its home entry lies cyclically
+		 * between the removed entry and its current place */
+		if (((c - home) & (EEPROM_KV_INDEX_ENTRIES - 1)) >=
+				((c - slot) & (EEPROM_KV_INDEX_ENTRIES - 1))) {
+			_eeprom_kv.index[slot] = _eeprom_kv.index[c];
+			slot = c;
+		}
+	}
+
+	_eeprom_kv.index[slot].offset = EEPROM_KV_INDEX_EMPTY;
+}
+
+/** \internal
+ *  \brief Appends a record to the log of the active area.
+ *
+ *  \param[in] key           Key of the record
+ *  \param[in] key_length    Length of the key, in bytes
+ *  \param[in] value         Value of the record, unused for a tombstone
+ *  \param[in] value_length  Length of the value, or \ref EEPROM_KV_TOMBSTONE
+ *
+ *  \return Status code of the emulated EEPROM write.
+ */
+static enum status_code _eeprom_kv_append(
+		const uint8_t *const key,
+		const uint8_t key_length,
+		const uint8_t *const value,
+		const uint8_t value_length)
+{
+	enum status_code error_code;
+	uint8_t record[EEPROM_KV_RECORD_HEADER_SIZE + EEPROM_KV_MAX_KEY_SIZE];
+	struct _eeprom_kv_record_header *header =
+			(struct _eeprom_kv_record_header *)record;
+	uint16_t offset = _eeprom_kv.end;
+	uint16_t crc;
+
+	header->key_length   = key_length;
+	header->value_length = value_length;
+	memcpy(&record[EEPROM_KV_RECORD_HEADER_SIZE], key, key_length);
+
+	crc = eeprom_emulator_crc16(0xFFFF, record, 2);
+	crc = eeprom_emulator_crc16(crc, key, key_length);
+
+	if (value_length != EEPROM_KV_TOMBSTONE) {
+		crc = eeprom_emulator_crc16(crc, value, value_length);
+	}
+
+	header->crc[0] = (uint8_t)crc;
+	header->crc[1] = (uint8_t)(crc >> 8);
+
+	error_code = eeprom_emulator_write_buffer(offset, record,
+			EEPROM_KV_RECORD_HEADER_SIZE + key_length);
+	offset += EEPROM_KV_RECORD_HEADER_SIZE + key_length;
+
+	if ((error_code == STATUS_OK) && (value_length != EEPROM_KV_TOMBSTONE) &&
+			(value_length > 0)) {
+		error_code = eeprom_emulator_write_buffer(offset, value, value_length);
+		offset += value_length;
+	}
+
+	if (error_code == STATUS_OK) {
+		_eeprom_kv.end = offset;
+	}
+
+	return error_code;
+}
+
+/** \internal
+ *  \brief Erases the end of an area.
+ *
+ *  Sets the bytes from the given offset to the end of the area to
+ *  \ref EEPROM_KV_ERASED, so that no stale record is found after the log;
+ *  emulated EEPROM pages that are already erased are left unwritten.
+ *
+ *  \param[in] offset  Offset of the first byte to erase
+ *  \param[in] area    Index of the area
+ *
+ *  \return Status code of the emulated EEPROM writes.
+ */
+static enum status_code _eeprom_kv_erase(
+		uint16_t offset,
+		const uint8_t area)
+{
+	enum status_code error_code = STATUS_OK;
+	uint8_t buffer[EEPROM_KV_CHUNK_SIZE];
+	uint16_t area_end = _eeprom_kv_area_end(area);
+
+	memset(buffer, EEPROM_KV_ERASED, sizeof(buffer));
+
+	while ((error_code == STATUS_OK) && (offset < area_end)) {
+		uint16_t length = area_end - offset;
+
+		if (length > EEPROM_KV_CHUNK_SIZE) {
+			length = EEPROM_KV_CHUNK_SIZE;
+		}
+
+		error_code = eeprom_emulator_write_buffer(offset, buffer, length);
+		offset += length;
+	}
+
+	return error_code;
+}
+
+/** \internal
+ *  \brief Reads the header of an area.
+ *
+ *  \param[in]  area        Index of the area
+ *  \param[out] generation  Generation number of the area
+ *
+ *  \return Whether the area holds a valid header.
+ */
+static bool _eeprom_kv_read_area_header(
+		const uint8_t area,
+		uint8_t *const generation)
+{
+	uint8_t header[EEPROM_KV_AREA_HEADER_SIZE];
+
+	if (eeprom_emulator_read_buffer(
+			_eeprom_kv.region_offset + (area * _eeprom_kv.area_size),
+			header, EEPROM_KV_AREA_HEADER_SIZE) != STATUS_OK) {
+		return false;
+	}
+
+	*generation = header[2];
+
+	return (header[0] == EEPROM_KV_AREA_MAGIC_0) &&
+			(header[1] == EEPROM_KV_AREA_MAGIC_1) &&
+			((uint8_t)(header[2] ^ header[3]) == 0xFF);
+}
+
+/** \internal
+ *  \brief Writes the header of an area.
+ *
+ *  \param[in] area        Index of the area
+ *  \param[in] generation  Generation number of the area
+ *
+ *  \return Status code of the emulated EEPROM write.
+ */
+static enum status_code _eeprom_kv_write_area_header(
+		const uint8_t area,
+		const uint8_t generation)
+{
+	uint8_t header[EEPROM_KV_AREA_HEADER_SIZE] = {
+		EEPROM_KV_AREA_MAGIC_0, EEPROM_KV_AREA_MAGIC_1,
+		generation, (uint8_t)~generation,
+	};
+
+	return eeprom_emulator_write_buffer(
+			_eeprom_kv.region_offset + (area * _eeprom_kv.area_size),
+			header, EEPROM_KV_AREA_HEADER_SIZE);
+}
+
+/** \internal
+ *  \brief Copies the live records to the inactive area and activates it.
+ *
+ *  Records are copied in index order, and the index is updated to their new
+ *  offsets; the rest of the area is erased. The copies are committed to
+ *  physical memory before the header of the new area is written, and that
+ *  header again before the function returns, so that the previous area stays
+ *  in use until the copy is complete. On failure the store must be
+ *  initialized again.
+ *
+ *  \return Status code of the emulated EEPROM accesses.
+ */
+static enum status_code _eeprom_kv_compact(void)
+{
+	enum status_code error_code = STATUS_OK;
+	uint8_t buffer[EEPROM_KV_CHUNK_SIZE];
+	uint8_t area = _eeprom_kv.area ^ 1;
+	uint16_t offset = _eeprom_kv.region_offset + (area * _eeprom_kv.area_size) +
+			EEPROM_KV_AREA_HEADER_SIZE;
+
+	for (uint16_t slot = 0; slot < EEPROM_KV_INDEX_ENTRIES; slot++) {
+		struct _eeprom_kv_record_header header;
+		uint16_t source = _eeprom_kv.index[slot].offset;
+
+		if (source == EEPROM_KV_INDEX_EMPTY) {
+			continue;
+		}
+
+		error_code = eeprom_emulator_read_buffer(source, (uint8_t *)&header,
+				EEPROM_KV_RECORD_HEADER_SIZE);
+
+		uint16_t size = _eeprom_kv_record_size(&header);
+
+		for (uint16_t c = 0; (error_code == STATUS_OK) && (c < size);
+				c += EEPROM_KV_CHUNK_SIZE) {
+			uint16_t length = size - c;
+
+			if (length > EEPROM_KV_CHUNK_SIZE) {
+				length = EEPROM_KV_CHUNK_SIZE;
+			}
+
+			error_code = eeprom_emulator_read_buffer(source + c, buffer, length);
+
+			if (error_code == STATUS_OK) {
+				error_code = eeprom_emulator_write_buffer(offset + c, buffer,
+						length);
+			}
+		}
+
+		if (error_code != STATUS_OK) {
+			_eeprom_kv.initialized = false;
+			return error_code;
+		}
+
+		_eeprom_kv.index[slot].offset = offset;
+		offset += size;
+	}
+
+	error_code = _eeprom_kv_erase(offset, area);
+
+	/* Make the copy durable before the new area takes over */
+	if (error_code == STATUS_OK) {
+		error_code = eeprom_emulator_commit_page_buffer();
+	}
+
+	if (error_code == STATUS_OK) {
+		error_code = _eeprom_kv_write_area_header(area,
+				_eeprom_kv.generation + 1);
+	}
+
+	if (error_code == STATUS_OK) {
+		error_code = eeprom_emulator_commit_page_buffer();
+	}
+
+	if (error_code != STATUS_OK) {
+		_eeprom_kv.initialized = false;
+		return error_code;
+	}
+
+	_eeprom_kv.area       = area;
+	_eeprom_kv.generation++;
+	_eeprom_kv.end        = offset;
+
+	return STATUS_OK;
+}
+
+/** \internal
+ *  \brief Makes room in the active area for a record.
+ *
+ *  Compacts the log if the record does not fit after its last record. The
+ *  previous record of its key is still copied, so that the key keeps its old
+ *  value should the append be interrupted.
+ *
+ *  \param[in] size  Size of the record to append, in bytes
+ *
+ *  \return Status code of the operation.
+ *
+ *  \retval STATUS_OK              If the record fits in the active area
+ *  \retval STATUS_ERR_NO_MEMORY   If the record would not fit after the live
+ *                                 records in an area
+ */
+static enum status_code _eeprom_kv_reserve(
+		const uint16_t size)
+{
+	if (_eeprom_kv.end + size <= _eeprom_kv_area_end(_eeprom_kv.area)) {
+		return STATUS_OK;
+	}
+
+	if (EEPROM_KV_AREA_HEADER_SIZE + _eeprom_kv.used_bytes + size >
+			_eeprom_kv.area_size) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	return _eeprom_kv_compact();
+}
+
+/** \internal
+ *  \brief Locates the region of the store in the emulated EEPROM.
+ *
+ *  \return Status code indicating the status of the operation.
+ *
+ *  \retval STATUS_OK                    If the region was located
+ *  \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not
+ *                                       initialized
+ *  \retval STATUS_ERR_NO_MEMORY         If the configured region does not fit
+ *                                       the emulated EEPROM
+ */
+static enum status_code _eeprom_kv_locate(void)
+{
+	enum status_code error_code;
+	struct eeprom_emulator_parameters parameters;
+	uint16_t pages = EEPROM_KV_PAGES;
+
+	_eeprom_kv.initialized = false;
+
+	error_code = eeprom_emulator_get_parameters(&parameters);
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	if (EEPROM_KV_FIRST_PAGE >= parameters.eeprom_number_of_pages) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	if (pages == 0) {
+		pages = parameters.eeprom_number_of_pages - EEPROM_KV_FIRST_PAGE;
+	}
+
+	if (EEPROM_KV_FIRST_PAGE + pages > parameters.eeprom_number_of_pages) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	_eeprom_kv.region_offset = EEPROM_KV_FIRST_PAGE * EEPROM_PAGE_SIZE;
+	_eeprom_kv.area_size     = (pages * EEPROM_PAGE_SIZE) / 2;
+
+	/* Each area must at least hold its header and one record */
+	if (_eeprom_kv.area_size < EEPROM_KV_AREA_HEADER_SIZE +
+			EEPROM_KV_RECORD_HEADER_SIZE + EEPROM_KV_MAX_KEY_SIZE) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Initializes the key-value store.
+ *
+ * Locates the active area of the store in the emulated EEPROM, and rebuilds
+ * the SRAM index by replaying its log. Any partial record left after the log
+ * by an interrupted write is erased. The EEPROM emulator must be initialized
+ * first; if no store is found, \ref eeprom_kv_format() should be called to
+ * create an empty one.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the store was initialized
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not
+ *                                      initialized
+ * \retval STATUS_ERR_NO_MEMORY         If the configured region does not fit
+ *                                      the emulated EEPROM, or the store holds
+ *                                      more keys than the index can
+ * \retval STATUS_ERR_BAD_FORMAT        If no store was found in the region
+ */
+enum status_code eeprom_kv_init(void)
+{
+	enum status_code error_code;
+	struct _eeprom_kv_record_header header;
+	uint8_t generation[2];
+	bool valid[2];
+	uint16_t offset;
+
+	error_code = _eeprom_kv_locate();
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	/* The active area is the one with the newest valid header */
+	valid[0] = _eeprom_kv_read_area_header(0, &generation[0]);
+	valid[1] = _eeprom_kv_read_area_header(1, &generation[1]);
+
+	if ((valid[0] == false) && (valid[1] == false)) {
+		return STATUS_ERR_BAD_FORMAT;
+	}
+
+	if (valid[0] && valid[1]) {
+		_eeprom_kv.area = ((int8_t)(generation[1] - generation[0]) > 0);
+	} else {
+		_eeprom_kv.area = valid[1];
+	}
+
+	_eeprom_kv.generation = generation[_eeprom_kv.area];
+	_eeprom_kv.records    = 0;
+	_eeprom_kv.used_bytes = 0;
+
+	for (uint16_t c = 0; c < EEPROM_KV_INDEX_ENTRIES; c++) {
+		_eeprom_kv.index[c].offset = EEPROM_KV_INDEX_EMPTY;
+	}
+
+	/* Replay the log up to its end, or up to the first record that was not
+	 * completely written */
+	offset = _eeprom_kv.region_offset +
+			(_eeprom_kv.area * _eeprom_kv.area_size) +
+			EEPROM_KV_AREA_HEADER_SIZE;
+
+	while (_eeprom_kv_check_record(offset, &header)) {
+		uint8_t key[EEPROM_KV_MAX_KEY_SIZE];
+		uint16_t size = _eeprom_kv_record_size(&header);
+		uint16_t slot;
+
+		_eeprom_kv_read_key(offset, key);
+
+		if (_eeprom_kv_find(key, header.key_length, &slot)) {
+			struct _eeprom_kv_record_header previous;
+
+			eeprom_emulator_read_buffer(_eeprom_kv.index[slot].offset,
+					(uint8_t *)&previous, EEPROM_KV_RECORD_HEADER_SIZE);
+			_eeprom_kv.used_bytes -= _eeprom_kv_record_size(&previous);
+
+			if (header.value_length == EEPROM_KV_TOMBSTONE) {
+				_eeprom_kv_index_remove(slot);
+				_eeprom_kv.records--;
+			} else {
+				_eeprom_kv.index[slot].offset = offset;
+				_eeprom_kv.used_bytes += size;
+			}
+		} else if (header.value_length != EEPROM_KV_TOMBSTONE) {
+			if (_eeprom_kv.records >= EEPROM_KV_MAX_RECORDS) {
+				return STATUS_ERR_NO_MEMORY;
+			}
+
+			_eeprom_kv.index[slot].offset = offset;
+			_eeprom_kv.index[slot].tag    =
+					(uint8_t)(_eeprom_kv_hash(key, header.key_length) >> 24);
+			_eeprom_kv.records++;
+			_eeprom_kv.used_bytes += size;
+		}
+
+		offset += size;
+	}
+
+	_eeprom_kv.end = offset;
+
+	/* Erase whatever an interrupted append left after the log, as it could
+	 * otherwise be replayed after the next record */
+	error_code = _eeprom_kv_erase(offset, _eeprom_kv.area);
+
+	if (error_code == STATUS_OK) {
+		error_code = eeprom_emulator_commit_page_buffer();
+	}
+
+	_eeprom_kv.initialized = (error_code == STATUS_OK);
+
+	return error_code;
+}
+
+/**
+ * \brief Creates an empty key-value store.
+ *
+ * Discards all records of the store, by erasing the region and writing the
+ * header of an empty log in its first area. The EEPROM emulator must be
+ * initialized first.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the store was created and
+ *                                      initialized
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not
+ *                                      initialized
+ * \retval STATUS_ERR_NO_MEMORY         If the configured region does not fit
+ *                                      the emulated EEPROM
+ */
+enum status_code eeprom_kv_format(void)
+{
+	enum status_code error_code;
+
+	error_code = _eeprom_kv_locate();
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	/* Erase the second area with its header, and the log of the first area
+	 * before its header becomes valid, so that none of the previous contents
+	 * of the region are replayed */
+	error_code = _eeprom_kv_erase(
+			_eeprom_kv.region_offset + _eeprom_kv.area_size, 1);
+
+	if (error_code == STATUS_OK) {
+		error_code = _eeprom_kv_erase(
+				_eeprom_kv.region_offset + EEPROM_KV_AREA_HEADER_SIZE, 0);
+	}
+
+	if (error_code == STATUS_OK) {
+		error_code = eeprom_emulator_commit_page_buffer();
+	}
+
+	if (error_code == STATUS_OK) {
+		error_code = _eeprom_kv_write_area_header(0, 0);
+	}
+
+	if (error_code == STATUS_OK) {
+		error_code = eeprom_emulator_commit_page_buffer();
+	}
+
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	return eeprom_kv_init();
+}
+
+/**
+ * \brief Retrieves the usage of the key-value store.
+ *
+ * \param[out] parameters  Key-value store parameter struct to fill
+ *
+ * \return Status of the operation.
+ *
+ * \retval STATUS_OK                    If the parameters were retrieved
+ *                                      successfully
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the store is not initialized
+ */
+enum status_code eeprom_kv_get_parameters(
+		struct eeprom_kv_parameters *const parameters)
+{
+	if (_eeprom_kv.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	parameters->records     = _eeprom_kv.records;
+	parameters->max_records = EEPROM_KV_MAX_RECORDS;
+	parameters->used_bytes  = _eeprom_kv.used_bytes;
+	parameters->area_size   = _eeprom_kv.area_size - EEPROM_KV_AREA_HEADER_SIZE;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Writes the value of a key.
+ *
+ * Appends a record holding the new value to the log, unless it is unchanged.
+ * When the active area is full, the live records are first copied to the
+ * other area, which takes a number of page writes proportional to their size.
+ *
+ * \param[in] key           Key to write
+ * \param[in] key_length    Length of the key, from 1 to
+ *                          \ref EEPROM_KV_MAX_KEY_SIZE bytes
+ * \param[in] value         New value of the key
+ * \param[in] value_length  Length of the value, up to
+ *                          \ref EEPROM_KV_MAX_VALUE_SIZE bytes
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the value was written
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the store is not initialized
+ * \retval STATUS_ERR_INVALID_ARG       If the key or value length is out of
+ *                                      range
+ * \retval STATUS_ERR_NO_MEMORY         If the index or the area is full
+ */
+enum status_code eeprom_kv_write(
+		const uint8_t *const key,
+		const uint8_t key_length,
+		const uint8_t *const value,
+		const uint8_t value_length)
+{
+	enum status_code error_code;
+	struct _eeprom_kv_record_header header;
+	uint16_t size = EEPROM_KV_RECORD_HEADER_SIZE + key_length + value_length;
+	uint16_t live_size = _eeprom_kv.used_bytes + size;
+	uint16_t slot;
+	bool found;
+
+	if (_eeprom_kv.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if ((key_length == 0) || (key_length > EEPROM_KV_MAX_KEY_SIZE) ||
+			(value_length > EEPROM_KV_MAX_VALUE_SIZE)) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	found = _eeprom_kv_find(key, key_length, &slot);
+
+	if (found) {
+		uint16_t offset = _eeprom_kv.index[slot].offset;
+
+		eeprom_emulator_read_buffer(offset, (uint8_t *)&header,
+				EEPROM_KV_RECORD_HEADER_SIZE);
+
+		/* Skip the write if the stored value is unchanged */
+		if (header.value_length == value_length) {
+			uint8_t buffer[EEPROM_KV_CHUNK_SIZE];
+			uint16_t c;
+
+			offset += EEPROM_KV_RECORD_HEADER_SIZE + key_length;
+
+			for (c = 0; c < value_length; c += EEPROM_KV_CHUNK_SIZE) {
+				uint16_t length = value_length - c;
+
+				if (length > EEPROM_KV_CHUNK_SIZE) {
+					length = EEPROM_KV_CHUNK_SIZE;
+				}
+
+				if ((eeprom_emulator_read_buffer(offset + c, buffer, length) !=
+						STATUS_OK) || memcmp(buffer, &value[c], length)) {
+					break;
+				}
+			}
+
+			if (c >= value_length) {
+				return STATUS_OK;
+			}
+		}
+
+		live_size -= _eeprom_kv_record_size(&header);
+	} else if (_eeprom_kv.records >= EEPROM_KV_MAX_RECORDS) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	error_code = _eeprom_kv_reserve(size);
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	uint16_t offset = _eeprom_kv.end;
+
+	error_code = _eeprom_kv_append(key, key_length, value, value_length);
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	if (found == false) {
+		_eeprom_kv.index[slot].tag =
+				(uint8_t)(_eeprom_kv_hash(key, key_length) >> 24);
+		_eeprom_kv.records++;
+	}
+
+	_eeprom_kv.index[slot].offset = offset;
+	_eeprom_kv.used_bytes = live_size;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Reads the value of a key.
+ *
+ * \param[in]     key           Key to read
+ * \param[in]     key_length    Length of the key, in bytes
+ * \param[out]    value         Buffer to store the value into
+ * \param[in,out] value_length  Size of the buffer on entry, length of the
+ *                              value on return
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the value was read
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the store is not initialized
+ * \retval STATUS_ERR_INVALID_ARG       If the key length is out of range
+ * \retval STATUS_ERR_NOT_FOUND         If the key is not stored
+ * \retval STATUS_ERR_OVERFLOW          If the value does not fit the buffer;
+ *                                      its length is still returned
+ */
+enum status_code eeprom_kv_read(
+		const uint8_t *const key,
+		const uint8_t key_length,
+		uint8_t *const value,
+		uint8_t *const value_length)
+{
+	enum status_code error_code;
+	struct _eeprom_kv_record_header header;
+	uint16_t slot;
+
+	if (_eeprom_kv.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if ((key_length == 0) || (key_length > EEPROM_KV_MAX_KEY_SIZE)) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	if (_eeprom_kv_find(key, key_length, &slot) == false) {
+		return STATUS_ERR_NOT_FOUND;
+	}
+
+	error_code = eeprom_emulator_read_buffer(_eeprom_kv.index[slot].offset,
+			(uint8_t *)&header, EEPROM_KV_RECORD_HEADER_SIZE);
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	if (header.value_length > *value_length) {
+		*value_length = header.value_length;
+		return STATUS_ERR_OVERFLOW;
+	}
+
+	*value_length = header.value_length;
+
+	if (header.value_length == 0) {
+		return STATUS_OK;
+	}
+
+	return eeprom_emulator_read_buffer(_eeprom_kv.index[slot].offset +
+			EEPROM_KV_RECORD_HEADER_SIZE + key_length, value,
+			header.value_length);
+}
+
+/**
+ * \brief Deletes a key.
+ *
+ * Appends a tombstone record for the key to the log; if the active area is
+ * full, the live records are copied to the other area without the key
+ * instead.
+ *
+ * \param[in] key         Key to delete
+ * \param[in] key_length  Length of the key, in bytes
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the key was deleted
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the store is not initialized
+ * \retval STATUS_ERR_INVALID_ARG       If the key length is out of range
+ * \retval STATUS_ERR_NOT_FOUND         If the key is not stored
+ */
+enum status_code eeprom_kv_delete(
+		const uint8_t *const key,
+		const uint8_t key_length)
+{
+	enum status_code error_code;
+	struct _eeprom_kv_record_header header;
+	uint16_t size = EEPROM_KV_RECORD_HEADER_SIZE + key_length;
+	uint16_t slot;
+
+	if (_eeprom_kv.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if ((key_length == 0) || (key_length > EEPROM_KV_MAX_KEY_SIZE)) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	if (_eeprom_kv_find(key, key_length, &slot) == false) {
+		return STATUS_ERR_NOT_FOUND;
+	}
+
+	eeprom_emulator_read_buffer(_eeprom_kv.index[slot].offset,
+			(uint8_t *)&header, EEPROM_KV_RECORD_HEADER_SIZE);
+
+	_eeprom_kv.used_bytes -= _eeprom_kv_record_size(&header);
+	_eeprom_kv.records--;
+
+	/* Without room for a tombstone, leave the key out of a compacted copy of
+	 * the log instead */
+	if (_eeprom_kv.end + size > _eeprom_kv_area_end(_eeprom_kv.area)) {
+		_eeprom_kv_index_remove(slot);
+		return _eeprom_kv_compact();
+	}
+
+	error_code = _eeprom_kv_append(key, key_length, NULL,
+			EEPROM_KV_TOMBSTONE);
+
+	_eeprom_kv_index_remove(slot);
+
+	return error_code;
+}
@@ -0,0 +1,170 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator key-value record store
+ *
+ * Store of variable length records, each identified by a short key such as a
+ * Bluetooth device address or an application tag, kept in a region of the
+ * emulated EEPROM memory space (eeprom.c). Records are accessed through the
+ * buffer functions of the emulator, so the store runs unchanged on the host
+ * NVM backend (eeprom_host_nvm.c):
+ *
+ * \code
+	gcc -DEEPROM_EMULATOR_HOST_NVM -I. eeprom.c eeprom_host_nvm.c eeprom_kv.c my_app.c
+ * \endcode
+ *
+ * \section eeprom_kv_layout Layout
+ * The region is split into two equal areas, only one of which is active at a
+ * time. Each area begins with a four byte header holding a generation number,
+ * followed by a log of records:
+ *
+ * <table>
+ *	<tr>
+ *		<th>Field</th>
+ *		<th>Size</th>
+ *		<th>Description</th>
+ *	</tr>
+ *	<tr>
+ *		<td>Key length</td>
+ *		<td>1</td>
+ *		<td>1 to \ref EEPROM_KV_MAX_KEY_SIZE, or 0xFF after the log</td>
+ *	</tr>
+ *	<tr>
+ *		<td>Value length</td>
+ *		<td>1</td>
+ *		<td>0 to \ref EEPROM_KV_MAX_VALUE_SIZE, or 0xFF for a deleted key</td>
+ *	</tr>
+ *	<tr>
+ *		<td>CRC</td>
+ *		<td>2</td>
+ *		<td>CRC-16 of the lengths, key and value</td>
+ *	</tr>
+ *	<tr>
+ *		<td>Key, value</td>
+ *		<td>Key length + value length</td>
+ *		<td>Record contents</td>
+ *	</tr>
+ * </table>
+ *
+ * Writing a key appends a new record to the log, and deleting a key appends a
+ * tombstone record holding only the key; the newest record of a key wins. When
+ * the active area is full, the live records are copied to the other area,
+ * which is then made active by writing its header with the next generation
+ * number. Until then, an interrupted copy leaves the previous area in use.
+ *
+ * At initialization the active log is replayed into an SRAM hash index of
+ * \ref EEPROM_KV_INDEX_ENTRIES entries, which holds the location of the newest
+ * record of each key; lookups then read a single record on average. The
+ * bytes following the log are kept erased to 0xFF, and the replay stops at
+ * the first record whose CRC does not match; a record whose append was
+ * interrupted is thus discarded, and erased along with anything after it.
+ *
+ * As for the rest of the emulated EEPROM, written records are only preserved
+ * once \ref eeprom_emulator_commit_page_buffer() has been called.
+ */
+#ifndef EEPROM_KV_H_INCLUDED
+#define EEPROM_KV_H_INCLUDED
+
+#include "eeprom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \name Key-Value Store Configuration
+ * @{
+ */
+
+#if defined(__DOXYGEN__)
+/** First logical EEPROM page of the region used by the store. It has no
+ *  default, as the region must be left free by the application and by the
+ *  other modules built on the emulator, such as the circular log. */
+#  define EEPROM_KV_FIRST_PAGE
+#endif
+
+#if defined(__DOXYGEN__)
+/** Number of logical EEPROM pages used by the store, or zero to use all pages
+ *  from \ref EEPROM_KV_FIRST_PAGE on. Half of them hold live records. */
+#  define EEPROM_KV_PAGES
+#endif
+
+#if !defined(EEPROM_KV_FIRST_PAGE) || !defined(EEPROM_KV_PAGES)
+#  error EEPROM_KV_FIRST_PAGE and EEPROM_KV_PAGES must be defined to a region not used by the application.
+#endif
+
+#if !defined(EEPROM_KV_INDEX_ENTRIES) || defined(__DOXYGEN__)
+/** Number of entries of the SRAM index, as a power of two. Up to three
+ *  quarters of them can be used, which limits the number of keys stored. */
+#  define EEPROM_KV_INDEX_ENTRIES     32
+#endif
+
+#if (EEPROM_KV_INDEX_ENTRIES < 4) || (EEPROM_KV_INDEX_ENTRIES > 1024) || \
+		(EEPROM_KV_INDEX_ENTRIES & (EEPROM_KV_INDEX_ENTRIES - 1))
+#  error EEPROM_KV_INDEX_ENTRIES must be a power of two from 4 to 1024.
+#endif
+
+/** Maximum length of a key, in bytes; a Bluetooth device address takes six. */
+#define EEPROM_KV_MAX_KEY_SIZE        8
+
+/** Maximum length of a value, in bytes. */
+#define EEPROM_KV_MAX_VALUE_SIZE      254
+
+/** @} */
+
+/**
+ * \brief Key-value store parameter structure.
+ *
+ * Structure containing the usage of the key-value store.
+ */
+struct eeprom_kv_parameters {
+	/** Number of keys stored. */
+	uint16_t records;
+	/** Maximum number of keys that can be stored. */
+	uint16_t max_records;
+	/** Size of the newest records of the stored keys, including their
+	 *  headers, in bytes. */
+	uint16_t used_bytes;
+	/** Number of bytes of an area available to records. */
+	uint16_t area_size;
+};
+
+/** \name Configuration and Initialization
+ * @{
+ */
+
+enum status_code eeprom_kv_init(void);
+
+enum status_code eeprom_kv_format(void);
+
+enum status_code eeprom_kv_get_parameters(
+		struct eeprom_kv_parameters *const parameters);
+
+/** @} */
+
+/** \name Record Reading/Writing
+ * @{
+ */
+
+enum status_code eeprom_kv_write(
+		const uint8_t *const key,
+		const uint8_t key_length,
+		const uint8_t *const value,
+		const uint8_t value_length);
+
+enum status_code eeprom_kv_read(
+		const uint8_t *const key,
+		const uint8_t key_length,
+		uint8_t *const value,
+		uint8_t *const value_length);
+
+enum status_code eeprom_kv_delete(
+		const uint8_t *const key,
+		const uint8_t key_length);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_KV_H_INCLUDED */
@@ -0,0 +1,431 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator circular record log
+ *
+ * Page-based circular log on the emulated EEPROM; see eeprom_log.h.
+ */
+#include "eeprom_log.h"
+#include <string.h>
+
+/**
+ * \internal
+ * \name Internal Circular Log Format
+ * @{
+ */
+
+/** Marker byte of a valid log page header. */
+#define EEPROM_LOG_PAGE_MARKER       'L'
+
+/** Record length ending the records of a page. */
+#define EEPROM_LOG_END_OF_PAGE       0xFF
+
+/** @} */
+
+/**
+ * \internal
+ * \brief Internal circular log instance struct.
+ */
+struct _eeprom_log_module {
+	/** Initialization state of the log. */
+	bool initialized;
+	/** First logical EEPROM page of the log range. */
+	uint16_t first_page;
+	/** Number of pages in the log range. */
+	uint16_t pages;
+	/** Index of the page being filled, within the log range. */
+	uint16_t head;
+	/** Offset of the next record in the page being filled. */
+	uint8_t fill;
+	/** Copy of the page being filled. */
+	uint8_t data[EEPROM_PAGE_SIZE];
+};
+
+/**
+ * \internal
+ * \brief Internal circular log instance.
+ */
+static struct _eeprom_log_module _eeprom_log;
+
+/** \internal
+ *  \brief Gives the sequence number held in a log page header.
+ *
+ *  \param[in] data  Contents of the log page
+ */
+static inline uint32_t _eeprom_log_sequence(
+		const uint8_t *const data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+			((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/** \internal
+ *  \brief Reads a page of the log range.
+ *
+ *  \param[in]  page      Index of the page, within the log range
+ *  \param[out] data      Contents of the page
+ *  \param[out] sequence  Sequence number of the page
+ *
+ *  \return Whether the page holds a valid log page header.
+ */
+static bool _eeprom_log_read_page(
+		const uint16_t page,
+		uint8_t *const data,
+		uint32_t *const sequence)
+{
+	if (eeprom_emulator_read_page(_eeprom_log.first_page + page, data) !=
+			STATUS_OK) {
+		return false;
+	}
+
+	*sequence = _eeprom_log_sequence(data);
+
+	return (data[4] == EEPROM_LOG_PAGE_MARKER) && (*sequence != 0xFFFFFFFFUL);
+}
+
+/** \internal
+ *  \brief Finds the end of the records of a log page.
+ *
+ *  \param[in] data  Contents of the log page
+ *
+ *  \return Offset of the first free byte of the page.
+ */
+static uint8_t _eeprom_log_page_fill(
+		const uint8_t *const data)
+{
+	uint8_t offset = EEPROM_LOG_PAGE_HEADER_SIZE;
+
+	while ((offset < EEPROM_PAGE_SIZE) &&
+			(data[offset] != EEPROM_LOG_END_OF_PAGE) &&
+			(offset + 1 + data[offset] <= EEPROM_PAGE_SIZE)) {
+		offset += 1 + data[offset];
+	}
+
+	return offset;
+}
+
+/** \internal
+ *  \brief Starts a new, empty log page in SRAM.
+ *
+ *  \param[in] page      Index of the page, within the log range
+ *  \param[in] sequence  Sequence number of the page
+ */
+static void _eeprom_log_new_page(
+		const uint16_t page,
+		const uint32_t sequence)
+{
+	memset(_eeprom_log.data, EEPROM_LOG_END_OF_PAGE, EEPROM_PAGE_SIZE);
+
+	_eeprom_log.data[0] = (uint8_t)sequence;
+	_eeprom_log.data[1] = (uint8_t)(sequence >> 8);
+	_eeprom_log.data[2] = (uint8_t)(sequence >> 16);
+	_eeprom_log.data[3] = (uint8_t)(sequence >> 24);
+	_eeprom_log.data[4] = EEPROM_LOG_PAGE_MARKER;
+
+	_eeprom_log.head = page;
+	_eeprom_log.fill = EEPROM_LOG_PAGE_HEADER_SIZE;
+}
+
+/** \internal
+ *  \brief Locates the log range in the emulated EEPROM.
+ *
+ *  \return Status code indicating the status of the operation.
+ *
+ *  \retval STATUS_OK                    If the range was located
+ *  \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not
+ *                                       initialized
+ *  \retval STATUS_ERR_NO_MEMORY         If the configured range does not fit
+ *                                       the emulated EEPROM
+ */
+static enum status_code _eeprom_log_locate(void)
+{
+	enum status_code error_code;
+	struct eeprom_emulator_parameters parameters;
+	uint16_t pages = EEPROM_LOG_PAGES;
+
+	_eeprom_log.initialized = false;
+
+	error_code = eeprom_emulator_get_parameters(&parameters);
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	if (EEPROM_LOG_FIRST_PAGE >= parameters.eeprom_number_of_pages) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	if (pages == 0) {
+		pages = parameters.eeprom_number_of_pages - EEPROM_LOG_FIRST_PAGE;
+	}
+
+	if ((pages < 2) ||
+			(EEPROM_LOG_FIRST_PAGE + pages > parameters.eeprom_number_of_pages)) {
+		return STATUS_ERR_NO_MEMORY;
+	}
+
+	_eeprom_log.first_page = EEPROM_LOG_FIRST_PAGE;
+	_eeprom_log.pages      = pages;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Initializes the circular log.
+ *
+ * Finds the newest page of the log, and the end of its records. As pages are
+ * written in order, page \c i of the range holds the sequence number of the
+ * first page plus \c i up to the newest page only; the newest page is thus
+ * found by a binary search. The EEPROM emulator must be initialized first; if
+ * no log is found, \ref eeprom_log_format() should be called to create an
+ * empty one.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the log was initialized
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not
+ *                                      initialized
+ * \retval STATUS_ERR_NO_MEMORY         If the configured range does not fit
+ *                                      the emulated EEPROM
+ * \retval STATUS_ERR_BAD_FORMAT        If no log was found in the range
+ */
+enum status_code eeprom_log_init(void)
+{
+	enum status_code error_code;
+	uint8_t data[EEPROM_PAGE_SIZE];
+	uint32_t first_sequence;
+	uint32_t sequence;
+	uint16_t low;
+	uint16_t high;
+
+	error_code = _eeprom_log_locate();
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	/* The first page is always written first, and never erased */
+	if (_eeprom_log_read_page(0, data, &first_sequence) == false) {
+		return STATUS_ERR_BAD_FORMAT;
+	}
+
+	/* Find the last page that follows the first one in sequence */
+	low  = 0;
+	high = _eeprom_log.pages - 1;
+
+	while (low < high) {
+		uint16_t middle = low + ((high - low + 1) / 2);
+
+		if (_eeprom_log_read_page(middle, data, &sequence) &&
+				(sequence - first_sequence == middle)) {
+			low = middle;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	_eeprom_log_read_page(low, _eeprom_log.data, &sequence);
+
+	_eeprom_log.head        = low;
+	_eeprom_log.fill        = _eeprom_log_page_fill(_eeprom_log.data);
+	_eeprom_log.initialized = true;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Creates an empty circular log.
+ *
+ * Erases the log range, and writes an empty first page. The EEPROM emulator
+ * must be initialized first.
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the log was created and initialized
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the EEPROM emulator is not
+ *                                      initialized
+ * \retval STATUS_ERR_NO_MEMORY         If the configured range does not fit
+ *                                      the emulated EEPROM
+ */
+enum status_code eeprom_log_format(void)
+{
+	enum status_code error_code;
+	uint8_t data[EEPROM_PAGE_SIZE];
+
+	error_code = _eeprom_log_locate();
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	memset(data, 0xFF, EEPROM_PAGE_SIZE);
+
+	/* Erase the other pages before the first one becomes valid, so that none
+	 * of them is taken as following it */
+	for (uint16_t page = 1; page < _eeprom_log.pages; page++) {
+		error_code = eeprom_emulator_write_page(_eeprom_log.first_page + page,
+				data);
+		if (error_code != STATUS_OK) {
+			return error_code;
+		}
+	}
+
+	error_code = eeprom_emulator_commit_page_buffer();
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	_eeprom_log_new_page(0, 0);
+
+	error_code = eeprom_emulator_write_page(_eeprom_log.first_page,
+			_eeprom_log.data);
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	error_code = eeprom_emulator_commit_page_buffer();
+	if (error_code != STATUS_OK) {
+		return error_code;
+	}
+
+	_eeprom_log.initialized = true;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Appends a record to the circular log.
+ *
+ * Adds the record to the page being filled, and writes that page. If the
+ * record does not fit, the next page of the range is started instead,
+ * discarding the oldest records it held once the range is full.
+ *
+ * \param[in] data    Record to append
+ * \param[in] length  Length of the record, from 1 to
+ *                    \ref EEPROM_LOG_MAX_RECORD_SIZE bytes
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the record was appended
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the log is not initialized
+ * \retval STATUS_ERR_INVALID_ARG       If the record length is out of range
+ */
+enum status_code eeprom_log_append(
+		const uint8_t *const data,
+		const uint8_t length)
+{
+	if (_eeprom_log.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	if ((length == 0) || (length > EEPROM_LOG_MAX_RECORD_SIZE)) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	/* Start the next page if the record does not fit in the current one */
+	if (_eeprom_log.fill + 1 + length > EEPROM_PAGE_SIZE) {
+		uint32_t sequence = _eeprom_log_sequence(_eeprom_log.data) + 1;
+
+		_eeprom_log_new_page((_eeprom_log.head + 1) % _eeprom_log.pages,
+				sequence);
+	}
+
+	_eeprom_log.data[_eeprom_log.fill] = length;
+	memcpy(&_eeprom_log.data[_eeprom_log.fill + 1], data, length);
+	_eeprom_log.fill += 1 + length;
+
+	return eeprom_emulator_write_page(_eeprom_log.first_page + _eeprom_log.head,
+			_eeprom_log.data);
+}
+
+/**
+ * \brief Positions an iterator after the newest record of the log.
+ *
+ * \param[out] iterator  Iterator to initialize
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If the iterator was initialized
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the log is not initialized
+ */
+enum status_code eeprom_log_iterator_init(
+		struct eeprom_log_iterator *const iterator)
+{
+	if (_eeprom_log.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	memcpy(iterator->data, _eeprom_log.data, EEPROM_PAGE_SIZE);
+
+	iterator->page     = _eeprom_log.head;
+	iterator->sequence = _eeprom_log_sequence(_eeprom_log.data);
+	iterator->offset   = _eeprom_log.fill;
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Reads the record preceding an iterator position.
+ *
+ * Moves the iterator to the next older record of the log and reads it. Within
+ * a page, records are located by parsing the page copy held by the iterator;
+ * a new page is read only when moving past the oldest record of a page.
+ *
+ * \param[in,out] iterator  Iterator to move
+ * \param[out]    data      Buffer of \ref EEPROM_LOG_MAX_RECORD_SIZE bytes to
+ *                          store the record into
+ * \param[out]    length    Length of the record
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK                    If a record was read
+ * \retval STATUS_ERR_NOT_INITIALIZED   If the log is not initialized
+ * \retval STATUS_ERR_NOT_FOUND         If the oldest record was already read,
+ *                                      or the older pages were overwritten
+ */
+enum status_code eeprom_log_read_previous(
+		struct eeprom_log_iterator *const iterator,
+		uint8_t *const data,
+		uint8_t *const length)
+{
+	if (_eeprom_log.initialized == false) {
+		return STATUS_ERR_NOT_INITIALIZED;
+	}
+
+	for (;;) {
+		uint8_t offset   = EEPROM_LOG_PAGE_HEADER_SIZE;
+		uint8_t previous = 0;
+
+		/* Find the last record before the current position */
+		while ((offset < iterator->offset) &&
+				(iterator->data[offset] != EEPROM_LOG_END_OF_PAGE)) {
+			previous = offset;
+			offset  += 1 + iterator->data[offset];
+		}
+
+		if (previous != 0) {
+			*length = iterator->data[previous];
+			memcpy(data, &iterator->data[previous + 1], *length);
+
+			iterator->offset = previous;
+			return STATUS_OK;
+		}
+
+		/* Move to the previous page, which must directly precede this one in
+		 * sequence; otherwise the start of the log was reached */
+		uint16_t page = (iterator->page + _eeprom_log.pages - 1) %
+				_eeprom_log.pages;
+		uint8_t page_data[EEPROM_PAGE_SIZE];
+		uint32_t sequence;
+
+		if ((iterator->sequence == 0) ||
+				(_eeprom_log_read_page(page, page_data, &sequence) == false) ||
+				(sequence != iterator->sequence - 1)) {
+			iterator->offset = EEPROM_LOG_PAGE_HEADER_SIZE;
+			return STATUS_ERR_NOT_FOUND;
+		}
+
+		memcpy(iterator->data, page_data, EEPROM_PAGE_SIZE);
+
+		iterator->page     = page;
+		iterator->sequence = sequence;
+		iterator->offset   = _eeprom_log_page_fill(iterator->data);
+	}
+}
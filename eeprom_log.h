@@ -0,0 +1,119 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator circular record log
+ *
+ * Append-only log of short records, such as alerts or discovered devices, kept
+ * in a range of logical pages of the emulated EEPROM (eeprom.c). Once the
+ * range is full, each new page of records overwrites the page holding the
+ * oldest ones. Records are read back from the newest to the oldest.
+ *
+ * \section eeprom_log_layout Layout
+ * Each logical page of the range holds a five byte header, made of a 32-bit
+ * page sequence number and a marker byte, followed by records made of a
+ * length byte and the record data. A length of 0xFF ends the records of a
+ * page. Pages are filled in order and wrap around at the end of the range,
+ * each new page taking the next sequence number.
+ *
+ * The page being filled is kept in SRAM, so that appending a record costs a
+ * single emulated EEPROM page write. With \c EEPROM_DELTA_RECORDS enabled,
+ * only the appends that fit a delta record are stored as one, about a third
+ * of them for 16 byte records, which hardly changes the number of row erases
+ * per record. At initialization, the newest page is found by a binary search
+ * over the page sequence numbers, reading a logarithmic number of page
+ * headers, and only its own records are parsed.
+ *
+ * As for the rest of the emulated EEPROM, appended records are only preserved
+ * once \ref eeprom_emulator_commit_page_buffer() has been called.
+ */
+#ifndef EEPROM_LOG_H_INCLUDED
+#define EEPROM_LOG_H_INCLUDED
+
+#include "eeprom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \name Circular Log Configuration
+ * @{
+ */
+
+#if defined(__DOXYGEN__)
+/** First logical EEPROM page of the range used by the log. It has no default,
+ *  as the range must not overlap the pages used by the application or the
+ *  key-value store. */
+#  define EEPROM_LOG_FIRST_PAGE
+#endif
+
+#if defined(__DOXYGEN__)
+/** Number of logical EEPROM pages used by the log, at least two, or zero to
+ *  use all pages from \ref EEPROM_LOG_FIRST_PAGE on. */
+#  define EEPROM_LOG_PAGES
+#endif
+
+#if !defined(EEPROM_LOG_FIRST_PAGE) || !defined(EEPROM_LOG_PAGES)
+#  error EEPROM_LOG_FIRST_PAGE and EEPROM_LOG_PAGES must be defined to a range not used by the application.
+#endif
+
+/** Size of the header of each log page, in bytes. */
+#define EEPROM_LOG_PAGE_HEADER_SIZE   5
+
+/** Maximum length of a record, in bytes. */
+#define EEPROM_LOG_MAX_RECORD_SIZE    (EEPROM_PAGE_SIZE - EEPROM_LOG_PAGE_HEADER_SIZE - 1)
+
+/** @} */
+
+/**
+ * \brief Circular log iterator structure.
+ *
+ * Position of a reader in the log, set up by
+ * \ref eeprom_log_iterator_init() and moved towards older records by
+ * \ref eeprom_log_read_previous(). The page being read is copied, so that
+ * records may be appended while iterating; pages overwritten meanwhile end
+ * the iteration.
+ */
+struct eeprom_log_iterator {
+	/** Index of the page being read, within the log range. */
+	uint16_t page;
+	/** Sequence number of the page being read. */
+	uint32_t sequence;
+	/** Offset in the page of the last record returned. */
+	uint8_t offset;
+	/** Copy of the page being read. */
+	uint8_t data[EEPROM_PAGE_SIZE];
+};
+
+/** \name Configuration and Initialization
+ * @{
+ */
+
+enum status_code eeprom_log_init(void);
+
+enum status_code eeprom_log_format(void);
+
+/** @} */
+
+/** \name Record Appending/Reading
+ * @{
+ */
+
+enum status_code eeprom_log_append(
+		const uint8_t *const data,
+		const uint8_t length);
+
+enum status_code eeprom_log_iterator_init(
+		struct eeprom_log_iterator *const iterator);
+
+enum status_code eeprom_log_read_previous(
+		struct eeprom_log_iterator *const iterator,
+		uint8_t *const data,
+		uint8_t *const length);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_LOG_H_INCLUDED */
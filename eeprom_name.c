@@ -0,0 +1,349 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator compact device name encoding
+ *
+ * Prefix dictionary and six-bit packing of device names; see eeprom_name.h.
+ */
+#include "eeprom_name.h"
+#include <string.h>
+
+/** \name Encoded Name Header
+ * @{
+ */
+
+/** Mask of the prefix index in the header byte. */
+#define EEPROM_NAME_PREFIX_MASK      0x3F
+
+/** Position of the encoding in the header byte. */
+#define EEPROM_NAME_ENCODING_SHIFT   6
+
+/** Name bytes stored as is. */
+#define EEPROM_NAME_ENCODING_BYTES   0
+
+/** Name packed as six-bit codes. */
+#define EEPROM_NAME_ENCODING_PACKED  1
+
+/** Name packed as six-bit codes, the last code of the bytes being padding. */
+#define EEPROM_NAME_ENCODING_PADDED  2
+
+/** @} */
+
+/** Character code marking a character without six-bit code. */
+#define EEPROM_NAME_NO_CODE          0xFF
+
+/** Number of six-bit codes decoded ahead, whose bytes are overwritten before
+ *  they would be decoded in place. */
+#define EEPROM_NAME_HEAD_CODES       4
+
+/**
+ * \internal
+ * \brief Characters of the six-bit codes.
+ */
+static const char _eeprom_name_charset[64] =
+		"0123456789"
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+		"abcdefghijklmnopqrstuvwxyz"
+		" -";
+
+/**
+ * \internal
+ * \brief Dictionary of common device name prefixes.
+ *
+ * The index of an entry is stored in the encoded names; entries may only be
+ * appended, up to \ref EEPROM_NAME_PREFIX_MASK of them.
+ */
+static const char *const _eeprom_name_prefixes[] = {
+	"",
+	"ATMEL-",
+	"iPhone",
+	"iPad",
+	"Apple Watch",
+	"AirPods",
+	"MacBook",
+	"Galaxy ",
+	"Galaxy Buds",
+	"Galaxy Watch",
+	"[TV] Samsung ",
+	"Mi Band ",
+	"Mi Smart Band ",
+	"Redmi ",
+	"Xiaomi ",
+	"HUAWEI ",
+	"HONOR ",
+	"Pixel ",
+	"OnePlus ",
+	"moto ",
+	"Nokia ",
+	"JBL ",
+	"Bose ",
+	"LE-Bose ",
+	"WH-1000XM",
+	"WF-1000XM",
+	"Fitbit ",
+	"Amazfit ",
+	"Forerunner ",
+	"Tile",
+	"DESKTOP-",
+	"LAPTOP-",
+};
+
+/** Number of entries of the prefix dictionary. */
+#define EEPROM_NAME_PREFIXES \
+		(sizeof(_eeprom_name_prefixes) / sizeof(_eeprom_name_prefixes[0]))
+
+/** \internal
+ *  \brief Gives the six-bit code of a character.
+ *
+ *  \param[in] character  Character to encode
+ *
+ *  \return Code of the character, or \ref EEPROM_NAME_NO_CODE if it has none.
+ */
+static uint8_t _eeprom_name_code(
+		const char character)
+{
+	if ((character >= '0') && (character <= '9')) {
+		return character - '0';
+	} else if ((character >= 'A') && (character <= 'Z')) {
+		return character - 'A' + 10;
+	} else if ((character >= 'a') && (character <= 'z')) {
+		return character - 'a' + 36;
+	} else if (character == ' ') {
+		return 62;
+	} else if (character == '-') {
+		return 63;
+	}
+
+	return EEPROM_NAME_NO_CODE;
+}
+
+/** \internal
+ *  \brief Reads a six-bit code from packed bytes.
+ *
+ *  \param[in] packed  Packed bytes
+ *  \param[in] length  Number of packed bytes
+ *  \param[in] index   Index of the code to read
+ *
+ *  \return Code read.
+ */
+static uint8_t _eeprom_name_read_code(
+		const uint8_t *const packed,
+		const uint8_t length,
+		const uint16_t index)
+{
+	uint16_t bit  = index * 6;
+	uint8_t  byte = bit >> 3;
+	uint16_t bits = (uint16_t)packed[byte] << 8;
+
+	if ((byte + 1) < length) {
+		bits |= packed[byte + 1];
+	}
+
+	return (bits >> (10 - (bit & 7))) & 0x3F;
+}
+
+/** \internal
+ *  \brief Finds the longest dictionary prefix of a name.
+ *
+ *  \param[in]  name           Name to match
+ *  \param[in]  length         Length of the name, in bytes
+ *  \param[out] prefix_length  Length of the prefix found, in bytes
+ *
+ *  \return Index of the prefix found, zero if none matches.
+ */
+static uint8_t _eeprom_name_find_prefix(
+		const char *const name,
+		const uint8_t length,
+		uint8_t *const prefix_length)
+{
+	uint8_t prefix = 0;
+
+	*prefix_length = 0;
+
+	if (length == 0) {
+		return prefix;
+	}
+
+	for (uint8_t c = 1; c < EEPROM_NAME_PREFIXES; c++) {
+		size_t entry_length;
+
+		/* Most entries differ from the name in their first character */
+		if (_eeprom_name_prefixes[c][0] != name[0]) {
+			continue;
+		}
+
+		entry_length = strlen(_eeprom_name_prefixes[c]);
+
+		if ((entry_length > *prefix_length) && (entry_length <= length) &&
+				(memcmp(name, _eeprom_name_prefixes[c], entry_length) == 0)) {
+			prefix         = c;
+			*prefix_length = (uint8_t)entry_length;
+		}
+	}
+
+	return prefix;
+}
+
+/**
+ * \brief Encodes a device name.
+ *
+ * Encodes a name as its longest dictionary prefix followed by the rest of the
+ * name, packed as six-bit codes when all its characters have one, or stored
+ * as is otherwise.
+ *
+ * \param[in]  name            Name to encode, not null-terminated
+ * \param[in]  length          Length of the name, in bytes
+ * \param[out] encoded         Buffer to store the encoded name into, of
+ *                             \ref EEPROM_NAME_ENCODED_SIZE(length) bytes
+ * \param[out] encoded_length  Length of the encoded name, in bytes
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK               If the name was encoded
+ * \retval STATUS_ERR_INVALID_ARG  If the name is longer than
+ *                                 \ref EEPROM_NAME_MAX_LENGTH
+ */
+enum status_code eeprom_name_encode(
+		const char *const name,
+		const uint8_t length,
+		uint8_t *const encoded,
+		uint8_t *const encoded_length)
+{
+	uint8_t prefix;
+	uint8_t prefix_length;
+	uint16_t bits = 0;
+	uint8_t bit_count = 0;
+	uint8_t offset = 1;
+
+	if (length > EEPROM_NAME_MAX_LENGTH) {
+		return STATUS_ERR_INVALID_ARG;
+	}
+
+	prefix = _eeprom_name_find_prefix(name, length, &prefix_length);
+
+	/* Pack the rest of the name, four codes to three bytes */
+	for (uint8_t c = prefix_length; c < length; c++) {
+		uint8_t code = _eeprom_name_code(name[c]);
+
+		if (code == EEPROM_NAME_NO_CODE) {
+			/* Store the rest of the name as is */
+			encoded[0] = (EEPROM_NAME_ENCODING_BYTES <<
+					EEPROM_NAME_ENCODING_SHIFT) | prefix;
+			memcpy(&encoded[1], &name[prefix_length], length - prefix_length);
+
+			*encoded_length = 1 + (length - prefix_length);
+			return STATUS_OK;
+		}
+
+		bits       = (bits << 6) | code;
+		bit_count += 6;
+
+		if (bit_count >= 8) {
+			bit_count        -= 8;
+			encoded[offset++] = bits >> bit_count;
+		}
+	}
+
+	if (bit_count > 0) {
+		encoded[offset++] = bits << (8 - bit_count);
+	}
+
+	/* Three codes take as many bytes as four; the fourth is then padding */
+	encoded[0] = ((((length - prefix_length) & 3) == 3) ?
+			EEPROM_NAME_ENCODING_PADDED : EEPROM_NAME_ENCODING_PACKED) <<
+			EEPROM_NAME_ENCODING_SHIFT;
+	encoded[0] |= prefix;
+
+	*encoded_length = offset;
+	return STATUS_OK;
+}
+
+/**
+ * \brief Decodes a device name in place.
+ *
+ * Replaces an encoded name with the name it encodes, in the same buffer.
+ *
+ * \param[in,out] buffer          Buffer holding the encoded name, and then
+ *                                the name, not null-terminated
+ * \param[in]     encoded_length  Length of the encoded name, in bytes
+ * \param[in]     size            Size of the buffer, in bytes
+ * \param[out]    length          Length of the name, in bytes
+ *
+ * \return Status code indicating the status of the operation.
+ *
+ * \retval STATUS_OK            If the name was decoded
+ * \retval STATUS_ERR_BAD_DATA  If the encoded name is invalid
+ * \retval STATUS_ERR_OVERFLOW  If the name does not fit the buffer; the
+ *                              buffer is left unchanged
+ */
+enum status_code eeprom_name_decode(
+		uint8_t *const buffer,
+		const uint8_t encoded_length,
+		const uint8_t size,
+		uint8_t *const length)
+{
+	uint8_t head[EEPROM_NAME_HEAD_CODES];
+	uint8_t prefix;
+	uint8_t encoding;
+	uint8_t prefix_length;
+	uint8_t data_length;
+	uint16_t codes;
+
+	if (encoded_length == 0) {
+		return STATUS_ERR_BAD_DATA;
+	}
+
+	prefix      = buffer[0] & EEPROM_NAME_PREFIX_MASK;
+	encoding    = buffer[0] >> EEPROM_NAME_ENCODING_SHIFT;
+	data_length = encoded_length - 1;
+
+	if ((prefix >= EEPROM_NAME_PREFIXES) ||
+			(encoding > EEPROM_NAME_ENCODING_PADDED) ||
+			((encoding == EEPROM_NAME_ENCODING_PADDED) && (data_length == 0))) {
+		return STATUS_ERR_BAD_DATA;
+	}
+
+	prefix_length = (uint8_t)strlen(_eeprom_name_prefixes[prefix]);
+
+	if (encoding == EEPROM_NAME_ENCODING_BYTES) {
+		codes = data_length;
+	} else {
+		/* Four codes per three bytes; the division by three is done as a
+		 * multiplication, exact for any byte count */
+		codes = data_length + ((data_length * 171) >> 9) -
+				(encoding == EEPROM_NAME_ENCODING_PADDED);
+	}
+
+	if ((prefix_length + codes) > size) {
+		return STATUS_ERR_OVERFLOW;
+	}
+
+	if (encoding == EEPROM_NAME_ENCODING_BYTES) {
+		memmove(&buffer[prefix_length], &buffer[1], data_length);
+	} else {
+		const uint8_t *const packed = &buffer[1];
+		uint8_t head_codes = (codes < EEPROM_NAME_HEAD_CODES) ?
+				codes : EEPROM_NAME_HEAD_CODES;
+
+		/* The first codes would be overwritten by the characters before
+		 * them; the others are decoded backwards, each character landing
+		 * after the bytes of the codes still to decode */
+		for (uint8_t c = 0; c < head_codes; c++) {
+			head[c] = _eeprom_name_read_code(packed, data_length, c);
+		}
+
+		for (uint16_t c = codes; c-- > head_codes; ) {
+			buffer[prefix_length + c] = _eeprom_name_charset[
+					_eeprom_name_read_code(packed, data_length, c)];
+		}
+
+		for (uint8_t c = 0; c < head_codes; c++) {
+			buffer[prefix_length + c] = _eeprom_name_charset[head[c]];
+		}
+	}
+
+	memcpy(buffer, _eeprom_name_prefixes[prefix], prefix_length);
+
+	*length = prefix_length + codes;
+	return STATUS_OK;
+}
@@ -0,0 +1,95 @@
+/**
+ * \file
+ *
+ * \brief SAM EEPROM Emulator compact device name encoding
+ *
+ * Encoding of the Bluetooth device names stored in the emulated EEPROM
+ * (eeprom.c), such as the values of a key-value store (eeprom_kv.c) keyed by
+ * device address. Names are encoded before they are written, and decoded in
+ * place, in the buffer they were read into:
+ *
+ * \code
+	uint8_t value[EEPROM_NAME_ENCODED_SIZE(EEPROM_NAME_MAX_LENGTH)];
+	uint8_t length;
+
+	eeprom_name_encode(name, name_length, value, &length);
+	eeprom_kv_write(address, 6, value, length);
+
+	length = sizeof(value);
+	eeprom_kv_read(address, 6, value, &length);
+	eeprom_name_decode(value, length, sizeof(value), &name_length);
+ * \endcode
+ *
+ * \section eeprom_name_format Format
+ * An encoded name starts with a header byte, whose low six bits select a
+ * prefix from a static dictionary of common device name prefixes, zero
+ * standing for none, and whose high two bits give the encoding of the rest of
+ * the name:
+ *
+ * <table>
+ *	<tr>
+ *		<th>Encoding</th>
+ *		<th>Description</th>
+ *	</tr>
+ *	<tr>
+ *		<td>0</td>
+ *		<td>Bytes of the name, as is</td>
+ *	</tr>
+ *	<tr>
+ *		<td>1</td>
+ *		<td>Six-bit character codes, packed four to three bytes</td>
+ *	</tr>
+ *	<tr>
+ *		<td>2</td>
+ *		<td>As 1, where the last code of the bytes is padding</td>
+ *	</tr>
+ * </table>
+ *
+ * The six-bit codes cover the digits, letters, space and hyphen, which make up
+ * most device names; any other character falls back to the bytes of the name.
+ * The longest matching prefix of the dictionary is used. Dictionary entries
+ * are part of the stored format, so that new ones may only be appended.
+ *
+ * Neither function allocates memory, and both only use shifts, masks and
+ * table lookups per character.
+ */
+#ifndef EEPROM_NAME_H_INCLUDED
+#define EEPROM_NAME_H_INCLUDED
+
+#include "eeprom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum length of a device name, in bytes, as set by the Bluetooth
+ *  specification. */
+#define EEPROM_NAME_MAX_LENGTH            248
+
+/** Size of the buffer needed to encode a name of the given length, in the
+ *  worst case of a name stored as is. */
+#define EEPROM_NAME_ENCODED_SIZE(length)  ((length) + 1)
+
+/** \name Name Encoding/Decoding
+ * @{
+ */
+
+enum status_code eeprom_name_encode(
+		const char *const name,
+		const uint8_t length,
+		uint8_t *const encoded,
+		uint8_t *const encoded_length);
+
+enum status_code eeprom_name_decode(
+		uint8_t *const buffer,
+		const uint8_t encoded_length,
+		const uint8_t size,
+		uint8_t *const length);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_NAME_H_INCLUDED */